@@ -0,0 +1,19 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <cstdint>
+
+/**
+ * @brief 堆分配计数（只在基准程序中替换全局 operator new，主程序不受影响）
+ *
+ * 计数覆盖所有线程（含降采样线程池）中经 operator new 的分配，用于统计每次操作的平均分配次数。
+ * Qt 容器（QVector / QByteArray / QString 等）的数据块直接用 malloc 分配，不在计数之内。
+ */
+namespace AllocCounter {
+
+std::uint64_t allocations();    // 进程启动以来 operator new 的调用次数
+std::uint64_t bytes();          // 进程启动以来申请的字节数
+
+} // namespace AllocCounter
+
+#endif // ALLOCCOUNTER_H
@@ -0,0 +1,284 @@
+/**
+ * @brief PowerDAQ 性能基准
+ *
+ * 用例（N 个通道 × 每通道 M 个样点）：
+ * - ingest/addChannelData   逐点接口写入（每次操作写入 N 个通道各一个样点）
+ * - ingest/addChannelBlock  块接口写入（每次操作写入 N 个通道各 4096 个样点）
+ * - downsample/minmax       视口 Min-Max 降采样（每次操作 N 条曲线，随机视口）
+ * - stats/regionStats       框选区间统计（随机区间）
+ * - render/frame            平移视口 + 降采样 + QCustomPlot 离屏重绘 N 条曲线
+ *
+ * 无界面运行（默认设置 QT_QPA_PLATFORM=offscreen），结果输出为表格，并可保存为 JSON
+ * 或与保存的基线比较：
+ *   PowerDAQ_bench --json baseline.json
+ *   PowerDAQ_bench --baseline baseline.json --tolerance 10
+ */
+
+#include "benchrunner.h"
+#include "channelbuffer.h"
+#include "channelplottable.h"
+#include "viewportdownsampler.h"
+#include "waveformwidget.h"
+#include "qcustomplot.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kSampleRate = 100000.0;    // 每通道采样率（S/s）
+constexpr int kBlockSamples = 4096;         // 块接口每块样点数
+
+struct BenchConfig {
+    int channels = 16;
+    int points = 1000000;
+    int iterations = 200;
+};
+
+/**
+ * @brief 合成一段测试波形（正弦 + 噪声，每个通道频率不同）
+ */
+void synthesize(int channel, std::int64_t first, int count, std::mt19937 &rng,
+                std::vector<double> &voltage, std::vector<double> &current)
+{
+    std::normal_distribution<double> noise(0.0, 1.0);
+    voltage.resize(std::size_t(count));
+    current.resize(std::size_t(count));
+    const double f = 50.0 + 10.0 * channel;
+    for (int k = 0; k < count; ++k) {
+        const double t = double(first + k) / kSampleRate;
+        const double phase = 2.0 * kPi * f * t;
+        voltage[std::size_t(k)] = 3.3 + 0.05 * std::sin(phase) + 0.002 * noise(rng);
+        current[std::size_t(k)] = 0.2 + 0.1 * std::sin(phase * 0.5) + 0.001 * noise(rng);
+    }
+}
+
+/**
+ * @brief 每个通道一个数据槽，预先写入 M 个样点（保留全部数据）
+ */
+std::vector<ChannelSlotPtr> makeSlots(const BenchConfig &config)
+{
+    std::mt19937 rng(1);
+    std::vector<double> v;
+    std::vector<double> i;
+    std::vector<ChannelSlotPtr> slots;
+    for (int ch = 0; ch < config.channels; ++ch) {
+        auto slot = std::make_shared<ChannelSlot>();
+        slot->data.setRetention(RetentionPolicy::unlimited());
+        for (std::int64_t first = 0; first < config.points; first += 65536) {
+            const int n = int(std::min<std::int64_t>(65536, config.points - first));
+            synthesize(ch, first, n, rng, v, i);
+            slot->data.append(nullptr, double(first) / kSampleRate, 1.0 / kSampleRate,
+                              v.data(), i.data(), nullptr, std::size_t(n));
+        }
+        slots.push_back(slot);
+    }
+    return slots;
+}
+
+void benchIngest(BenchRunner &runner, const BenchConfig &config)
+{
+    // 逐点接口：与旧的 addChannelData 调用方式相同
+    {
+        WaveformWidget widget;
+        widget.resize(1600, 900);
+        WaveformWidget::MultiChannelData packet;
+        std::int64_t k = 0;
+        runner.run("ingest/addChannelData", "samples", config.channels, [&]() {
+            const double t = double(k) / kSampleRate;
+            for (int ch = 0; ch < config.channels; ++ch) {
+                WaveformWidget::ChannelDataPoint &p = packet.channelData[ch];
+                p.time = t;
+                p.voltage = 3.3 + 0.001 * double(k % 97);
+                p.current = 0.2 + 0.001 * double(k % 89);
+                p.power = std::nan("");
+            }
+            widget.addChannelData(packet);
+            ++k;
+        }, config.iterations * 50);
+    }
+
+    // 块接口：采集卡的典型写入方式
+    {
+        WaveformWidget widget;
+        widget.resize(1600, 900);
+        std::mt19937 rng(2);
+        std::vector<double> v;
+        std::vector<double> i;
+        synthesize(0, 0, kBlockSamples, rng, v, i);
+        std::int64_t first = 0;
+        runner.run("ingest/addChannelBlock", "samples", double(config.channels) * kBlockSamples, [&]() {
+            for (int ch = 0; ch < config.channels; ++ch) {
+                widget.addChannelBlock(ch, double(first) / kSampleRate, 1.0 / kSampleRate,
+                                       v.data(), i.data(), nullptr, kBlockSamples);
+            }
+            first += kBlockSamples;
+        });
+    }
+}
+
+void benchQueries(BenchRunner &runner, const BenchConfig &config,
+                  const std::vector<ChannelSlotPtr> &slots)
+{
+    const double span = double(config.points) / kSampleRate;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    // 随机视口：覆盖全程的 10% ~ 100%
+    MinMaxColumns columns;
+    runner.run("downsample/minmax", "curves", config.channels, [&]() {
+        for (const ChannelSlotPtr &slot : slots) {
+            const double width = span * (0.1 + 0.9 * unit(rng));
+            const double lower = (span - width) * unit(rng);
+            ViewportDownsampler::downsample(slot->data, ViewportDownsampler::Column::Voltage,
+                                            TimeRange(lower, lower + width), 1600, columns);
+        }
+    });
+
+    // 随机区间：覆盖全程的 1% ~ 50%
+    std::size_t next = 0;
+    runner.run("stats/regionStats", "queries", 1.0, [&]() {
+        const double width = span * (0.01 + 0.49 * unit(rng));
+        const double lower = (span - width) * unit(rng);
+        const RegionStats stats = slots[next++ % slots.size()]->data.regionStats(lower, lower + width);
+        doNotOptimize(stats);
+    }, config.iterations * 20);
+}
+
+void benchRender(BenchRunner &runner, const BenchConfig &config,
+                 const std::vector<ChannelSlotPtr> &slots)
+{
+    // offscreen 平台下显示窗口只为完成尺寸调整（绘制缓冲按窗口大小建立），不会出现在屏幕上
+    QCustomPlot plot;
+    plot.resize(1600, 600);
+    plot.show();
+    QApplication::processEvents();
+    plot.yAxis->setRange(3.2, 3.4);
+
+    std::vector<ChannelPlottable *> curves;
+    for (int ch = 0; ch < config.channels; ++ch) {
+        auto *curve = new ChannelPlottable(plot.xAxis, plot.yAxis);
+        curve->setSource(slots[std::size_t(ch)], ViewportDownsampler::Column::Voltage);
+        curves.push_back(curve);
+    }
+
+    // 首次重绘完成布局，之后按绘图区宽度分列
+    const double span = double(config.points) / kSampleRate;
+    const double viewWidth = span * 0.5;
+    plot.xAxis->setRange(0.0, viewWidth);
+    plot.replot(QCustomPlot::rpImmediateRefresh);
+
+    double lower = 0.0;
+    runner.run("render/frame", "frames", 1.0, [&]() {
+        // 每帧平移视口 1%，重新降采样并重绘
+        lower += viewWidth * 0.01;
+        if (lower + viewWidth > span) {
+            lower = 0.0;
+        }
+        const QCPRange range(lower, lower + viewWidth);
+        plot.xAxis->setRange(range);
+        const int width = plot.axisRect()->width();
+        for (ChannelPlottable *curve : curves) {
+            auto columns = std::make_shared<MinMaxColumns>();
+            ViewportDownsampler::downsample(curve->source()->data, curve->column(),
+                                            TimeRange(range.lower, range.upper), width, *columns);
+            curve->setColumns(columns);
+        }
+        plot.replot(QCustomPlot::rpImmediateRefresh);
+    });
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 无界面运行：未指定平台插件时使用 offscreen
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("PowerDAQ_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("PowerDAQ benchmark suite");
+    parser.addHelpOption();
+    QCommandLineOption channelsOpt("channels", "Number of channels (N).", "n", "16");
+    QCommandLineOption pointsOpt("points", "Samples per channel (M).", "m", "1000000");
+    QCommandLineOption iterationsOpt("iterations", "Timed iterations per case.", "k", "200");
+    QCommandLineOption jsonOpt("json", "Write results as JSON to <file> (\"-\" for stdout).", "file");
+    QCommandLineOption baselineOpt("baseline", "Compare p50 latency with a stored JSON baseline.", "file");
+    QCommandLineOption toleranceOpt("tolerance", "Allowed p50 slowdown against the baseline (percent).",
+                                    "percent", "10");
+    parser.addOptions({channelsOpt, pointsOpt, iterationsOpt, jsonOpt, baselineOpt, toleranceOpt});
+    parser.process(app);
+
+    BenchConfig config;
+    config.channels = std::max(1, parser.value(channelsOpt).toInt());
+    config.points = std::max(kBlockSamples, parser.value(pointsOpt).toInt());
+    config.iterations = std::max(1, parser.value(iterationsOpt).toInt());
+
+    // JSON 写到 stdout 时，表格和比较结果改写到 stderr，保证 stdout 可直接按 JSON 解析
+    const bool jsonToStdout = parser.isSet(jsonOpt) && parser.value(jsonOpt) == "-";
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QTextStream &report = jsonToStdout ? err : out;
+    report << QString("PowerDAQ_bench: %1 channels x %2 samples, %3 iterations\n\n")
+               .arg(config.channels).arg(config.points).arg(config.iterations);
+    report.flush();
+
+    BenchRunner runner;
+    runner.setIterations(config.iterations);
+
+    benchIngest(runner, config);
+    const std::vector<ChannelSlotPtr> slots = makeSlots(config);
+    benchQueries(runner, config, slots);
+    benchRender(runner, config, slots);
+
+    runner.printTable(report);
+    report.flush();
+
+    QJsonObject configJson;
+    configJson["channels"] = config.channels;
+    configJson["points"] = config.points;
+    configJson["iterations"] = config.iterations;
+    configJson["sampleRate"] = kSampleRate;
+    const QJsonDocument doc(runner.toJson(configJson));
+
+    if (parser.isSet(jsonOpt)) {
+        const QString path = parser.value(jsonOpt);
+        if (path == "-") {
+            out << doc.toJson(QJsonDocument::Indented);
+            out.flush();
+        } else {
+            QFile file(path);
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                qWarning("Cannot write %s: %s", qPrintable(path), qPrintable(file.errorString()));
+                return 2;
+            }
+            file.write(doc.toJson(QJsonDocument::Indented));
+        }
+    }
+
+    if (parser.isSet(baselineOpt)) {
+        QFile file(parser.value(baselineOpt));
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning("Cannot read baseline %s: %s", qPrintable(file.fileName()),
+                     qPrintable(file.errorString()));
+            return 2;
+        }
+        const QJsonDocument baseline = QJsonDocument::fromJson(file.readAll());
+        report << "\nCompared with " << file.fileName() << ":\n";
+        const int regressions = runner.compareWithBaseline(
+            baseline.object(), parser.value(toleranceOpt).toDouble(), report);
+        return regressions > 0 ? 1 : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "benchrunner.h"
+#include "alloccounter.h"
+
+#include <QJsonArray>
+#include <QMap>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+// 有序样本的分位数（最近秩）
+double percentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const std::size_t rank = std::size_t(std::ceil(p * double(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+}
+
+const BenchResult &BenchRunner::run(const QString &name, const QString &unit, double itemsPerOp,
+                                    const std::function<void()> &op, int iterations)
+{
+    using Clock = std::chrono::steady_clock;
+    const int n = std::max(1, iterations > 0 ? iterations : m_iterations);
+
+    for (int i = 0; i < m_warmup; ++i) {
+        op();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(std::size_t(n));
+    const std::uint64_t allocs0 = AllocCounter::allocations();
+    const std::uint64_t bytes0 = AllocCounter::bytes();
+    double totalNs = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const Clock::time_point t0 = Clock::now();
+        op();
+        const double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     Clock::now() - t0).count());
+        samples.push_back(ns);
+        totalNs += ns;
+    }
+    // samples 已预留，计时循环内 push_back 不分配
+    const std::uint64_t allocs = AllocCounter::allocations() - allocs0;
+    const std::uint64_t bytes = AllocCounter::bytes() - bytes0;
+
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult r;
+    r.name = name;
+    r.unit = unit;
+    r.iterations = n;
+    r.itemsPerOp = itemsPerOp;
+    r.meanNs = totalNs / n;
+    r.p50Ns = percentile(samples, 0.50);
+    r.p90Ns = percentile(samples, 0.90);
+    r.p99Ns = percentile(samples, 0.99);
+    r.maxNs = samples.back();
+    r.throughput = totalNs > 0.0 ? itemsPerOp * n / (totalNs * 1e-9) : 0.0;
+    r.allocsPerOp = double(allocs) / n;
+    r.bytesPerOp = double(bytes) / n;
+    m_results.push_back(r);
+    return m_results.back();
+}
+
+void BenchRunner::printTable(QTextStream &out) const
+{
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+               .arg("case", -28)
+               .arg("throughput", 22)
+               .arg("p50 (us)", 11)
+               .arg("p90 (us)", 11)
+               .arg("p99 (us)", 11)
+               .arg("max (us)", 11)
+               .arg("allocs/op", 11);
+    for (const BenchResult &r : m_results) {
+        out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+                   .arg(r.name, -28)
+                   .arg(QString("%1 %2/s").arg(r.throughput, 0, 'g', 4).arg(r.unit), 22)
+                   .arg(r.p50Ns * 1e-3, 11, 'f', 1)
+                   .arg(r.p90Ns * 1e-3, 11, 'f', 1)
+                   .arg(r.p99Ns * 1e-3, 11, 'f', 1)
+                   .arg(r.maxNs * 1e-3, 11, 'f', 1)
+                   .arg(r.allocsPerOp, 11, 'f', 1);
+    }
+    out.flush();
+}
+
+QJsonObject BenchRunner::toJson(const QJsonObject &config) const
+{
+    QJsonArray cases;
+    for (const BenchResult &r : m_results) {
+        QJsonObject latency;
+        latency["mean"] = r.meanNs;
+        latency["p50"] = r.p50Ns;
+        latency["p90"] = r.p90Ns;
+        latency["p99"] = r.p99Ns;
+        latency["max"] = r.maxNs;
+
+        QJsonObject c;
+        c["name"] = r.name;
+        c["unit"] = r.unit;
+        c["iterations"] = r.iterations;
+        c["itemsPerOp"] = r.itemsPerOp;
+        c["throughput"] = r.throughput;
+        c["latencyNs"] = latency;
+        c["allocsPerOp"] = r.allocsPerOp;
+        c["bytesPerOp"] = r.bytesPerOp;
+        cases.append(c);
+    }
+
+    QJsonObject root;
+    root["schema"] = 1;
+    root["config"] = config;
+    root["results"] = cases;
+    return root;
+}
+
+int BenchRunner::compareWithBaseline(const QJsonObject &baseline, double tolerancePercent,
+                                     QTextStream &out) const
+{
+    QMap<QString, QJsonObject> base;
+    const QJsonArray cases = baseline.value("results").toArray();
+    for (const QJsonValue &v : cases) {
+        const QJsonObject c = v.toObject();
+        base.insert(c.value("name").toString(), c);
+    }
+
+    int regressions = 0;
+    out << QString("%1 %2 %3 %4 %5\n")
+               .arg("case", -28)
+               .arg("base p50", 11)
+               .arg("p50 (us)", 11)
+               .arg("change", 9)
+               .arg("allocs/op", 15);
+    for (const BenchResult &r : m_results) {
+        if (!base.contains(r.name)) {
+            out << QString("%1 (not in baseline)\n").arg(r.name, -28);
+            continue;
+        }
+        const QJsonObject b = base.value(r.name);
+        const double baseP50 = b.value("latencyNs").toObject().value("p50").toDouble();
+        const double baseAllocs = b.value("allocsPerOp").toDouble();
+        const double change = baseP50 > 0.0 ? (r.p50Ns / baseP50 - 1.0) * 100.0 : 0.0;
+        const bool regressed = change > tolerancePercent;
+        if (regressed) {
+            ++regressions;
+        }
+        out << QString("%1 %2 %3 %4 %5%6\n")
+                   .arg(r.name, -28)
+                   .arg(baseP50 * 1e-3, 11, 'f', 1)
+                   .arg(r.p50Ns * 1e-3, 11, 'f', 1)
+                   .arg(QString("%1%2%").arg(change >= 0.0 ? "+" : "").arg(change, 0, 'f', 1), 9)
+                   .arg(QString("%1 -> %2").arg(baseAllocs, 0, 'f', 1).arg(r.allocsPerOp, 0, 'f', 1), 15)
+                   .arg(regressed ? "  REGRESSION" : "");
+    }
+    out.flush();
+    return regressions;
+}
@@ -0,0 +1,81 @@
+#ifndef BENCHRUNNER_H
+#define BENCHRUNNER_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QTextStream>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief 让编译器认为 value 被使用，防止被测计算作为无用代码删除（不产生额外指令）
+ */
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    volatile T sink = value;
+    (void)sink;
+#endif
+}
+
+/**
+ * @brief 一个基准用例的结果
+ */
+struct BenchResult {
+    QString name;               // 用例名（"分类/操作"，与基线按名称对应）
+    QString unit;               // 每次操作处理的单位（samples / curves / queries / frames）
+    int iterations = 0;
+    double itemsPerOp = 0.0;    // 每次操作处理的单位数
+    double throughput = 0.0;    // 单位 / 秒（按全部迭代的总耗时计算）
+    double meanNs = 0.0;        // 单次操作耗时（纳秒）
+    double p50Ns = 0.0;
+    double p90Ns = 0.0;
+    double p99Ns = 0.0;
+    double maxNs = 0.0;
+    double allocsPerOp = 0.0;   // 每次操作的平均堆分配次数
+    double bytesPerOp = 0.0;    // 每次操作的平均堆分配字节数
+};
+
+/**
+ * @brief 基准用例的计时与汇总
+ *
+ * 每个用例先预热若干次，然后逐次计时，得到延迟分位数、吞吐量和每次操作的分配次数；
+ * 结果可输出为文本表格或 JSON（用于与保存的基线比较）。
+ */
+class BenchRunner
+{
+public:
+    void setIterations(int iterations) { m_iterations = iterations; }
+    void setWarmup(int warmup) { m_warmup = warmup; }
+
+    /**
+     * @brief 运行一个用例
+     * @param iterations 计时次数（<= 0 时使用 setIterations() 的值）
+     * @param op 执行一次被测操作
+     */
+    const BenchResult &run(const QString &name, const QString &unit, double itemsPerOp,
+                           const std::function<void()> &op, int iterations = 0);
+
+    const std::vector<BenchResult> &results() const { return m_results; }
+
+    void printTable(QTextStream &out) const;
+    QJsonObject toJson(const QJsonObject &config) const;
+
+    /**
+     * @brief 与基线比较 p50 延迟
+     * @param tolerancePercent 允许的变慢幅度（百分比）
+     * @return 超出允许幅度的用例数
+     */
+    int compareWithBaseline(const QJsonObject &baseline, double tolerancePercent,
+                            QTextStream &out) const;
+
+private:
+    int m_iterations = 200;
+    int m_warmup = 5;
+    std::vector<BenchResult> m_results;
+};
+
+#endif // BENCHRUNNER_H
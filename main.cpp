@@ -1,10 +1,47 @@
 #include "mainwindow.h"
 
 #include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <cstdlib>
 #include "logindialog.h"
+#include "asynclogger.h"
+#include "tracer.h"
+
+/**
+ * @brief Qt 自身的 qDebug / qWarning 等也经过异步日志（不在调用线程写文件或控制台）
+ */
+static void qtMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    static const LogLevel levels[] = {LogLevel::Debug, LogLevel::Warn, LogLevel::Error,
+                                      LogLevel::Error, LogLevel::Info};
+    const LogLevel level = (int(type) >= 0 && int(type) < 5) ? levels[int(type)] : LogLevel::Info;
+    POWERDAQ_LOG(level, message);
+    if (type == QtFatalMsg) {
+        AsyncLogger::instance().stop();     // 写完再退出
+        std::abort();
+    }
+}
+
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    Tracer::setThreadName("GUI");   // 时间线中主线程的名称（在任何记录之前设置一次）
+
+    // 0. 日志：写入 文档/PowerDAQ/logs/PowerDAQ.log（按大小轮转），调试版同时输出到控制台
+    LogConfig logConfig;
+    const QString logDir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/PowerDAQ/logs";
+    if (QDir().mkpath(logDir)) {
+        logConfig.path = QFile::encodeName(logDir + "/PowerDAQ.log").toStdString();
+    }
+#ifndef NDEBUG
+    logConfig.level = LogLevel::Debug;
+    logConfig.console = true;
+#endif
+    AsyncLogger::instance().start(logConfig);
+    qInstallMessageHandler(qtMessageHandler);
+
     // 1. 先显示登录对话框
     LoginDialog loginDialog;
 
@@ -20,5 +57,9 @@ int main(int argc, char *argv[])
 
     MainWindow w;
     w.show();
-    return a.exec();
+    const int code = a.exec();
+
+    qInstallMessageHandler(nullptr);
+    AsyncLogger::instance().stop();
+    return code;
 }
@@ -0,0 +1,261 @@
+#include "asynclogger.h"
+#include "concurrentqueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <ctime>
+#include <vector>
+
+namespace {
+constexpr std::size_t kMaxProducers = 16;       // 预分配队列空间的生产者线程数
+constexpr std::size_t kWriteBatch = 64;         // 后台线程每批取出的条数
+constexpr int kIdleWaitMs = 20;                 // 队列为空时的等待间隔
+
+std::uint32_t currentThreadId()
+{
+    static std::atomic<std::uint32_t> next{1};
+    thread_local const std::uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+char levelTag(LogLevel level)
+{
+    static const char tags[] = {'T', 'D', 'I', 'W', 'E', '-'};
+    return tags[int(level)];
+}
+}
+
+constexpr std::size_t AsyncLogger::kMaxMessage;
+constexpr std::size_t AsyncLogger::kQueueCapacity;
+
+/**
+ * @brief 一条日志（定长，入队不分配内存）
+ */
+struct AsyncLogger::Record {
+    std::int64_t timeUs = 0;        // 系统时间（微秒，Unix 纪元）
+    std::uint32_t thread = 0;       // 调用线程的序号
+    LogLevel level = LogLevel::Info;
+    std::uint16_t length = 0;
+    char text[kMaxMessage];
+};
+
+/**
+ * @brief 有界无锁队列：空间在构造时按 kQueueCapacity 预分配，只用 try_enqueue（满时失败，不扩容）
+ *
+ * 每个生产者线程的块索引也要能容纳整个队列，否则单个线程突发写入时会在队列未满前就入队失败。
+ */
+struct LogQueueTraits : moodycamel::ConcurrentQueueDefaultTraits {
+    static const std::size_t IMPLICIT_INITIAL_INDEX_SIZE = 512;   // >= kQueueCapacity / BLOCK_SIZE
+};
+
+struct AsyncLogger::Queue {
+    moodycamel::ConcurrentQueue<Record, LogQueueTraits> records;
+
+    Queue() : records(kQueueCapacity, 0, kMaxProducers) {}
+};
+
+AsyncLogger &AsyncLogger::instance()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger()
+    : m_queue(new Queue)
+{
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stop();
+}
+
+bool AsyncLogger::start(const LogConfig &config)
+{
+    stop();
+
+    m_config = config;
+    m_config.maxFiles = std::max(1, m_config.maxFiles);
+    setLevel(config.level);
+
+    bool ok = true;
+    if (!m_config.path.empty()) {
+        m_file = std::fopen(m_config.path.c_str(), "ab");
+        if (m_file) {
+            std::fseek(m_file, 0, SEEK_END);
+            m_fileBytes = std::size_t(std::max(0L, std::ftell(m_file)));
+        } else {
+            ok = false;
+        }
+    }
+
+    m_stop = false;
+    m_thread = std::thread(&AsyncLogger::run, this);
+    return ok;
+}
+
+void AsyncLogger::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    m_fileBytes = 0;
+}
+
+void AsyncLogger::log(LogLevel level, const char *text, std::size_t length)
+{
+    Record record;
+    record.level = level;
+    record.length = std::uint16_t(std::min(length, kMaxMessage));
+    std::copy(text, text + record.length, record.text);
+    enqueue(record);
+}
+
+void AsyncLogger::logf(LogLevel level, const char *format, ...)
+{
+    Record record;
+    record.level = level;
+    va_list args;
+    va_start(args, format);
+    const int n = std::vsnprintf(record.text, kMaxMessage, format, args);
+    va_end(args);
+    record.length = std::uint16_t(n < 0 ? 0 : std::min(std::size_t(n), kMaxMessage - 1));
+    enqueue(record);
+}
+
+bool AsyncLogger::enqueue(Record &record)
+{
+    record.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.thread = currentThreadId();
+    if (!m_queue->records.try_enqueue(std::move(record))) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 后台线程：批量取出并写出；停止时写完剩余日志再退出
+ */
+void AsyncLogger::run()
+{
+    std::vector<Record> batch(kWriteBatch);
+    std::uint64_t reportedDrops = 0;
+
+    // 取出一批写出；返回取出的条数
+    auto writeBatch = [&]() {
+        const std::size_t n = m_queue->records.try_dequeue_bulk(batch.begin(), kWriteBatch);
+        bool urgent = false;
+        for (std::size_t i = 0; i < n; ++i) {
+            write(batch[i]);
+            urgent |= batch[i].level >= LogLevel::Warn;
+        }
+
+        // 丢弃的条数作为一条警告写出，便于发现日志量过大
+        const std::uint64_t drops = m_dropped.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            Record note;
+            note.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            note.thread = currentThreadId();
+            note.level = LogLevel::Warn;
+            const int len = std::snprintf(note.text, kMaxMessage, "logger: dropped %llu messages (queue full)",
+                                          static_cast<unsigned long long>(drops - reportedDrops));
+            note.length = std::uint16_t(std::max(0, len));
+            write(note);
+            reportedDrops = drops;
+            urgent = true;
+        }
+        if (m_file && (urgent || n == 0)) {
+            std::fflush(m_file);
+        }
+        return n;
+    };
+
+    for (;;) {
+        if (writeBatch() == kWriteBatch) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_stop) {
+            lock.unlock();
+            // 写完停止前已入队的日志
+            while (writeBatch() > 0) {
+            }
+            return;
+        }
+        m_wake.wait_for(lock, std::chrono::milliseconds(kIdleWaitMs), [this]() { return m_stop; });
+    }
+}
+
+void AsyncLogger::write(const Record &record)
+{
+    // 时间前缀：2026-01-01 12:00:00.000 I [3]
+    const std::time_t seconds = std::time_t(record.timeUs / 1000000);
+    std::tm local{};
+#if defined(_WIN32)
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    char prefix[64];
+    const std::size_t stamp = std::strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &local);
+    const int tail = std::snprintf(prefix + stamp, sizeof(prefix) - stamp, ".%03d %c [%u] ",
+                                   int(record.timeUs / 1000 % 1000), levelTag(record.level), record.thread);
+    const std::size_t prefixLength = stamp + std::size_t(std::max(0, tail));
+    const std::size_t lineBytes = prefixLength + record.length + 1;
+
+    if (m_config.console) {
+        std::fwrite(prefix, 1, prefixLength, stderr);
+        std::fwrite(record.text, 1, record.length, stderr);
+        std::fputc('\n', stderr);
+    }
+    if (!m_file) {
+        return;
+    }
+    if (m_fileBytes > 0 && m_fileBytes + lineBytes > m_config.maxFileBytes) {
+        rotate();
+        if (!m_file) {
+            return;
+        }
+    }
+    std::fwrite(prefix, 1, prefixLength, m_file);
+    std::fwrite(record.text, 1, record.length, m_file);
+    std::fputc('\n', m_file);
+    m_fileBytes += lineBytes;
+}
+
+/**
+ * @brief 轮转：path.(n-2) -> path.(n-1) ... path -> path.1，然后重新打开 path
+ */
+void AsyncLogger::rotate()
+{
+    std::fclose(m_file);
+    m_file = nullptr;
+    m_fileBytes = 0;
+
+    const std::string &path = m_config.path;
+    for (int i = m_config.maxFiles - 1; i >= 1; --i) {
+        const std::string from = (i == 1) ? path : path + "." + std::to_string(i - 1);
+        const std::string to = path + "." + std::to_string(i);
+        std::remove(to.c_str());
+        std::rename(from.c_str(), to.c_str());
+    }
+    if (m_config.maxFiles == 1) {
+        std::remove(path.c_str());
+    }
+    m_file = std::fopen(path.c_str(), "ab");
+}
@@ -0,0 +1,135 @@
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+enum class LogLevel { Trace = 0, Debug, Info, Warn, Error, Off };
+
+/**
+ * @brief 日志配置
+ */
+struct LogConfig {
+    std::string path;                           // 日志文件（为空时只输出到 stderr）
+    std::size_t maxFileBytes = 8u << 20;        // 单个文件上限，超出后轮转
+    int maxFiles = 5;                           // 保留的文件数（path, path.1 ... path.(maxFiles-1)）
+    LogLevel level = LogLevel::Info;
+    bool console = false;                       // 同时输出到 stderr
+};
+
+/**
+ * @brief 异步日志：调用线程只做级别判断、格式化和一次无锁入队，写文件在后台线程
+ *
+ * - 级别过滤在格式化之前进行（POWERDAQ_LOG 宏），被过滤的日志不产生任何格式化开销；
+ * - 日志记录定长（超长截断），入队不分配内存；队列有界，满时丢弃并计数，从不阻塞调用方；
+ * - 后台线程批量写出，单个文件超过 maxFileBytes 后按 path -> path.1 -> ... 轮转；
+ * - start() 之前的日志先留在队列中（最多 kQueueCapacity 条），启动后一并写出。
+ *
+ * 用法：
+ *   POWERDAQ_LOG(LogLevel::Info, QString("开始采集：%1").arg(name));
+ *   POWERDAQ_LOGF(LogLevel::Warn, "queue depth %zu", depth);
+ */
+class AsyncLogger
+{
+public:
+    static constexpr std::size_t kMaxMessage = 480;       // 单条日志的最大字节数（UTF-8）
+    static constexpr std::size_t kQueueCapacity = 8192;   // 队列容量（条）
+
+    static AsyncLogger &instance();
+
+    ~AsyncLogger();
+    AsyncLogger(const AsyncLogger &) = delete;
+    AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+    /**
+     * @brief 打开日志文件并启动后台线程（已启动时先停止）
+     * @return 日志文件无法打开时返回 false（仍按 console 设置输出到 stderr）
+     */
+    bool start(const LogConfig &config);
+
+    /**
+     * @brief 写完队列中剩余的日志并停止后台线程
+     */
+    void stop();
+
+    void setLevel(LogLevel level) { m_level.store(int(level), std::memory_order_relaxed); }
+    LogLevel level() const { return LogLevel(m_level.load(std::memory_order_relaxed)); }
+    bool isEnabled(LogLevel level) const
+    {
+        return int(level) >= m_level.load(std::memory_order_relaxed) && level != LogLevel::Off;
+    }
+
+    // --- 入队（任意线程，不阻塞；调用前应先用 isEnabled() 过滤） ---
+    void log(LogLevel level, const char *text, std::size_t length);
+    void log(LogLevel level, const char *text) { log(level, text, std::char_traits<char>::length(text)); }
+    void log(LogLevel level, const std::string &text) { log(level, text.data(), text.size()); }
+    void log(LogLevel level, const QString &text)
+    {
+        const QByteArray utf8 = text.toUtf8();
+        log(level, utf8.constData(), std::size_t(utf8.size()));
+    }
+
+    /**
+     * @brief printf 风格：直接格式化到日志记录中（不分配内存）
+     */
+    void logf(LogLevel level, const char *format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 3, 4)))
+#endif
+        ;
+
+    /**
+     * @brief 因队列已满而丢弃的日志条数
+     */
+    std::uint64_t droppedMessages() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Record;
+    struct Queue;
+
+    AsyncLogger();
+    bool enqueue(Record &record);
+    void run();
+    void write(const Record &record);
+    void rotate();
+
+    std::unique_ptr<Queue> m_queue;
+    std::atomic<int> m_level{int(LogLevel::Info)};
+    std::atomic<std::uint64_t> m_dropped{0};
+
+    // --- 后台线程 ---
+    std::thread m_thread;
+    std::mutex m_mutex;                 // 只用于后台线程的等待 / 唤醒
+    std::condition_variable m_wake;
+    bool m_stop = false;
+    LogConfig m_config;
+    std::FILE *m_file = nullptr;
+    std::size_t m_fileBytes = 0;
+};
+
+/**
+ * @brief 先判断级别再求值 message（被过滤时不做任何格式化）
+ */
+#define POWERDAQ_LOG(level, message) \
+    do { \
+        if (AsyncLogger::instance().isEnabled(level)) { \
+            AsyncLogger::instance().log(level, message); \
+        } \
+    } while (0)
+
+#define POWERDAQ_LOGF(level, ...) \
+    do { \
+        if (AsyncLogger::instance().isEnabled(level)) { \
+            AsyncLogger::instance().logf(level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#endif // ASYNCLOGGER_H
@@ -0,0 +1,276 @@
+#include "channelbuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 显式时间戳通道按时长换算容量前，至少观察的样点数（用于估计平均采样周期）
+constexpr std::int64_t kPeriodProbeSamples = 1024;
+}
+
+ChannelBuffer::ChannelBuffer()
+{
+    applyCapacity();
+}
+
+void ChannelBuffer::setRetention(const RetentionPolicy &policy)
+{
+    m_policy = policy;
+    applyCapacity();
+}
+
+/**
+ * @brief 按保留策略换算容量上限（样点数）
+ * @return 0 表示无上限，或时长策略下采样周期尚未确定
+ */
+std::int64_t ChannelBuffer::resolveCapacity() const
+{
+    switch (m_policy.unit) {
+    case RetentionPolicy::Unit::Unlimited:
+        return 0;
+
+    case RetentionPolicy::Unit::Samples:
+        return std::max<std::int64_t>(1, std::int64_t(m_policy.value));
+
+    case RetentionPolicy::Unit::Bytes: {
+        // 三列数据各 8 字节 + 三列金字塔和前缀和；显式时间戳模式再加 8 字节
+        const double perSample = ((m_time.mode() == TimeAxis::Mode::Explicit) ? 32.0 : 24.0)
+                               + 3.0 * (MinMaxPyramid::bytesPerSample() + PrefixSums::bytesPerSample());
+        return std::max<std::int64_t>(1, std::int64_t(m_policy.value / perSample));
+    }
+
+    case RetentionPolicy::Unit::Seconds: {
+        double period = 0.0;
+        if (m_time.isUniform()) {
+            period = m_time.samplePeriod();
+        } else if (m_time.size() >= kPeriodProbeSamples) {
+            period = (m_time.last() - m_time.first()) / double(m_time.size() - 1);
+        }
+        if (!(period > 0.0)) {
+            return 0;
+        }
+        return std::max<std::int64_t>(1, std::int64_t(std::ceil(m_policy.value / period)));
+    }
+    }
+    return 0;
+}
+
+void ChannelBuffer::applyCapacity()
+{
+    const std::int64_t capacity = resolveCapacity();
+    m_resolvedMode = m_time.mode();
+    if (capacity == m_capacity) {
+        return;
+    }
+    m_capacity = capacity;
+    m_time.setCapacityLimit(m_capacity);
+    m_voltage.setCapacityLimit(std::size_t(m_capacity));
+    m_current.setCapacityLimit(std::size_t(m_capacity));
+    m_power.setCapacityLimit(std::size_t(m_capacity));
+    rebuildSummaries();
+}
+
+/**
+ * @brief 重建金字塔和前缀和（仅在容量变化时发生，代价与保留样点数成正比）
+ */
+void ChannelBuffer::rebuildSummaries()
+{
+    const std::int64_t first = m_time.firstIndex();
+    const SampleRing *columns[3] = {&m_voltage, &m_current, &m_power};
+    MinMaxPyramid *pyramids[3] = {&m_voltagePyramid, &m_currentPyramid, &m_powerPyramid};
+    PrefixSums *sums[3] = {&m_voltageSums, &m_currentSums, &m_powerSums};
+    for (int c = 0; c < 3; ++c) {
+        pyramids[c]->setCapacityLimit(m_capacity);
+        pyramids[c]->reset(first);
+        sums[c]->setCapacityLimit(m_capacity);
+        sums[c]->reset(first);
+        SampleRing::Span parts[2];
+        const int n = columns[c]->spans(0, columns[c]->size(), parts);
+        for (int k = 0; k < n; ++k) {
+            pyramids[c]->append(parts[k].data, parts[k].size);
+            sums[c]->append(parts[k].data, parts[k].size);
+        }
+    }
+}
+
+void ChannelBuffer::append(const double *time, double t0, double dt,
+                           const double *voltage, const double *current,
+                           const double *power, std::size_t count)
+{
+    if (count == 0 || !voltage || !current) {
+        return;
+    }
+
+    if (m_cold.isEnabled() && m_capacity > 0) {
+        // 单段超过容量时分段写入，保证每个样点都经过热窗口再转入冷数据
+        if (count > std::size_t(m_capacity)) {
+            const std::size_t step = std::size_t(m_capacity);
+            for (std::size_t off = 0; off < count; off += step) {
+                const std::size_t n = std::min(step, count - off);
+                append(time ? time + off : nullptr, t0 + double(off) * dt, dt,
+                       voltage + off, current + off, power ? power + off : nullptr, n);
+            }
+            return;
+        }
+        // 热窗口将被覆盖的最旧样点先压缩转入冷数据
+        const std::int64_t overflow = m_time.size() + std::int64_t(count) - m_capacity;
+        if (overflow > 0) {
+            evictToCold(std::min(overflow, m_time.size()));
+        }
+    }
+
+    if (time) {
+        m_time.appendExplicit(time, std::int64_t(count));
+    } else {
+        m_time.appendUniform(t0, dt, std::int64_t(count));
+    }
+    m_voltage.append(voltage, count);
+    m_current.append(current, count);
+    m_voltagePyramid.append(voltage, count);
+    m_currentPyramid.append(current, count);
+    m_voltageSums.append(voltage, count);
+    m_currentSums.append(current, count);
+
+    // 功率列：未提供或无效（NaN/Inf/0）时按 V*I 计算
+    m_powerScratch.resize(count);
+    double *dst = m_powerScratch.data();
+    if (!power) {
+        for (std::size_t i = 0; i < count; ++i) {
+            dst[i] = voltage[i] * current[i];
+        }
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            const double p = power[i];
+            dst[i] = (std::isnan(p) || std::isinf(p) || p == 0.0) ? voltage[i] * current[i] : p;
+        }
+    }
+    m_power.append(dst, count);
+    m_powerPyramid.append(dst, count);
+    m_powerSums.append(dst, count);
+    m_integrator.append(time, t0, dt, current, dst, count);
+
+    // 时基模式变化（均匀 -> 显式）或时长策略首次可换算时，重新确定容量
+    if (m_time.mode() != m_resolvedMode
+        || (m_capacity == 0 && m_policy.unit == RetentionPolicy::Unit::Seconds)) {
+        applyCapacity();
+    }
+}
+
+/**
+ * @brief 把热窗口最旧的 count 个样点交给冷数据（随后的追加会在环形缓冲中覆盖它们）
+ */
+void ChannelBuffer::evictToCold(std::int64_t count)
+{
+    const std::size_t n = std::size_t(count);
+    std::vector<double> &time = m_coldScratch[0];
+    time.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        time[i] = m_time.at(std::int64_t(i));
+    }
+    const SampleRing *columns[3] = {&m_voltage, &m_current, &m_power};
+    for (int c = 0; c < 3; ++c) {
+        std::vector<double> &dst = m_coldScratch[c + 1];
+        dst.clear();
+        SampleRing::Span parts[2];
+        const int k = columns[c]->spans(0, n, parts);
+        for (int p = 0; p < k; ++p) {
+            dst.insert(dst.end(), parts[p].data, parts[p].data + parts[p].size);
+        }
+    }
+    m_cold.append(time.data(), m_coldScratch[1].data(), m_coldScratch[2].data(),
+                  m_coldScratch[3].data(), n);
+}
+
+void ChannelBuffer::clear()
+{
+    m_time.clear();
+    m_voltage.clear();
+    m_current.clear();
+    m_power.clear();
+    m_voltagePyramid.reset();
+    m_currentPyramid.reset();
+    m_powerPyramid.reset();
+    m_voltageSums.reset();
+    m_currentSums.reset();
+    m_powerSums.reset();
+    m_integrator.reset();
+    m_cold.clear();
+    applyCapacity();
+}
+
+std::size_t ChannelBuffer::memoryBytes() const
+{
+    return m_time.memoryBytes()
+         + m_voltage.memoryBytes()
+         + m_current.memoryBytes()
+         + m_power.memoryBytes()
+         + m_voltagePyramid.memoryBytes()
+         + m_currentPyramid.memoryBytes()
+         + m_powerPyramid.memoryBytes()
+         + m_voltageSums.memoryBytes()
+         + m_currentSums.memoryBytes()
+         + m_powerSums.memoryBytes()
+         + m_powerScratch.capacity() * sizeof(double)
+         + m_cold.memoryBytes();
+}
+
+RegionStats ChannelBuffer::regionStats(double tStart, double tEnd) const
+{
+    RegionStats out;
+    const std::int64_t n = m_time.size();
+    const std::int64_t b = std::min(n, m_time.lowerBound(tStart));
+    const std::int64_t e = std::max(b, std::min(n, m_time.upperBound(tEnd)));
+    // 区间中早于热窗口的部分在冷数据中
+    const std::int64_t cb = m_cold.lowerBound(tStart);
+    const std::int64_t ce = std::max(cb, m_cold.upperBound(tEnd));
+    out.count = (e - b) + (ce - cb);
+    if (out.count == 0) {
+        return out;
+    }
+
+    const std::int64_t first = m_time.firstIndex();
+    auto column = [&](const SampleRing &raw, const MinMaxPyramid &pyramid, const PrefixSums &sums,
+                      ColdStore::Column coldColumn) {
+        ColdStore::Summary s;
+        if (ce > cb) {
+            s = m_cold.summarize(coldColumn, cb, ce);
+        }
+        if (e > b) {
+            const PrefixSums::Moments m = sums.moments(raw, first, b, e);
+            const MinMaxPyramid::Summary h = pyramid.summarize(raw, first, b, e);
+            if (s.count == 0 || std::isnan(s.min) || h.min < s.min) {
+                s.min = h.min;
+            }
+            if (s.count == 0 || std::isnan(s.max) || h.max > s.max) {
+                s.max = h.max;
+            }
+            s.sum += m.sum;
+            s.sumSq += m.sumSq;
+            s.count += m.count;
+        }
+        ColumnStats c;
+        if (s.count > 0) {
+            c.mean = s.sum / double(s.count);
+            c.rms = std::sqrt(std::max(0.0, s.sumSq / double(s.count)));
+        }
+        c.min = s.min;
+        c.max = s.max;
+        return c;
+    };
+    out.voltage = column(m_voltage, m_voltagePyramid, m_voltageSums, ColdStore::Column::Voltage);
+    out.current = column(m_current, m_currentPyramid, m_currentSums, ColdStore::Column::Current);
+    out.power = column(m_power, m_powerPyramid, m_powerSums, ColdStore::Column::Power);
+
+    // 均匀时基按采样周期计（间隙不计入时长）；显式时间戳按区间内的平均周期计
+    double period = 0.0;
+    if (m_time.isUniform()) {
+        period = m_time.samplePeriod();
+    } else if (out.count > 1) {
+        const double tFirst = (ce > cb) ? m_cold.timeAt(cb) : m_time.at(b);
+        const double tLast = (e > b) ? m_time.at(e - 1) : m_cold.timeAt(ce - 1);
+        period = (tLast - tFirst) / double(out.count - 1);
+    }
+    out.duration = double(out.count) * period;
+    out.energy = out.power.mean * out.duration;
+    return out;
+}
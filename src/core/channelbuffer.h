@@ -0,0 +1,142 @@
+#ifndef CHANNELBUFFER_H
+#define CHANNELBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "timeaxis.h"
+#include "samplering.h"
+#include "minmaxpyramid.h"
+#include "prefixsums.h"
+#include "channelintegrator.h"
+#include "coldstore.h"
+
+/**
+ * @brief 时间区间内一列数据的统计
+ */
+struct ColumnStats {
+    double mean = 0.0;
+    double rms = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+};
+
+/**
+ * @brief 时间区间内一个通道的统计（count == 0 表示区间内没有样点）
+ */
+struct RegionStats {
+    std::int64_t count = 0;
+    double duration = 0.0;      // 样点覆盖的时长（秒）= 样点数 * 采样周期
+    ColumnStats voltage;
+    ColumnStats current;
+    ColumnStats power;
+    double energy = 0.0;        // 能量（J）= 功率均值 * duration
+};
+
+/**
+ * @brief 单通道原始数据存储（时间轴 + 电压/电流/功率三列环形缓冲）
+ *
+ * 各列共用同一个容量上限，同步写入、同步丢弃，逻辑索引 i 在各列之间一一对应
+ * （0 为最旧的保留样点）。预热阶段按倍增扩容至上限，之后追加为 O(1) 覆盖写入，
+ * 不再发生内存重分配。
+ *
+ * 每列附带一个 Min/Max 金字塔和分块前缀和，随追加增量更新，
+ * 用于按视口降采样和 O(1) 区间统计。另有一个电荷量/能量积分器，
+ * 累计自上次 clear() 以来写入的全部数据（不受保留策略影响）。
+ *
+ * 启用冷数据（setColdStorage）后，超出保留量的最旧样点不直接丢弃，而是压缩后转入
+ * ColdStore：环形缓冲是全速读写的热窗口，更早的历史以 1/5~1/20 的内存按需解码读取。
+ */
+class ChannelBuffer
+{
+public:
+    ChannelBuffer();
+
+    /**
+     * @brief 设置保留策略（立即生效，缩小时丢弃最旧的样点）
+     */
+    void setRetention(const RetentionPolicy &policy);
+    const RetentionPolicy &retention() const { return m_policy; }
+
+    /**
+     * @brief 设置冷数据策略（默认关闭）；关闭时丢弃已压缩的数据
+     */
+    void setColdStorage(const ColdStoragePolicy &policy) { m_cold.setPolicy(policy); }
+    const ColdStoragePolicy &coldStorage() const { return m_cold.policy(); }
+
+    /**
+     * @brief 冷数据：时间早于 time() 中的全部样点，序号独立（0 为最旧）
+     */
+    const ColdStore &cold() const { return m_cold; }
+
+    /**
+     * @brief 追加一段样点
+     * @param time 逐点时间戳；为 nullptr 时使用 t0 + k*dt（均匀采样）
+     * @param power 功率数组，可为 nullptr；未提供或无效（NaN/Inf/0）时按 V*I 计算
+     */
+    void append(const double *time, double t0, double dt,
+                const double *voltage, const double *current,
+                const double *power, std::size_t count);
+
+    void clear();
+
+    const TimeAxis &time() const { return m_time; }
+    const SampleRing &voltage() const { return m_voltage; }
+    const SampleRing &current() const { return m_current; }
+    const SampleRing &power() const { return m_power; }
+
+    const MinMaxPyramid &voltagePyramid() const { return m_voltagePyramid; }
+    const MinMaxPyramid &currentPyramid() const { return m_currentPyramid; }
+    const MinMaxPyramid &powerPyramid() const { return m_powerPyramid; }
+
+    /**
+     * @brief 电荷量 / 能量累计（包括已被保留策略丢弃的样点）
+     */
+    const ChannelIntegrator &integrator() const { return m_integrator; }
+
+    /**
+     * @brief 时间区间 [tStart, tEnd] 内的统计（均值 / RMS / 最值 / 能量）
+     * 均值和 RMS 来自前缀和，最值来自 Min/Max 金字塔，代价与区间长度无关；
+     * 区间落在冷数据中的部分由块摘要汇总，只解码两端的块。
+     */
+    RegionStats regionStats(double tStart, double tEnd) const;
+
+    std::int64_t size() const { return m_time.size(); }
+    bool isEmpty() const { return m_time.isEmpty(); }
+
+    /**
+     * @brief 当前生效的容量上限（样点数，0 表示无上限或尚未确定）
+     */
+    std::int64_t capacityLimit() const { return m_capacity; }
+
+    /**
+     * @brief 已分配的内存（字节，含冷数据）
+     */
+    std::size_t memoryBytes() const;
+
+private:
+    void evictToCold(std::int64_t count);   // 最旧的 count 个样点转入冷数据
+    std::int64_t resolveCapacity() const;   // 按保留策略和当前时间轴换算容量
+    void applyCapacity();                   // 容量变化时同步设置到各列
+    void rebuildSummaries();                // 按当前保留数据重建金字塔和前缀和
+
+    RetentionPolicy m_policy;
+    std::int64_t m_capacity = 0;            // 当前生效的容量上限
+    TimeAxis::Mode m_resolvedMode = TimeAxis::Mode::Empty; // 换算容量时的时基模式
+    TimeAxis m_time;
+    SampleRing m_voltage;
+    SampleRing m_current;
+    SampleRing m_power;
+    MinMaxPyramid m_voltagePyramid;
+    MinMaxPyramid m_currentPyramid;
+    MinMaxPyramid m_powerPyramid;
+    PrefixSums m_voltageSums;
+    PrefixSums m_currentSums;
+    PrefixSums m_powerSums;
+    ChannelIntegrator m_integrator;
+    std::vector<double> m_powerScratch;     // 功率列计算的复用缓冲
+    ColdStore m_cold;                       // 冷数据（超出保留量的压缩历史）
+    std::vector<double> m_coldScratch[4];   // 转入冷数据时的复用缓冲（时间 + 三列）
+};
+
+#endif // CHANNELBUFFER_H
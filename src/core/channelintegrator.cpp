@@ -0,0 +1,88 @@
+#include "channelintegrator.h"
+#include "reducekernels.h"
+
+#include <cmath>
+
+void ChannelIntegrator::reset()
+{
+    *this = ChannelIntegrator();
+}
+
+bool ChannelIntegrator::bridges(double gap) const
+{
+    return gap > 0.0 && (m_period <= 0.0 || gap <= kMaxGapPeriods * m_period);
+}
+
+/**
+ * @brief 累加一个梯形段；含 NaN/Inf 的段跳过，不污染累计值
+ */
+void ChannelIntegrator::addSegment(double dt, double i0, double i1, double p0, double p1)
+{
+    const double q = 0.5 * (i0 + i1) * dt;
+    const double e = 0.5 * (p0 + p1) * dt;
+    if (!std::isfinite(q) || !std::isfinite(e)) {
+        return;
+    }
+    m_charge.add(q);
+    m_energy.add(e);
+    m_duration.add(dt);
+}
+
+void ChannelIntegrator::append(const double *time, double t0, double dt,
+                               const double *current, const double *power, std::size_t count)
+{
+    if (count == 0 || !current || !power) {
+        return;
+    }
+
+    if (time) {
+        // 逐点时间戳：逐段累加
+        for (std::size_t k = 0; k < count; ++k) {
+            if (m_hasLast) {
+                const double gap = time[k] - m_lastTime;
+                if (bridges(gap)) {
+                    addSegment(gap, m_lastCurrent, current[k], m_lastPower, power[k]);
+                }
+                if (gap > 0.0) {
+                    m_period = gap;
+                }
+            }
+            m_hasLast = true;
+            m_lastTime = time[k];
+            m_lastCurrent = current[k];
+            m_lastPower = power[k];
+        }
+        return;
+    }
+
+    // 均匀采样：与上一块衔接的一段 + 块内各段之和
+    m_period = dt;
+    if (m_hasLast) {
+        const double gap = t0 - m_lastTime;
+        if (bridges(gap)) {
+            addSegment(gap, m_lastCurrent, current[0], m_lastPower, power[0]);
+        }
+    }
+    if (count >= 2) {
+        // 块内梯形面积 = dt * (总和 - (首 + 尾) / 2)，总和由 SIMD 归约得到
+        SpanReduction ri, rp;
+        reduceSpan(current, count, ri);
+        reduceSpan(power, count, rp);
+        const double q = dt * (ri.sum - 0.5 * (current[0] + current[count - 1]));
+        const double e = dt * (rp.sum - 0.5 * (power[0] + power[count - 1]));
+        if (std::isfinite(q) && std::isfinite(e)) {
+            m_charge.add(q);
+            m_energy.add(e);
+            m_duration.add(dt * double(count - 1));
+        } else {
+            // 块内有无效值：逐段累加，跳过无效的段
+            for (std::size_t k = 1; k < count; ++k) {
+                addSegment(dt, current[k - 1], current[k], power[k - 1], power[k]);
+            }
+        }
+    }
+    m_hasLast = true;
+    m_lastTime = t0 + double(count - 1) * dt;
+    m_lastCurrent = current[count - 1];
+    m_lastPower = power[count - 1];
+}
@@ -0,0 +1,54 @@
+#ifndef CHANNELINTEGRATOR_H
+#define CHANNELINTEGRATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include "compensatedsum.h"
+
+/**
+ * @brief 单通道的电荷量 / 能量累计（随数据写入流式更新）
+ *
+ * 对电流和功率按梯形法积分：相邻两个样点之间的面积为两点均值乘以时间间隔，
+ * 相邻数据块之间用上一块的最后一个样点衔接。总量用补偿求和累加，
+ * 连续采集数小时后精度也不下降。
+ *
+ * 积分在写入时完成，与显示状态和原始数据保留策略无关：曲线隐藏或样点已被环形缓冲丢弃后，
+ * 累计值仍然有效。两个样点的间隔超过正常采样周期的 kMaxGapPeriods 倍时视为采集中断，
+ * 该间隔不计入积分。
+ */
+class ChannelIntegrator
+{
+public:
+    static constexpr double kMaxGapPeriods = 8.0;
+
+    /**
+     * @brief 追加一段样点（参数含义同 ChannelBuffer::append，power 为最终的功率列）
+     */
+    void append(const double *time, double t0, double dt,
+                const double *current, const double *power, std::size_t count);
+
+    void reset();
+
+    double charge() const { return m_charge.value(); }      // 电荷量（C）
+    double energy() const { return m_energy.value(); }      // 能量（J）
+    double duration() const { return m_duration.value(); }  // 已积分的时长（秒，不含中断）
+
+    double chargeMilliampHours() const { return charge() / 3.6; }   // 1 mAh = 3.6 C
+    double energyMilliwattHours() const { return energy() / 3.6; }  // 1 mWh = 3.6 J
+
+private:
+    void addSegment(double dt, double i0, double i1, double p0, double p1);
+    bool bridges(double gap) const;     // 间隔 gap 是否视为连续采样
+
+    bool m_hasLast = false;             // 是否已有上一个样点（用于衔接下一块）
+    double m_lastTime = 0.0;
+    double m_lastCurrent = 0.0;
+    double m_lastPower = 0.0;
+    double m_period = 0.0;              // 最近一次的采样间隔（判断采集中断）
+
+    CompensatedSum m_charge;
+    CompensatedSum m_energy;
+    CompensatedSum m_duration;
+};
+
+#endif // CHANNELINTEGRATOR_H
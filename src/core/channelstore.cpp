@@ -0,0 +1,198 @@
+#include "channelstore.h"
+
+#include <algorithm>
+
+void ChannelStore::setMaxChannels(int count)
+{
+    std::vector<ChannelSlotPtr> dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxChannels = std::max(1, count);
+        if (int(m_slots.size()) > m_maxChannels) {
+            dropped.assign(m_slots.begin() + m_maxChannels, m_slots.end());
+            m_slots.resize(std::size_t(m_maxChannels));
+        }
+    }
+    // 丢弃的通道不再计入内存总量（数据槽可能仍被其他地方引用）
+    for (const ChannelSlotPtr &slot : dropped) {
+        if (slot) {
+            std::lock_guard<std::mutex> lock(slot->mutex);
+            m_bytes.fetch_sub(std::int64_t(slot->accountedBytes), std::memory_order_relaxed);
+            slot->accountedBytes = 0;
+        }
+    }
+}
+
+int ChannelStore::maxChannels() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxChannels;
+}
+
+void ChannelStore::setRetention(const RetentionPolicy &policy)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_retention = policy;
+    }
+    for (const ChannelSlotPtr &slot : snapshot()) {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->data.setRetention(policy);
+        account(*slot);
+    }
+}
+
+RetentionPolicy ChannelStore::retention() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_retention;
+}
+
+void ChannelStore::setColdStorage(const ColdStoragePolicy &policy)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_coldStorage = policy;
+    }
+    for (const ChannelSlotPtr &slot : snapshot()) {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->data.setColdStorage(policy);
+        account(*slot);
+    }
+}
+
+ColdStoragePolicy ChannelStore::coldStorage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_coldStorage;
+}
+
+/**
+ * @brief 块写入：每列一次整段拷贝（环形缓冲，预热后不再扩容）
+ */
+ChannelSlotPtr ChannelStore::append(int channelId, const double *time, double t0, double dt,
+                                    const double *voltage, const double *current, const double *power,
+                                    std::size_t count, const AppendObserver &observer)
+{
+    if (count == 0 || !voltage || !current || (!time && dt <= 0.0)) {
+        return ChannelSlotPtr();
+    }
+
+    // 获取或创建通道数据槽（新通道沿用当前保留策略和冷数据策略）
+    ChannelSlotPtr slot;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (channelId < 0 || channelId >= m_maxChannels) {
+            return ChannelSlotPtr();
+        }
+        if (channelId >= int(m_slots.size())) {
+            m_slots.resize(std::size_t(channelId) + 1);
+        }
+        ChannelSlotPtr &entry = m_slots[std::size_t(channelId)];
+        if (!entry) {
+            entry = std::make_shared<ChannelSlot>();
+            entry->data.setRetention(m_retention);
+            entry->data.setColdStorage(m_coldStorage);
+        }
+        slot = entry;
+    }
+
+    // 单块超过保留量时分段写入，保证每个样点被覆盖前都经过 observer
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    const std::int64_t limit = slot->data.capacityLimit();
+    const std::size_t step = (observer && limit > 0 && std::size_t(limit) < count)
+        ? std::size_t(limit) : count;
+    for (std::size_t off = 0; off < count; off += step) {
+        const std::size_t n = std::min(step, count - off);
+        slot->data.append(time ? time + off : nullptr, t0 + double(off) * dt, dt,
+                          voltage + off, current + off, power ? power + off : nullptr, n);
+        if (observer) {
+            observer(slot->data, n);
+        }
+    }
+    account(*slot);
+    return slot;
+}
+
+ChannelSlotPtr ChannelStore::slot(int channelId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (channelId < 0 || channelId >= int(m_slots.size())) {
+        return ChannelSlotPtr();
+    }
+    return m_slots[std::size_t(channelId)];
+}
+
+int ChannelStore::channelCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return int(m_slots.size());
+}
+
+void ChannelStore::clear()
+{
+    for (const ChannelSlotPtr &slot : snapshot()) {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->data.clear();
+        account(*slot);
+    }
+}
+
+void ChannelStore::clearChannel(int channelId)
+{
+    if (const ChannelSlotPtr s = slot(channelId)) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->data.clear();
+        account(*s);
+    }
+}
+
+bool ChannelStore::regionStats(int channelId, double tStart, double tEnd, RegionStats &out) const
+{
+    const ChannelSlotPtr s = slot(channelId);
+    if (!s) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(s->mutex);
+    if (s->data.isEmpty()) {
+        return false;
+    }
+    out = s->data.regionStats(tStart, tEnd);
+    return true;
+}
+
+bool ChannelStore::integrator(int channelId, ChannelIntegrator &out) const
+{
+    const ChannelSlotPtr s = slot(channelId);
+    if (!s) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(s->mutex);
+    out = s->data.integrator();
+    return true;
+}
+
+std::size_t ChannelStore::memoryBytes() const
+{
+    return std::size_t(std::max<std::int64_t>(0, m_bytes.load(std::memory_order_relaxed)));
+}
+
+void ChannelStore::account(ChannelSlot &slot)
+{
+    const std::size_t bytes = slot.data.memoryBytes();
+    m_bytes.fetch_add(std::int64_t(bytes) - std::int64_t(slot.accountedBytes), std::memory_order_relaxed);
+    slot.accountedBytes = bytes;
+}
+
+std::vector<ChannelSlotPtr> ChannelStore::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<ChannelSlotPtr> slots;
+    slots.reserve(m_slots.size());
+    for (const ChannelSlotPtr &slot : m_slots) {
+        if (slot) {
+            slots.push_back(slot);
+        }
+    }
+    return slots;
+}
@@ -0,0 +1,128 @@
+#ifndef CHANNELSTORE_H
+#define CHANNELSTORE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "channelbuffer.h"
+#include "capturefile.h"
+
+/**
+ * @brief 通道数据槽：通道数据 + 互斥锁
+ *
+ * 写入（ChannelStore::append）时持有 mutex；其他线程（降采样线程、分析线程）读取时
+ * 持有同一把锁，从而在一个通道内得到一致的快照（时间轴与各列长度一致）。
+ * 与写入方在同一线程的读取（例如界面线程写入、界面线程绘制）不与写入并发，无需加锁。
+ *
+ * 设置了 file 时数据槽以采集文件为后备存储：data 为空，曲线和降采样直接读取
+ * 内存映射的文件（只读，无需加锁）。
+ */
+struct ChannelSlot {
+    std::mutex mutex;
+    ChannelBuffer data;
+    CaptureFilePtr file;    // 文件后备存储（为空时使用 data）
+    int fileChannel = -1;   // 文件中的通道号
+    std::size_t accountedBytes = 0;     // 已计入 ChannelStore::memoryBytes() 的字节数（受 mutex 保护）
+
+    bool isEmpty() const { return file ? file->sampleCount(fileChannel) == 0 : data.isEmpty(); }
+};
+using ChannelSlotPtr = std::shared_ptr<ChannelSlot>;
+
+/**
+ * @brief 多通道数据池（与界面无关，可在任意线程使用）
+ *
+ * 按通道ID保存各通道的数据槽：通道在第一次写入时创建，沿用当前的保留策略和冷数据策略。
+ * 通道表由内部锁保护，每个通道的数据由各自数据槽的锁保护，
+ * 因此写入、统计和降采样（ViewportDownsampler）可以在不同线程中进行。
+ *
+ * 用法示例（无界面）：
+ *   ChannelStore store;
+ *   store.append(0, nullptr, 0.0, 1e-5, v, i, nullptr, n);
+ *   RegionStats stats;
+ *   store.regionStats(0, 0.0, 1.0, stats);
+ */
+class ChannelStore
+{
+public:
+    static constexpr int kDefaultMaxChannels = 256;
+
+    /**
+     * @brief 每段写入之后的回调（持有该通道的锁）：count 为刚写入的样点数，
+     * 位于 data 的末尾；用于触发检测等需要逐段处理新数据的流式计算
+     */
+    using AppendObserver = std::function<void(const ChannelBuffer &data, std::size_t count)>;
+
+    /**
+     * @brief 设置通道ID上限；缩小时丢弃超出的通道
+     */
+    void setMaxChannels(int count);
+    int maxChannels() const;
+
+    /**
+     * @brief 保留策略 / 冷数据策略：立即作用于已有通道，新建通道沿用
+     */
+    void setRetention(const RetentionPolicy &policy);
+    RetentionPolicy retention() const;
+    void setColdStorage(const ColdStoragePolicy &policy);
+    ColdStoragePolicy coldStorage() const;
+
+    /**
+     * @brief 写入一个通道的一段连续样点（参数含义同 ChannelBuffer::append）
+     *
+     * 单块超过保留量时分段写入，每段写入后调用 observer，保证每个样点在被覆盖前都经过处理。
+     * @return 写入的通道数据槽；通道ID或参数无效时返回空指针
+     */
+    ChannelSlotPtr append(int channelId, const double *time, double t0, double dt,
+                          const double *voltage, const double *current, const double *power,
+                          std::size_t count, const AppendObserver &observer = AppendObserver());
+
+    /**
+     * @brief 通道的数据槽（尚无数据时为空）
+     */
+    ChannelSlotPtr slot(int channelId) const;
+
+    /**
+     * @brief 通道表的长度（最大的已用通道ID + 1）
+     */
+    int channelCount() const;
+
+    void clear();
+    void clearChannel(int channelId);
+
+    // --- 分析（持有通道锁，可在任意线程调用） ---
+    /**
+     * @brief 时间区间 [tStart, tEnd] 内的统计
+     * @return 通道尚无数据时返回 false
+     */
+    bool regionStats(int channelId, double tStart, double tEnd, RegionStats &out) const;
+
+    /**
+     * @brief 电荷量 / 能量累计的快照
+     * @return 通道尚无数据时返回 false
+     */
+    bool integrator(int channelId, ChannelIntegrator &out) const;
+
+    /**
+     * @brief 各通道已分配的内存之和（字节，含冷数据）
+     *
+     * 每次写入、清空或调整策略后在通道锁内更新的原子计数，读取不加锁，可在显示帧中频繁调用。
+     */
+    std::size_t memoryBytes() const;
+
+private:
+    std::vector<ChannelSlotPtr> snapshot() const;  // 当前所有数据槽（在锁外逐个处理）
+    void account(ChannelSlot &slot);                // 按数据槽当前的内存更新总量（调用方持有该槽的锁）
+
+    mutable std::mutex m_mutex;                 // 保护通道表和策略
+    std::vector<ChannelSlotPtr> m_slots;        // 通道表（下标 = 通道ID，按需增长）
+    int m_maxChannels = kDefaultMaxChannels;
+    RetentionPolicy m_retention;
+    ColdStoragePolicy m_coldStorage;
+    std::atomic<std::int64_t> m_bytes{0};       // 各数据槽 accountedBytes 之和
+};
+
+#endif // CHANNELSTORE_H
@@ -0,0 +1,518 @@
+#include "coldstore.h"
+#include "reducekernels.h"
+#include "samplecodec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+using namespace SampleCodec;
+
+namespace {
+constexpr double kTick = 1e-9;              // 非均匀时间戳的保存精度（秒）
+constexpr double kUniformTolerance = 1e-3;  // 与均匀时基的偏差不超过 dt 的千分之一时按均匀保存
+
+bool sameValue(double a, double b)
+{
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+}
+
+ColdStore::ColdStore(const ColdStore &other)
+    : m_policy(other.m_policy)
+    , m_chunks(other.m_chunks)
+    , m_dropped(other.m_dropped)
+    , m_size(other.m_size)
+    , m_bytes(other.m_bytes)
+    , m_pendingTime(other.m_pendingTime)
+{
+    for (int c = 0; c < 3; ++c) {
+        m_pending[c] = other.m_pending[c];
+    }
+}
+
+ColdStore &ColdStore::operator=(const ColdStore &other)
+{
+    if (this != &other) {
+        m_policy = other.m_policy;
+        m_chunks = other.m_chunks;
+        m_dropped = other.m_dropped;
+        m_size = other.m_size;
+        m_bytes = other.m_bytes;
+        m_pendingTime = other.m_pendingTime;
+        for (int c = 0; c < 3; ++c) {
+            m_pending[c] = other.m_pending[c];
+        }
+        m_cache.reset(new Cache);
+    }
+    return *this;
+}
+
+void ColdStore::setPolicy(const ColdStoragePolicy &policy)
+{
+    m_policy = policy;
+    if (!m_policy.enabled) {
+        clear();
+        return;
+    }
+    enforceRetention();
+}
+
+void ColdStore::append(const double *time, const double *voltage, const double *current,
+                       const double *power, std::size_t count)
+{
+    if (!m_policy.enabled || count == 0) {
+        return;
+    }
+    const double *columns[3] = {voltage, current, power};
+    std::size_t off = 0;
+    while (off < count) {
+        const std::size_t take = std::min<std::size_t>(count - off, kChunkSamples - m_pendingTime.size());
+        m_pendingTime.insert(m_pendingTime.end(), time + off, time + off + take);
+        for (int c = 0; c < 3; ++c) {
+            m_pending[c].insert(m_pending[c].end(), columns[c] + off, columns[c] + off + take);
+        }
+        off += take;
+        m_size += std::int64_t(take);
+        if (m_pendingTime.size() == kChunkSamples) {
+            flushPending();
+        }
+    }
+    enforceRetention();
+}
+
+void ColdStore::clear()
+{
+    m_chunks.clear();
+    m_dropped = 0;
+    m_size = 0;
+    m_bytes = 0;
+    m_pendingTime.clear();
+    for (std::vector<double> &column : m_pending) {
+        column.clear();
+    }
+    // 块序号从 0 重新开始，旧的解码结果作废
+    std::lock_guard<std::mutex> lock(m_cache->mutex);
+    for (CacheEntry &e : m_cache->entries) {
+        e.chunkFirst = -1;
+    }
+}
+
+/**
+ * @brief 未满块攒满：压缩为一个块
+ */
+void ColdStore::flushPending()
+{
+    Chunk chunk;
+    chunk.first = pendingFirst() + m_dropped;
+    chunk.count = std::uint32_t(m_pendingTime.size());
+    encodeChunk(chunk);
+    m_bytes += chunk.bits.capacity() * sizeof(std::uint64_t);
+    m_chunks.push_back(std::move(chunk));
+
+    m_pendingTime.clear();
+    for (std::vector<double> &column : m_pending) {
+        column.clear();
+    }
+}
+
+void ColdStore::encodeChunk(Chunk &chunk)
+{
+    const std::uint32_t n = chunk.count;
+    const double *t = m_pendingTime.data();
+
+    // 时间：先尝试均匀时基，否则按 1 ns 刻度做 delta-of-delta
+    chunk.tFirst = t[0];
+    chunk.dt = (n > 1) ? (t[n - 1] - t[0]) / double(n - 1) : 0.0;
+    chunk.uniform = true;
+    const double tolerance = kUniformTolerance * chunk.dt;
+    for (std::uint32_t k = 1; k < n && chunk.uniform; ++k) {
+        chunk.uniform = std::fabs(t[k] - (chunk.tFirst + double(k) * chunk.dt)) <= tolerance;
+    }
+
+    chunk.bits.clear();
+    BitWriter w(chunk.bits);
+    chunk.offset[0] = 0;
+    if (chunk.uniform) {
+        chunk.tLast = chunk.tFirst + double(n - 1) * chunk.dt;
+    } else {
+        m_ticks.resize(n);
+        for (std::uint32_t k = 0; k < n; ++k) {
+            m_ticks[k] = std::llround((t[k] - chunk.tFirst) / kTick);
+        }
+        encodeTicks(m_ticks.data(), n, w);
+        chunk.dt = 0.0;
+        chunk.tLast = chunk.tFirst + double(m_ticks[n - 1]) * kTick;
+    }
+
+    // 数值：功率恰为 V*I 时不保存；有量化步长时差分编码，否则（或含 NaN/Inf 时）XOR
+    for (int c = 0; c < 3; ++c) {
+        chunk.offset[c + 1] = w.bitCount();
+        const double *v = m_pending[c].data();
+        std::vector<double> &recon = m_recon[c];
+        recon.resize(n);
+
+        bool product = (c == 2);
+        for (std::uint32_t k = 0; k < n && product; ++k) {
+            product = sameValue(v[k], m_pending[0][k] * m_pending[1][k]);
+        }
+        chunk.step[c] = stepFor(c);
+        if (product) {
+            chunk.codec[c] = ValueCodec::Product;
+            for (std::uint32_t k = 0; k < n; ++k) {
+                recon[k] = m_recon[0][k] * m_recon[1][k];
+            }
+        } else if (encodeScaled(v, n, chunk.step[c], w, recon.data())) {
+            chunk.codec[c] = ValueCodec::Scaled;
+        } else {
+            chunk.codec[c] = ValueCodec::Xor;
+            encodeXor(v, n, w);
+            std::memcpy(recon.data(), v, n * sizeof(double));
+        }
+
+        // 摘要按解码后的值计算，与读取结果一致
+        SpanReduction r;
+        reduceSpan(recon.data(), n, r);
+        ColumnSummary &s = chunk.summary[c];
+        s.min = r.min;
+        s.max = r.max;
+        s.sum = r.sum;
+        s.sumSq = r.sumSq;
+        s.minAt = std::uint32_t(r.minAt);
+        s.maxAt = std::uint32_t(r.maxAt);
+    }
+    chunk.bits.shrink_to_fit();
+}
+
+double ColdStore::stepFor(int column) const
+{
+    return (column == 0) ? m_policy.voltageStep
+         : (column == 1) ? m_policy.currentStep
+                         : m_policy.powerStep;
+}
+
+void ColdStore::dropFront()
+{
+    const Chunk &front = m_chunks.front();
+    m_dropped += front.count;
+    m_size -= front.count;
+    m_bytes -= front.bits.capacity() * sizeof(std::uint64_t);
+    m_chunks.pop_front();
+}
+
+/**
+ * @brief 超出冷数据保留量时按整块丢弃最旧的数据（未满块不丢弃）
+ */
+void ColdStore::enforceRetention()
+{
+    const RetentionPolicy &r = m_policy.retention;
+    switch (r.unit) {
+    case RetentionPolicy::Unit::Unlimited:
+        break;
+    case RetentionPolicy::Unit::Samples:
+        while (!m_chunks.empty() && double(m_size - m_chunks.front().count) >= r.value) {
+            dropFront();
+        }
+        break;
+    case RetentionPolicy::Unit::Seconds:
+        while (!m_chunks.empty() && lastTime() - m_chunks.front().tLast >= r.value) {
+            dropFront();
+        }
+        break;
+    case RetentionPolicy::Unit::Bytes:
+        while (!m_chunks.empty() && double(memoryBytes()) > r.value) {
+            dropFront();
+        }
+        break;
+    }
+}
+
+std::int64_t ColdStore::pendingFirst() const
+{
+    return m_size - std::int64_t(m_pendingTime.size());
+}
+
+/**
+ * @brief 除未满块外各块样点数都是 kChunkSamples，按序号直接定位
+ */
+std::size_t ColdStore::chunkIndex(std::int64_t i) const
+{
+    if (i >= pendingFirst()) {
+        return m_chunks.size();
+    }
+    return std::size_t(i / std::int64_t(kChunkSamples));
+}
+
+double ColdStore::chunkTime(const Chunk &chunk, std::uint32_t k) const
+{
+    if (chunk.uniform) {
+        return chunk.tFirst + double(k) * chunk.dt;
+    }
+    std::lock_guard<std::mutex> lock(m_cache->mutex);
+    return decoded(chunk, 0)[k];
+}
+
+double ColdStore::timeAt(std::int64_t i) const
+{
+    const std::size_t c = chunkIndex(i);
+    if (c == m_chunks.size()) {
+        return m_pendingTime[std::size_t(i - pendingFirst())];
+    }
+    return chunkTime(m_chunks[c], std::uint32_t(i - chunkStart(c)));
+}
+
+double ColdStore::valueAt(Column column, std::int64_t i) const
+{
+    const int col = int(column);
+    const std::size_t c = chunkIndex(i);
+    if (c == m_chunks.size()) {
+        return m_pending[col][std::size_t(i - pendingFirst())];
+    }
+    std::lock_guard<std::mutex> lock(m_cache->mutex);
+    return decoded(m_chunks[c], col + 1)[i - chunkStart(c)];
+}
+
+std::int64_t ColdStore::lowerBound(double t) const
+{
+    return search(t, false);
+}
+
+std::int64_t ColdStore::upperBound(double t) const
+{
+    return search(t, true);
+}
+
+std::int64_t ColdStore::nearest(double t) const
+{
+    if (m_size == 0) {
+        return -1;
+    }
+    const std::int64_t i = lowerBound(t);
+    if (i >= m_size) {
+        return m_size - 1;
+    }
+    if (i > 0 && t - timeAt(i - 1) <= timeAt(i) - t) {
+        return i - 1;
+    }
+    return i;
+}
+
+/**
+ * @brief 第一个时间 >= t（upper 时 > t）的样点：先按块的时间范围二分，再在块内定位
+ */
+std::int64_t ColdStore::search(double t, bool upper) const
+{
+    auto after = [t, upper](double x) { return upper ? x > t : x >= t; };
+
+    std::size_t lo = 0, hi = m_chunks.size();
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (after(m_chunks[mid].tLast)) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    if (lo == m_chunks.size()) {
+        // 未满块
+        auto it = upper ? std::upper_bound(m_pendingTime.begin(), m_pendingTime.end(), t)
+                        : std::lower_bound(m_pendingTime.begin(), m_pendingTime.end(), t);
+        return pendingFirst() + (it - m_pendingTime.begin());
+    }
+
+    const Chunk &chunk = m_chunks[lo];
+    const std::int64_t base = chunkStart(lo);
+    if (chunk.uniform) {
+        std::int64_t k = 0;
+        if (chunk.dt > 0.0) {
+            k = std::int64_t(std::ceil((t - chunk.tFirst) / chunk.dt));
+            k = std::max<std::int64_t>(0, std::min<std::int64_t>(k, chunk.count - 1));
+            // 浮点误差修正
+            while (k > 0 && after(chunk.tFirst + double(k - 1) * chunk.dt)) {
+                --k;
+            }
+            while (k < std::int64_t(chunk.count) - 1 && !after(chunk.tFirst + double(k) * chunk.dt)) {
+                ++k;
+            }
+        }
+        return base + k;
+    }
+
+    std::lock_guard<std::mutex> lock(m_cache->mutex);
+    const double *time = decoded(chunk, 0);
+    const double *it = upper ? std::upper_bound(time, time + chunk.count, t)
+                             : std::lower_bound(time, time + chunk.count, t);
+    return base + (it - time);
+}
+
+ColdStore::Summary ColdStore::summarize(Column column, std::int64_t begin, std::int64_t end) const
+{
+    Summary out;
+    begin = std::max<std::int64_t>(0, begin);
+    end = std::min(end, m_size);
+    const int col = int(column);
+
+    std::int64_t pos = begin;
+    while (pos < end) {
+        const std::size_t c = chunkIndex(pos);
+        if (c == m_chunks.size()) {
+            const std::int64_t base = pendingFirst();
+            scan(m_pending[col].data(), base, std::uint32_t(pos - base), std::uint32_t(end - base), out);
+            break;
+        }
+
+        const Chunk &chunk = m_chunks[c];
+        const std::int64_t base = chunkStart(c);
+        const std::uint32_t a = std::uint32_t(pos - base);
+        const std::uint32_t b = std::uint32_t(std::min<std::int64_t>(chunk.count, end - base));
+        if (a == 0 && b == chunk.count) {
+            // 整块：直接使用摘要
+            const ColumnSummary &s = chunk.summary[col];
+            Summary whole;
+            whole.min = s.min;
+            whole.max = s.max;
+            whole.sum = s.sum;
+            whole.sumSq = s.sumSq;
+            whole.count = chunk.count;
+            whole.minAt = base + s.minAt;
+            whole.maxAt = base + s.maxAt;
+            merge(out, whole);
+        } else {
+            std::lock_guard<std::mutex> lock(m_cache->mutex);
+            scan(decoded(chunk, col + 1), base, a, b, out);
+        }
+        pos = base + b;
+    }
+    return out;
+}
+
+void ColdStore::scan(const double *v, std::int64_t base, std::uint32_t a, std::uint32_t b, Summary &out)
+{
+    if (b <= a) {
+        return;
+    }
+    SpanReduction r;
+    reduceSpan(v + a, b - a, r);
+    Summary part;
+    part.min = r.min;
+    part.max = r.max;
+    part.sum = r.sum;
+    part.sumSq = r.sumSq;
+    part.count = std::int64_t(r.count);
+    part.minAt = base + a + std::int64_t(r.minAt);
+    part.maxAt = base + a + std::int64_t(r.maxAt);
+    merge(out, part);
+}
+
+/**
+ * @brief 合并两段汇总（src 在 dst 之后）；NaN 不参与比较，值相同时保留较早的位置
+ */
+void ColdStore::merge(Summary &dst, const Summary &src)
+{
+    if (src.count == 0) {
+        return;
+    }
+    if (dst.count == 0) {
+        dst = src;
+        return;
+    }
+    if (std::isnan(dst.min) || src.min < dst.min) {
+        dst.min = src.min;
+        dst.minAt = src.minAt;
+    }
+    if (std::isnan(dst.max) || src.max > dst.max) {
+        dst.max = src.max;
+        dst.maxAt = src.maxAt;
+    }
+    dst.sum += src.sum;
+    dst.sumSq += src.sumSq;
+    dst.count += src.count;
+}
+
+/**
+ * @brief 取块的解码结果：命中缓存直接返回，否则替换最久未用的缓存项
+ */
+const double *ColdStore::decoded(const Chunk &chunk, int stream) const
+{
+    Cache &cache = *m_cache;
+    CacheEntry *victim = &cache.entries[0];
+    for (CacheEntry &e : cache.entries) {
+        if (e.chunkFirst == chunk.first && e.stream == stream) {
+            e.stamp = ++cache.clock;
+            return e.values.data();
+        }
+        if (e.stamp < victim->stamp) {
+            victim = &e;
+        }
+    }
+    victim->chunkFirst = chunk.first;
+    victim->stream = stream;
+    victim->stamp = ++cache.clock;
+    victim->values.resize(chunk.count);
+    decodeStream(chunk, stream, victim->values.data());
+    return victim->values.data();
+}
+
+void ColdStore::decodeStream(const Chunk &chunk, int stream, double *out) const
+{
+    if (stream == 0) {
+        if (chunk.uniform) {
+            for (std::uint32_t k = 0; k < chunk.count; ++k) {
+                out[k] = chunk.tFirst + double(k) * chunk.dt;
+            }
+            return;
+        }
+        std::vector<std::int64_t> &ticks = m_cache->ticks;
+        ticks.resize(chunk.count);
+        BitReader r(chunk.bits.data(), chunk.offset[0]);
+        decodeTicks(r, chunk.count, ticks.data());
+        for (std::uint32_t k = 0; k < chunk.count; ++k) {
+            out[k] = chunk.tFirst + double(ticks[k]) * kTick;
+        }
+        return;
+    }
+
+    const int column = stream - 1;
+    if (chunk.codec[column] == ValueCodec::Product) {
+        std::vector<double> &current = m_cache->scratch;
+        current.resize(chunk.count);
+        decodeColumn(chunk, 0, out);
+        decodeColumn(chunk, 1, current.data());
+        for (std::uint32_t k = 0; k < chunk.count; ++k) {
+            out[k] *= current[k];
+        }
+        return;
+    }
+    decodeColumn(chunk, column, out);
+}
+
+void ColdStore::decodeColumn(const Chunk &chunk, int column, double *out) const
+{
+    BitReader r(chunk.bits.data(), chunk.offset[column + 1]);
+    if (chunk.codec[column] == ValueCodec::Scaled) {
+        decodeScaled(r, chunk.count, chunk.step[column], out);
+    } else {
+        decodeXor(r, chunk.count, out);
+    }
+}
+
+std::size_t ColdStore::memoryBytes() const
+{
+    std::size_t pending = m_pendingTime.capacity();
+    for (const std::vector<double> &column : m_pending) {
+        pending += column.capacity();
+    }
+    return m_bytes + m_chunks.size() * sizeof(Chunk) + pending * sizeof(double);
+}
+
+double ColdStore::compressionRatio() const
+{
+    const std::size_t compressed = m_bytes + m_chunks.size() * sizeof(Chunk);
+    if (compressed == 0) {
+        return 1.0;
+    }
+    const double raw = double(m_chunks.size()) * kChunkSamples * 4.0 * sizeof(double);
+    return raw / double(compressed);
+}
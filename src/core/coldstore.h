@@ -0,0 +1,166 @@
+#ifndef COLDSTORE_H
+#define COLDSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "retentionpolicy.h"
+
+/**
+ * @brief 单通道的冷数据：从热窗口（ChannelBuffer 的环形缓冲）淘汰的样点，分块压缩保存
+ *
+ * 每 kChunkSamples 个样点压缩为一块：时间戳均匀时只保存 t0/dt，否则按 1 ns 刻度
+ * 做 delta-of-delta；电压/电流/功率按策略做 XOR 或量化差分编码（见 SampleCodec），
+ * 功率恰为 V*I 时由解码后的电压电流重算。未满的块以原始数据暂存。
+ * 无损编码对带噪声的数据只有约 2.5 倍压缩率，按 ADC 步长量化后约 17~30 倍（见 ColdStoragePolicy）。
+ *
+ * 每块附带各列的 Min/Max/和/平方和摘要：整块落在查询区间内时直接使用摘要，
+ * 只有区间两端的块才解码（解码结果缓存最近用到的几块）。
+ *
+ * 样点按冷数据内的序号 [0, size()) 访问（0 为最旧），时间早于热窗口中的全部样点。
+ * 写入只在持有通道锁时进行；只读查询可在多个线程中并发（解码缓存自带锁）。
+ */
+class ColdStore
+{
+public:
+    enum class Column { Voltage, Current, Power };
+
+    /**
+     * @brief 区间汇总（字段含义同 MinMaxPyramid::Summary，位置为冷数据内序号）
+     */
+    struct Summary {
+        double min = 0.0;
+        double max = 0.0;
+        double sum = 0.0;
+        double sumSq = 0.0;
+        std::int64_t count = 0;
+        std::int64_t minAt = -1;
+        std::int64_t maxAt = -1;
+    };
+
+    static constexpr std::uint32_t kChunkSamples = 4096;
+
+    ColdStore() = default;
+    ColdStore(const ColdStore &other);
+    ColdStore &operator=(const ColdStore &other);
+
+    void setPolicy(const ColdStoragePolicy &policy);
+    const ColdStoragePolicy &policy() const { return m_policy; }
+    bool isEnabled() const { return m_policy.enabled; }
+
+    /**
+     * @brief 追加从热窗口淘汰的样点（时间不早于已保存的样点）
+     */
+    void append(const double *time, const double *voltage, const double *current,
+                const double *power, std::size_t count);
+    void clear();
+
+    std::int64_t size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    double firstTime() const { return timeAt(0); }
+    double lastTime() const { return timeAt(m_size - 1); }
+
+    // --- 样点（0 <= i < size()） ---
+    double timeAt(std::int64_t i) const;
+    double valueAt(Column column, std::int64_t i) const;
+
+    // --- 时间查找（语义同 TimeAxis） ---
+    std::int64_t lowerBound(double t) const;
+    std::int64_t upperBound(double t) const;
+    std::int64_t nearest(double t) const;
+
+    /**
+     * @brief 样点 [begin, end) 的汇总；整块用摘要，两端的块解码后扫描
+     */
+    Summary summarize(Column column, std::int64_t begin, std::int64_t end) const;
+
+    /**
+     * @brief 已占用的内存（字节，含未满块的原始数据）
+     */
+    std::size_t memoryBytes() const;
+
+    /**
+     * @brief 已压缩的块相对原始数据（每样点时间 + 三列共 4 个 double）的压缩率
+     */
+    double compressionRatio() const;
+
+private:
+    enum class ValueCodec : std::uint8_t { Xor, Scaled, Product };
+
+    struct ColumnSummary {
+        double min;
+        double max;
+        double sum;
+        double sumSq;
+        std::uint32_t minAt;        // 块内位置
+        std::uint32_t maxAt;
+    };
+
+    struct Chunk {
+        std::int64_t first = 0;     // 第一个样点的冷数据序号（绝对，clear() 前单调递增）
+        std::uint32_t count = 0;
+        bool uniform = false;       // 时间 = tFirst + k*dt
+        double tFirst = 0.0;
+        double tLast = 0.0;
+        double dt = 0.0;
+        ValueCodec codec[3] = {ValueCodec::Xor, ValueCodec::Xor, ValueCodec::Xor};
+        double step[3] = {0.0, 0.0, 0.0};          // 量化步长（ValueCodec::Scaled）
+        std::uint64_t offset[4] = {0, 0, 0, 0};    // 时间 / 电压 / 电流 / 功率位流的起始位
+        std::vector<std::uint64_t> bits;
+        ColumnSummary summary[3];
+
+        std::int64_t end() const { return first + count; }
+    };
+
+    // 解码缓存：最近解码的块列（stream 0 = 时间，1..3 = 电压/电流/功率）
+    struct CacheEntry {
+        std::int64_t chunkFirst = -1;
+        int stream = -1;
+        std::uint64_t stamp = 0;
+        std::vector<double> values;
+    };
+    struct Cache {
+        std::mutex mutex;
+        std::uint64_t clock = 0;
+        CacheEntry entries[6];
+        std::vector<std::int64_t> ticks;    // 时间解码的复用缓冲
+        std::vector<double> scratch;        // 功率重算的复用缓冲
+    };
+
+    void flushPending();
+    void enforceRetention();
+    void encodeChunk(Chunk &chunk);
+    void dropFront();
+    std::int64_t pendingFirst() const;                      // 未满块第一个样点的序号
+    std::size_t chunkIndex(std::int64_t i) const;           // 序号 i 所在块（== m_chunks.size() 表示未满块）
+    std::int64_t chunkStart(std::size_t c) const { return m_chunks[c].first - m_dropped; }
+    std::int64_t search(double t, bool upper) const;
+    double chunkTime(const Chunk &chunk, std::uint32_t k) const;
+    const double *decoded(const Chunk &chunk, int stream) const;   // 调用方持有 m_cache->mutex
+    void decodeStream(const Chunk &chunk, int stream, double *out) const;
+    void decodeColumn(const Chunk &chunk, int column, double *out) const;
+    double stepFor(int column) const;
+    static void scan(const double *v, std::int64_t base, std::uint32_t a, std::uint32_t b, Summary &out);
+    static void merge(Summary &dst, const Summary &src);
+
+    ColdStoragePolicy m_policy;
+    std::deque<Chunk> m_chunks;
+    std::int64_t m_dropped = 0;             // 因超出冷数据保留量丢弃的样点数（序号偏移）
+    std::int64_t m_size = 0;                // 保存的样点数（含未满块）
+    std::size_t m_bytes = 0;                // 各块位流的内存
+
+    // 未满块（原始数据）
+    std::vector<double> m_pendingTime;
+    std::vector<double> m_pending[3];
+
+    // 编码用的复用缓冲
+    std::vector<std::int64_t> m_ticks;
+    std::vector<double> m_recon[3];
+
+    std::unique_ptr<Cache> m_cache{new Cache};
+};
+
+#endif // COLDSTORE_H
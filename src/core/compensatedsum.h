@@ -0,0 +1,29 @@
+#ifndef COMPENSATEDSUM_H
+#define COMPENSATEDSUM_H
+
+#include <cmath>
+
+/**
+ * @brief 补偿求和的累加器（Kahan-Babuška / Neumaier）：真实值约为 hi + lo
+ *
+ * 每次加法舍入掉的部分累计到 lo，长时间累加大量小增量时误差不随次数增长。
+ */
+struct CompensatedSum {
+    double hi = 0.0;
+    double lo = 0.0;
+
+    void add(double x)
+    {
+        const double t = hi + x;
+        if (std::fabs(hi) >= std::fabs(x)) {
+            lo += (hi - t) + x;
+        } else {
+            lo += (x - t) + hi;
+        }
+        hi = t;
+    }
+
+    double value() const { return hi + lo; }
+};
+
+#endif // COMPENSATEDSUM_H
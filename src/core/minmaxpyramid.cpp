@@ -0,0 +1,215 @@
+#include "minmaxpyramid.h"
+#include "reducekernels.h"
+
+#include <algorithm>
+
+namespace {
+constexpr std::size_t kMinBuckets = 16;     // 每层首次分配的最小桶数
+
+// 将一段汇总（绝对序号）并入结果；按时间顺序调用，相等时保留较早的位置
+void accumulate(MinMaxPyramid::Summary &out, double mn, std::int64_t mnAt,
+                double mx, std::int64_t mxAt, double sum, std::int64_t count)
+{
+    if (out.count == 0) {
+        out.min = mn; out.minAt = mnAt;
+        out.max = mx; out.maxAt = mxAt;
+    } else {
+        if (mn < out.min) { out.min = mn; out.minAt = mnAt; }
+        if (mx > out.max) { out.max = mx; out.maxAt = mxAt; }
+    }
+    out.sum += sum;
+    out.count += count;
+}
+}
+
+void MinMaxPyramid::reset(std::int64_t firstIndex)
+{
+    m_end = firstIndex;
+    for (Level &lv : m_levels) {
+        lv.ring.clear();
+        lv.lo = lv.hi = 0;
+        lv.pendingFrom = -1;
+    }
+}
+
+void MinMaxPyramid::merge(Bucket &dst, const Bucket &src)
+{
+    if (src.min < dst.min) { dst.min = src.min; dst.minAt = src.minAt; }
+    if (src.max > dst.max) { dst.max = src.max; dst.maxAt = src.maxAt; }
+    dst.sum += src.sum;
+}
+
+void MinMaxPyramid::append(const double *values, std::size_t n)
+{
+    Level &lv = m_levels[0];
+    const std::int64_t size = bucketSize(0);
+    std::size_t i = 0;
+    while (i < n) {
+        // 每次归约到下一个第 0 层桶边界为止
+        const std::size_t room = std::size_t(size - (m_end & (size - 1)));
+        const std::size_t chunk = std::min(room, n - i);
+        SpanReduction r;
+        reduceSpan(values + i, chunk, r);
+        const std::int64_t a = m_end;
+        if (lv.pendingFrom < 0) {
+            lv.pendingFrom = a;
+            lv.pending = Bucket{r.min, r.max, r.sum, a + std::int64_t(r.minAt), a + std::int64_t(r.maxAt)};
+        } else {
+            merge(lv.pending, Bucket{r.min, r.max, r.sum, a + std::int64_t(r.minAt), a + std::int64_t(r.maxAt)});
+        }
+        m_end += std::int64_t(chunk);
+        i += chunk;
+        if ((m_end & (size - 1)) == 0) {
+            complete(0, m_end - size);
+        }
+    }
+}
+
+/**
+ * @brief 第 level 层的桶累积结束：完整则保存并并入上一层，再检查上一层是否也到了边界
+ * 重建后的第一个桶可能缺少起始部分，这种桶不保存，上一层对应的桶也随之作废。
+ */
+void MinMaxPyramid::complete(int level, std::int64_t start)
+{
+    Level &lv = m_levels[level];
+    const bool valid = (lv.pendingFrom == start);
+    const std::int64_t size = bucketSize(level);
+    if (valid) {
+        store(level, start / size, lv.pending);
+    }
+    lv.pendingFrom = -1;
+
+    if (level + 1 >= kLevels) {
+        return;
+    }
+    Level &up = m_levels[level + 1];
+    if (valid) {
+        if (up.pendingFrom < 0) {
+            up.pendingFrom = start;
+            up.pending = lv.pending;
+        } else {
+            merge(up.pending, lv.pending);
+        }
+    }
+    const std::int64_t upSize = bucketSize(level + 1);
+    if (((start + size) & (upSize - 1)) == 0) {
+        complete(level + 1, start + size - upSize);
+    }
+}
+
+/**
+ * @brief 保存桶号 k 的完整桶；预热阶段倍增扩容，达到上限后覆盖最旧的桶
+ */
+void MinMaxPyramid::store(int level, std::int64_t k, const Bucket &b)
+{
+    Level &lv = m_levels[level];
+    if (lv.hi == lv.lo) {
+        lv.lo = lv.hi = k;
+    }
+
+    const std::size_t cap = lv.ring.size();
+    if (std::size_t(lv.hi - lv.lo) >= cap) {
+        const std::size_t limit = (m_rawLimit > 0)
+            ? std::size_t(m_rawLimit / bucketSize(level) + 2) : 0;
+        if (limit == 0 || cap < limit) {
+            std::size_t newCap = std::max(cap * 2, kMinBuckets);
+            if (limit != 0) {
+                newCap = std::min(newCap, limit);
+            }
+            std::vector<Bucket> ring(newCap);
+            for (std::int64_t j = lv.lo; j < lv.hi; ++j) {
+                ring[std::size_t(j % std::int64_t(newCap))] = bucket(level, j);
+            }
+            lv.ring.swap(ring);
+        } else {
+            ++lv.lo;    // 覆盖最旧的桶
+        }
+    }
+    lv.ring[std::size_t(k % std::int64_t(lv.ring.size()))] = b;
+    lv.hi = k + 1;
+}
+
+MinMaxPyramid::Summary MinMaxPyramid::summarize(const SampleRing &raw, std::int64_t rawFirst,
+                                                std::int64_t begin, std::int64_t end) const
+{
+    Summary out;
+    const std::int64_t a = rawFirst + begin;
+    const std::int64_t b = std::min(rawFirst + end, m_end);
+    if (a >= b) {
+        return out;
+    }
+
+    // 从桶大小不超过区间长度的最高层开始
+    int level = -1;
+    while (level + 1 < kLevels && bucketSize(level + 1) <= b - a) {
+        ++level;
+    }
+    collect(level, a, b, raw, rawFirst, out);
+
+    if (out.count > 0) {
+        out.minAt -= rawFirst;
+        out.maxAt -= rawFirst;
+    }
+    return out;
+}
+
+/**
+ * @brief 汇总绝对区间 [a, b)：中间用第 level 层整桶，两端递归到下一层（level < 0 时扫描原始数据）
+ */
+void MinMaxPyramid::collect(int level, std::int64_t a, std::int64_t b,
+                            const SampleRing &raw, std::int64_t rawFirst, Summary &out) const
+{
+    if (a >= b) {
+        return;
+    }
+    if (level < 0) {
+        scanRaw(raw, rawFirst, a, b, out);
+        return;
+    }
+
+    const Level &lv = m_levels[level];
+    const std::int64_t size = bucketSize(level);
+    const std::int64_t k0 = std::max((a + size - 1) / size, lv.lo);  // 第一个完整落在区间内的桶
+    const std::int64_t k1 = std::min(b / size, lv.hi);               // 最后一个完整桶 + 1
+    if (k0 >= k1) {
+        collect(level - 1, a, b, raw, rawFirst, out);
+        return;
+    }
+
+    collect(level - 1, a, k0 * size, raw, rawFirst, out);
+    for (std::int64_t k = k0; k < k1; ++k) {
+        const Bucket &bk = bucket(level, k);
+        accumulate(out, bk.min, bk.minAt, bk.max, bk.maxAt, bk.sum, size);
+    }
+    collect(level - 1, k1 * size, b, raw, rawFirst, out);
+}
+
+void MinMaxPyramid::scanRaw(const SampleRing &raw, std::int64_t rawFirst,
+                            std::int64_t a, std::int64_t b, Summary &out)
+{
+    SampleRing::Span parts[2];
+    const int n = raw.spans(std::size_t(a - rawFirst), std::size_t(b - rawFirst), parts);
+    std::int64_t pos = a;
+    for (int k = 0; k < n; ++k) {
+        SpanReduction r;
+        reduceSpan(parts[k].data, parts[k].size, r);
+        accumulate(out, r.min, pos + std::int64_t(r.minAt), r.max, pos + std::int64_t(r.maxAt),
+                   r.sum, std::int64_t(parts[k].size));
+        pos += std::int64_t(parts[k].size);
+    }
+}
+
+std::size_t MinMaxPyramid::memoryBytes() const
+{
+    std::size_t bytes = 0;
+    for (const Level &lv : m_levels) {
+        bytes += lv.ring.capacity() * sizeof(Bucket);
+    }
+    return bytes;
+}
+
+double MinMaxPyramid::bytesPerSample()
+{
+    // 各层桶数构成公比 1/8 的等比数列，总和约为第 0 层的 8/7
+    return double(sizeof(Bucket)) / double(bucketSize(0)) * 8.0 / 7.0;
+}
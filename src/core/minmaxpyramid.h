@@ -0,0 +1,118 @@
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "samplering.h"
+
+/**
+ * @brief 单列数据的多分辨率 Min/Max 金字塔
+ *
+ * 第 0 层每个桶汇总 64 个连续样点（最小值/最大值及其位置、累加和），
+ * 往上每层把 8 个下层桶合并为 1 个，共 kLevels 层。桶按绝对样点序号对齐，
+ * 追加数据时只更新各层正在累积的桶，均摊 O(1)。
+ *
+ * 查询任意区间 [begin, end) 时，从不超过区间长度的最高层开始，用整桶覆盖中间部分，
+ * 两端不足一个桶的部分逐层向下细分，最底层直接扫描原始数据。单次查询代价为
+ * O(层数 * 8 + 2 * 64)，与区间长度无关；按像素列逐列查询时，
+ * 降采样的总代价只与屏幕宽度成正比。
+ *
+ * 只保存完整的桶；容量上限与原始数据环形缓冲一致，过期的桶随之被覆盖。
+ */
+class MinMaxPyramid
+{
+public:
+    /**
+     * @brief 区间汇总结果
+     */
+    struct Summary {
+        double min = 0.0;
+        double max = 0.0;
+        double sum = 0.0;
+        std::int64_t count = 0;
+        std::int64_t minAt = -1;    // 最小值所在的逻辑索引（多个时取最早）
+        std::int64_t maxAt = -1;    // 最大值所在的逻辑索引（多个时取最早）
+    };
+
+    static constexpr int kLevels = 7;           // 层数（桶大小 64 .. 64 * 8^6）
+    static constexpr int kBaseShift = 6;        // 第 0 层桶大小 = 2^6
+    static constexpr int kFanoutShift = 3;      // 每层合并 2^3 个下层桶
+
+    MinMaxPyramid() = default;
+
+    /**
+     * @brief 设置原始数据的容量上限（样点数，0 表示无上限），各层桶数随之限定
+     * 需随后调用 reset() 重建。
+     */
+    void setCapacityLimit(std::int64_t rawLimit) { m_rawLimit = rawLimit; }
+
+    /**
+     * @brief 清空，并从绝对序号 firstIndex 开始重新累积
+     */
+    void reset(std::int64_t firstIndex = 0);
+
+    /**
+     * @brief 追加 n 个样点（绝对序号紧接上一次追加）
+     */
+    void append(const double *values, std::size_t n);
+
+    /**
+     * @brief 汇总逻辑区间 [begin, end) 的数据
+     * @param raw 原始数据列（逻辑索引 0 对应绝对序号 rawFirst）
+     * @param rawFirst 原始数据最旧样点的绝对序号
+     */
+    Summary summarize(const SampleRing &raw, std::int64_t rawFirst,
+                      std::int64_t begin, std::int64_t end) const;
+
+    /**
+     * @brief 已分配的内存（字节）
+     */
+    std::size_t memoryBytes() const;
+
+    /**
+     * @brief 金字塔平摊到每个原始样点的内存（字节），用于按内存换算保留量
+     */
+    static double bytesPerSample();
+
+private:
+    struct Bucket {
+        double min;
+        double max;
+        double sum;
+        std::int64_t minAt;         // 绝对序号
+        std::int64_t maxAt;         // 绝对序号
+    };
+
+    struct Level {
+        std::vector<Bucket> ring;   // 按桶号取模存放
+        std::int64_t lo = 0;        // 保存的第一个桶号
+        std::int64_t hi = 0;        // 保存的最后一个桶号 + 1
+        Bucket pending;             // 正在累积的桶
+        std::int64_t pendingFrom = -1; // 正在累积的桶的起始绝对序号（-1 表示空）
+    };
+
+    static std::int64_t bucketSize(int level)
+    {
+        return std::int64_t(1) << (kBaseShift + kFanoutShift * level);
+    }
+    static void merge(Bucket &dst, const Bucket &src);
+
+    void complete(int level, std::int64_t start);               // 第 level 层起点为 start 的桶累积结束
+    void store(int level, std::int64_t k, const Bucket &b);      // 保存完整的桶
+    const Bucket &bucket(int level, std::int64_t k) const
+    {
+        const Level &lv = m_levels[level];
+        return lv.ring[std::size_t(k % std::int64_t(lv.ring.size()))];
+    }
+    void collect(int level, std::int64_t a, std::int64_t b,
+                 const SampleRing &raw, std::int64_t rawFirst, Summary &out) const;
+    static void scanRaw(const SampleRing &raw, std::int64_t rawFirst,
+                        std::int64_t a, std::int64_t b, Summary &out);
+
+    std::int64_t m_rawLimit = 0;    // 原始数据容量上限（0 = 无上限）
+    std::int64_t m_end = 0;         // 下一个样点的绝对序号
+    Level m_levels[kLevels];
+};
+
+#endif // MINMAXPYRAMID_H
@@ -0,0 +1,127 @@
+#include "prefixsums.h"
+#include "reducekernels.h"
+
+#include <algorithm>
+
+namespace {
+constexpr std::size_t kMinEntries = 16;     // 首次分配的最小前缀值个数
+}
+
+void PrefixSums::reset(std::int64_t firstIndex)
+{
+    m_end = firstIndex;
+    m_running = Entry();
+    m_pendingSum = m_pendingSumSq = 0.0;
+    m_ring.clear();
+    m_lo = m_hi = 0;
+    if ((firstIndex & (kBlockSize - 1)) == 0) {
+        store(firstIndex >> kBlockShift);   // 起点恰好在块边界上：前缀值为 0
+    }
+}
+
+void PrefixSums::append(const double *values, std::size_t n)
+{
+    std::size_t i = 0;
+    while (i < n) {
+        // 每次归约到下一个块边界为止
+        const std::size_t room = std::size_t(kBlockSize - (m_end & (kBlockSize - 1)));
+        const std::size_t chunk = std::min(room, n - i);
+        SpanReduction r;
+        reduceSpan(values + i, chunk, r);
+        m_pendingSum += r.sum;
+        m_pendingSumSq += r.sumSq;
+        m_end += std::int64_t(chunk);
+        i += chunk;
+
+        if ((m_end & (kBlockSize - 1)) == 0) {
+            m_running.sum.add(m_pendingSum);
+            m_running.sumSq.add(m_pendingSumSq);
+            m_pendingSum = m_pendingSumSq = 0.0;
+            store(m_end >> kBlockShift);
+        }
+    }
+}
+
+/**
+ * @brief 保存块边界 k 的前缀值；预热阶段倍增扩容，达到上限后覆盖最旧的值
+ */
+void PrefixSums::store(std::int64_t k)
+{
+    if (m_hi == m_lo) {
+        m_lo = m_hi = k;
+    }
+
+    const std::size_t cap = m_ring.size();
+    if (std::size_t(m_hi - m_lo) >= cap) {
+        const std::size_t limit = (m_rawLimit > 0) ? std::size_t(m_rawLimit / kBlockSize + 2) : 0;
+        if (limit == 0 || cap < limit) {
+            std::size_t newCap = std::max(cap * 2, kMinEntries);
+            if (limit != 0) {
+                newCap = std::min(newCap, limit);
+            }
+            std::vector<Entry> ring(newCap);
+            for (std::int64_t j = m_lo; j < m_hi; ++j) {
+                ring[std::size_t(j % std::int64_t(newCap))] = *entry(j);
+            }
+            m_ring.swap(ring);
+        } else {
+            ++m_lo;     // 覆盖最旧的值
+        }
+    }
+    m_ring[std::size_t(k % std::int64_t(m_ring.size()))] = m_running;
+    m_hi = k + 1;
+}
+
+const PrefixSums::Entry *PrefixSums::entry(std::int64_t k) const
+{
+    if (k < m_lo || k >= m_hi) {
+        return nullptr;
+    }
+    return &m_ring[std::size_t(k % std::int64_t(m_ring.size()))];
+}
+
+PrefixSums::Moments PrefixSums::moments(const SampleRing &raw, std::int64_t rawFirst,
+                                        std::int64_t begin, std::int64_t end) const
+{
+    Moments out;
+    const std::int64_t a = rawFirst + begin;
+    const std::int64_t b = std::min(rawFirst + end, m_end);
+    if (a >= b) {
+        return out;
+    }
+
+    // 区间内第一个和最后一个块边界
+    const std::int64_t ka = (a + kBlockSize - 1) >> kBlockShift;
+    const std::int64_t kb = b >> kBlockShift;
+    const Entry *ea = entry(ka);
+    const Entry *eb = entry(kb);
+    if (ka >= kb || !ea || !eb) {
+        scanRaw(raw, rawFirst, a, b, out);   // 不足一整块（或前缀值不可用）：直接扫描
+        return out;
+    }
+
+    // 主值、补偿值分别相减，避免两个很大的前缀值相减时丢失精度
+    out.sum = (eb->sum.hi - ea->sum.hi) + (eb->sum.lo - ea->sum.lo);
+    out.sumSq = (eb->sumSq.hi - ea->sumSq.hi) + (eb->sumSq.lo - ea->sumSq.lo);
+    out.count = (kb - ka) << kBlockShift;
+    scanRaw(raw, rawFirst, a, ka << kBlockShift, out);
+    scanRaw(raw, rawFirst, kb << kBlockShift, b, out);
+    return out;
+}
+
+void PrefixSums::scanRaw(const SampleRing &raw, std::int64_t rawFirst,
+                         std::int64_t a, std::int64_t b, Moments &out)
+{
+    if (a >= b) {
+        return;
+    }
+    SampleRing::Span parts[2];
+    const int n = raw.spans(std::size_t(a - rawFirst), std::size_t(b - rawFirst), parts);
+    for (int k = 0; k < n; ++k) {
+        SpanReduction r;
+        reduceSpan(parts[k].data, parts[k].size, r);
+        out.sum += r.sum;
+        out.sumSq += r.sumSq;
+        out.count += std::int64_t(r.count);
+    }
+}
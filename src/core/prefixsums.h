@@ -0,0 +1,98 @@
+#ifndef PREFIXSUMS_H
+#define PREFIXSUMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "samplering.h"
+#include "compensatedsum.h"
+
+/**
+ * @brief 单列数据的分块前缀和（累加和 / 平方和），用于 O(1) 区间统计
+ *
+ * 每 64 个样点（按绝对序号对齐）保存一次从起点开始的累加和与平方和。累加采用
+ * Neumaier 补偿求和，每个前缀值保存为“主值 + 补偿值”两部分，相减时分别相减，
+ * 长时间采集后前缀值很大时区间和也不会因抵消而丢失精度。
+ *
+ * 查询任意区间 [begin, end) 时，中间的整块部分由两个前缀值相减得到，两端不足一块的部分
+ * 用 SIMD 归约扫描原始数据（每端最多 63 个样点），代价与区间长度无关。
+ *
+ * 容量上限与原始数据环形缓冲一致，过期的前缀值随之被覆盖。
+ */
+class PrefixSums
+{
+public:
+    /**
+     * @brief 区间的累加和与平方和
+     */
+    struct Moments {
+        double sum = 0.0;
+        double sumSq = 0.0;
+        std::int64_t count = 0;
+    };
+
+    static constexpr int kBlockShift = 6;       // 每块 2^6 = 64 个样点
+
+    PrefixSums() = default;
+
+    /**
+     * @brief 设置原始数据的容量上限（样点数，0 表示无上限）；需随后调用 reset() 重建
+     */
+    void setCapacityLimit(std::int64_t rawLimit) { m_rawLimit = rawLimit; }
+
+    /**
+     * @brief 清空，并从绝对序号 firstIndex 开始重新累积
+     */
+    void reset(std::int64_t firstIndex = 0);
+
+    /**
+     * @brief 追加 n 个样点（绝对序号紧接上一次追加）
+     */
+    void append(const double *values, std::size_t n);
+
+    /**
+     * @brief 汇总逻辑区间 [begin, end)
+     * @param raw 原始数据列（逻辑索引 0 对应绝对序号 rawFirst）
+     * @param rawFirst 原始数据最旧样点的绝对序号
+     */
+    Moments moments(const SampleRing &raw, std::int64_t rawFirst,
+                    std::int64_t begin, std::int64_t end) const;
+
+    /**
+     * @brief 已分配的内存（字节）
+     */
+    std::size_t memoryBytes() const { return m_ring.capacity() * sizeof(Entry); }
+
+    /**
+     * @brief 平摊到每个原始样点的内存（字节），用于按内存换算保留量
+     */
+    static double bytesPerSample() { return double(sizeof(Entry)) / double(kBlockSize); }
+
+private:
+    static constexpr std::int64_t kBlockSize = std::int64_t(1) << kBlockShift;
+
+    /**
+     * @brief 块边界处的前缀值（起点到该边界之前所有样点）
+     */
+    struct Entry {
+        CompensatedSum sum;
+        CompensatedSum sumSq;
+    };
+
+    void store(std::int64_t k);                     // 保存第 k 个块边界的前缀值
+    const Entry *entry(std::int64_t k) const;       // 已过期或尚未产生时返回 nullptr
+    static void scanRaw(const SampleRing &raw, std::int64_t rawFirst,
+                        std::int64_t a, std::int64_t b, Moments &out);
+
+    std::int64_t m_rawLimit = 0;    // 原始数据容量上限（0 = 无上限）
+    std::int64_t m_end = 0;         // 下一个样点的绝对序号
+    Entry m_running;                // 起点到 m_end 之前所有整块的累计
+    double m_pendingSum = 0.0;      // 当前未满块的累加和
+    double m_pendingSumSq = 0.0;    // 当前未满块的平方和
+
+    std::vector<Entry> m_ring;      // 按块边界号取模存放
+    std::int64_t m_lo = 0;          // 保存的第一个块边界号
+    std::int64_t m_hi = 0;          // 保存的最后一个块边界号 + 1
+};
+
+#endif // PREFIXSUMS_H
@@ -0,0 +1,315 @@
+#include "reducekernels.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POWERDAQ_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2 / AVX-512 内核只在 GCC/Clang 下编译（按函数指定 target，运行时检测 CPU 后选用）。
+// Windows（MinGW / Cygwin）上 GCC 无法把栈对齐到 16 字节以上（GCC PR 54412），
+// 寄存器溢出到栈上的 __m256d / __m512d 会用对齐访存指令读写而崩溃，因此只用 SSE2。
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+    && !defined(_WIN32) && !defined(__CYGWIN__)
+#define POWERDAQ_HAVE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief 标量实现（同时用作各 SIMD 实现的尾部处理）
+ * 从 start 开始继续累积到 out 上；严格小于/大于才更新位置，保证取最早出现的极值。
+ */
+void reduceTail(const double *v, std::size_t start, std::size_t n, SpanReduction &out)
+{
+    double mn = out.min, mx = out.max, s = out.sum, sq = out.sumSq;
+    std::size_t mnAt = out.minAt, mxAt = out.maxAt;
+    for (std::size_t i = start; i < n; ++i) {
+        const double x = v[i];
+        if (x < mn) { mn = x; mnAt = i; }
+        if (x > mx) { mx = x; mxAt = i; }
+        s += x;
+        sq += x * x;
+    }
+    out.min = mn; out.max = mx; out.sum = s; out.sumSq = sq;
+    out.minAt = mnAt; out.maxAt = mxAt;
+    out.count = n;
+}
+
+/**
+ * @brief 以第一个非 NaN 样点作为最值初值（NaN 与任何值比较都为假，作初值会卡住最值）
+ * @return 初值样点的位置（全部为 NaN 时为 0，最值保持 NaN）
+ */
+std::size_t initReduction(const double *v, std::size_t n, SpanReduction &out)
+{
+    std::size_t first = 0;
+    while (first < n && v[first] != v[first]) {
+        ++first;
+    }
+    if (first == n) {
+        first = 0;
+    }
+    out.min = out.max = v[first];
+    out.minAt = out.maxAt = first;
+    out.sum = out.sumSq = 0.0;
+    return first;
+}
+
+/**
+ * @brief 合并各 SIMD 通道的局部结果：值更小（大）者优先，值相等时取较早的位置
+ */
+void mergeLanes(const double *mins, const double *minIdx,
+                const double *maxs, const double *maxIdx,
+                const double *sums, const double *sqs, int lanes, SpanReduction &out)
+{
+    for (int l = 0; l < lanes; ++l) {
+        const std::size_t mi = std::size_t(minIdx[l]);
+        if (mins[l] < out.min || (mins[l] == out.min && mi < out.minAt)) {
+            out.min = mins[l];
+            out.minAt = mi;
+        }
+        const std::size_t xi = std::size_t(maxIdx[l]);
+        if (maxs[l] > out.max || (maxs[l] == out.max && xi < out.maxAt)) {
+            out.max = maxs[l];
+            out.maxAt = xi;
+        }
+        out.sum += sums[l];
+        out.sumSq += sqs[l];
+    }
+}
+
+void reduceScalar(const double *v, std::size_t n, SpanReduction &out)
+{
+    initReduction(v, n, out);
+    reduceTail(v, 0, n, out);
+}
+
+#ifdef POWERDAQ_HAVE_SSE2
+// SSE2 没有 blendv，用 and/andnot/or 按掩码选择
+inline __m128d select(__m128d mask, __m128d a, __m128d b)
+{
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+void reduceSse2(const double *v, std::size_t n, SpanReduction &out)
+{
+    const std::size_t first = initReduction(v, n, out);
+    __m128d vmin = _mm_set1_pd(out.min), vmax = vmin;
+    __m128d vminI = _mm_set1_pd(double(first)), vmaxI = vminI;
+    __m128d vsum = _mm_setzero_pd(), vsq = vsum;
+    __m128d idx = _mm_set_pd(1.0, 0.0);
+    const __m128d step = _mm_set1_pd(2.0);
+
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d x = _mm_loadu_pd(v + i);
+        const __m128d lt = _mm_cmplt_pd(x, vmin);
+        const __m128d gt = _mm_cmpgt_pd(x, vmax);
+        vmin = select(lt, x, vmin);
+        vminI = select(lt, idx, vminI);
+        vmax = select(gt, x, vmax);
+        vmaxI = select(gt, idx, vmaxI);
+        vsum = _mm_add_pd(vsum, x);
+        vsq = _mm_add_pd(vsq, _mm_mul_pd(x, x));
+        idx = _mm_add_pd(idx, step);
+    }
+
+    double mins[2], minIdx[2], maxs[2], maxIdx[2], sums[2], sqs[2];
+    _mm_storeu_pd(mins, vmin); _mm_storeu_pd(minIdx, vminI);
+    _mm_storeu_pd(maxs, vmax); _mm_storeu_pd(maxIdx, vmaxI);
+    _mm_storeu_pd(sums, vsum); _mm_storeu_pd(sqs, vsq);
+    mergeLanes(mins, minIdx, maxs, maxIdx, sums, sqs, 2, out);
+    reduceTail(v, i, n, out);
+}
+#endif
+
+#ifdef POWERDAQ_HAVE_X86_DISPATCH
+// 一组 SIMD 累加器（各通道的最值、位置、和、平方和，以及下一个向量的样点序号）
+struct Avx2Acc {
+    __m256d min, max, minI, maxI, sum, sq, idx;
+};
+
+__attribute__((target("avx2"), always_inline))
+inline void avx2Init(Avx2Acc &a, double first, std::size_t firstAt, double base)
+{
+    a.min = a.max = _mm256_set1_pd(first);
+    a.minI = a.maxI = _mm256_set1_pd(double(firstAt));
+    a.sum = a.sq = _mm256_setzero_pd();
+    a.idx = _mm256_set_pd(base + 3.0, base + 2.0, base + 1.0, base);
+}
+
+__attribute__((target("avx2"), always_inline))
+inline void avx2Step(Avx2Acc &a, const double *p, __m256d step)
+{
+    const __m256d x = _mm256_loadu_pd(p);
+    const __m256d lt = _mm256_cmp_pd(x, a.min, _CMP_LT_OQ);
+    const __m256d gt = _mm256_cmp_pd(x, a.max, _CMP_GT_OQ);
+    a.min = _mm256_blendv_pd(a.min, x, lt);
+    a.minI = _mm256_blendv_pd(a.minI, a.idx, lt);
+    a.max = _mm256_blendv_pd(a.max, x, gt);
+    a.maxI = _mm256_blendv_pd(a.maxI, a.idx, gt);
+    a.sum = _mm256_add_pd(a.sum, x);
+    a.sq = _mm256_add_pd(a.sq, _mm256_mul_pd(x, x));
+    a.idx = _mm256_add_pd(a.idx, step);
+}
+
+__attribute__((target("avx2"), always_inline))
+inline void avx2Store(const Avx2Acc &a, double *mins, double *minIdx, double *maxs,
+                      double *maxIdx, double *sums, double *sqs)
+{
+    _mm256_storeu_pd(mins, a.min); _mm256_storeu_pd(minIdx, a.minI);
+    _mm256_storeu_pd(maxs, a.max); _mm256_storeu_pd(maxIdx, a.maxI);
+    _mm256_storeu_pd(sums, a.sum); _mm256_storeu_pd(sqs, a.sq);
+}
+
+// 两组独立累加器交替处理相邻向量，缩短比较-混合的依赖链
+__attribute__((target("avx2")))
+void reduceAvx2(const double *v, std::size_t n, SpanReduction &out)
+{
+    const std::size_t first = initReduction(v, n, out);
+    Avx2Acc a0, a1;
+    avx2Init(a0, out.min, first, 0.0);
+    avx2Init(a1, out.min, first, 4.0);
+    const __m256d step = _mm256_set1_pd(8.0);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        avx2Step(a0, v + i, step);
+        avx2Step(a1, v + i + 4, step);
+    }
+
+    double mins[8], minIdx[8], maxs[8], maxIdx[8], sums[8], sqs[8];
+    avx2Store(a0, mins, minIdx, maxs, maxIdx, sums, sqs);
+    avx2Store(a1, mins + 4, minIdx + 4, maxs + 4, maxIdx + 4, sums + 4, sqs + 4);
+    mergeLanes(mins, minIdx, maxs, maxIdx, sums, sqs, 8, out);
+    reduceTail(v, i, n, out);
+}
+
+struct Avx512Acc {
+    __m512d min, max, minI, maxI, sum, sq, idx;
+};
+
+__attribute__((target("avx512f"), always_inline))
+inline void avx512Init(Avx512Acc &a, double first, std::size_t firstAt, double base)
+{
+    a.min = a.max = _mm512_set1_pd(first);
+    a.minI = a.maxI = _mm512_set1_pd(double(firstAt));
+    a.sum = a.sq = _mm512_setzero_pd();
+    a.idx = _mm512_add_pd(_mm512_set1_pd(base),
+                          _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0));
+}
+
+__attribute__((target("avx512f"), always_inline))
+inline void avx512Step(Avx512Acc &a, const double *p, __m512d step)
+{
+    const __m512d x = _mm512_loadu_pd(p);
+    const __mmask8 lt = _mm512_cmp_pd_mask(x, a.min, _CMP_LT_OQ);
+    const __mmask8 gt = _mm512_cmp_pd_mask(x, a.max, _CMP_GT_OQ);
+    a.min = _mm512_mask_blend_pd(lt, a.min, x);
+    a.minI = _mm512_mask_blend_pd(lt, a.minI, a.idx);
+    a.max = _mm512_mask_blend_pd(gt, a.max, x);
+    a.maxI = _mm512_mask_blend_pd(gt, a.maxI, a.idx);
+    a.sum = _mm512_add_pd(a.sum, x);
+    a.sq = _mm512_add_pd(a.sq, _mm512_mul_pd(x, x));
+    a.idx = _mm512_add_pd(a.idx, step);
+}
+
+__attribute__((target("avx512f"), always_inline))
+inline void avx512Store(const Avx512Acc &a, double *mins, double *minIdx, double *maxs,
+                        double *maxIdx, double *sums, double *sqs)
+{
+    _mm512_storeu_pd(mins, a.min); _mm512_storeu_pd(minIdx, a.minI);
+    _mm512_storeu_pd(maxs, a.max); _mm512_storeu_pd(maxIdx, a.maxI);
+    _mm512_storeu_pd(sums, a.sum); _mm512_storeu_pd(sqs, a.sq);
+}
+
+__attribute__((target("avx512f")))
+void reduceAvx512(const double *v, std::size_t n, SpanReduction &out)
+{
+    const std::size_t first = initReduction(v, n, out);
+    Avx512Acc a0, a1;
+    avx512Init(a0, out.min, first, 0.0);
+    avx512Init(a1, out.min, first, 8.0);
+    const __m512d step = _mm512_set1_pd(16.0);
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        avx512Step(a0, v + i, step);
+        avx512Step(a1, v + i + 8, step);
+    }
+
+    double mins[16], minIdx[16], maxs[16], maxIdx[16], sums[16], sqs[16];
+    avx512Store(a0, mins, minIdx, maxs, maxIdx, sums, sqs);
+    avx512Store(a1, mins + 8, minIdx + 8, maxs + 8, maxIdx + 8, sums + 8, sqs + 8);
+    mergeLanes(mins, minIdx, maxs, maxIdx, sums, sqs, 16, out);
+    reduceTail(v, i, n, out);
+}
+#endif
+
+using ReduceFn = void (*)(const double *, std::size_t, SpanReduction &);
+
+struct Kernel {
+    ReduceFn fn;
+    const char *name;
+};
+
+/**
+ * @brief 按 CPU 能力选择实现；环境变量 POWERDAQ_SIMD 可限制最高级别（用于对比测试）
+ */
+Kernel selectKernel()
+{
+    const char *cap = std::getenv("POWERDAQ_SIMD");
+    auto allowed = [cap](const char *name) {
+        if (!cap) {
+            return true;
+        }
+        static const char *const order[] = {"scalar", "sse2", "avx2", "avx512"};
+        int capLevel = 3, level = 0;
+        for (int k = 0; k < 4; ++k) {
+            if (std::strcmp(cap, order[k]) == 0) capLevel = k;
+            if (std::strcmp(name, order[k]) == 0) level = k;
+        }
+        return level <= capLevel;
+    };
+
+#ifdef POWERDAQ_HAVE_X86_DISPATCH
+    __builtin_cpu_init();
+    if (allowed("avx512") && __builtin_cpu_supports("avx512f")) {
+        return Kernel{reduceAvx512, "avx512"};
+    }
+    if (allowed("avx2") && __builtin_cpu_supports("avx2")) {
+        return Kernel{reduceAvx2, "avx2"};
+    }
+#endif
+#ifdef POWERDAQ_HAVE_SSE2
+    if (allowed("sse2")) {
+        return Kernel{reduceSse2, "sse2"};
+    }
+#endif
+    return Kernel{reduceScalar, "scalar"};
+}
+
+const Kernel &activeKernel()
+{
+    static const Kernel kernel = selectKernel();
+    return kernel;
+}
+
+} // namespace
+
+void reduceSpan(const double *v, std::size_t n, SpanReduction &out)
+{
+    if (n == 0) {
+        out = SpanReduction();
+        return;
+    }
+    activeKernel().fn(v, n, out);
+}
+
+const char *reduceKernelName()
+{
+    return activeKernel().name;
+}
@@ -0,0 +1,34 @@
+#ifndef REDUCEKERNELS_H
+#define REDUCEKERNELS_H
+
+#include <cstddef>
+
+/**
+ * @brief 连续内存段的归约结果
+ * minAt/maxAt 为段内索引，多个相同极值时取最早出现的位置；
+ * NaN 不参与比较（全部为 NaN 时 min/max 为 NaN，位置为 0）。
+ */
+struct SpanReduction {
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;
+    double sumSq = 0.0;         // 平方和（用于 RMS）
+    std::size_t minAt = 0;
+    std::size_t maxAt = 0;
+    std::size_t count = 0;
+};
+
+/**
+ * @brief 计算 v[0, n) 的 min/argmin/max/argmax/sum/sum-of-squares
+ *
+ * 首次调用时按 CPU 能力选择实现：AVX-512 > AVX2 > SSE2 > 标量（Windows 上最高为 SSE2），
+ * 之后所有调用直接走选定的实现。n == 0 时返回 count = 0。
+ */
+void reduceSpan(const double *v, std::size_t n, SpanReduction &out);
+
+/**
+ * @brief 当前使用的归约实现名称（"avx512" / "avx2" / "sse2" / "scalar"）
+ */
+const char *reduceKernelName();
+
+#endif // REDUCEKERNELS_H
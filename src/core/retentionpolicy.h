@@ -0,0 +1,72 @@
+#ifndef RETENTIONPOLICY_H
+#define RETENTIONPOLICY_H
+
+#include <cstdint>
+
+/**
+ * @brief 通道数据保留策略
+ * 按样点数、时长（秒）或内存（字节）限制单个通道保留的原始数据量，超出后丢弃最旧的数据。
+ */
+struct RetentionPolicy {
+    enum class Unit {
+        Unlimited,  // 不限制（长时间采集会持续占用内存）
+        Samples,    // 样点数
+        Seconds,    // 时长（按采样周期换算成样点数）
+        Bytes,      // 内存（按每样点占用换算成样点数）
+    };
+
+    Unit unit = Unit::Bytes;
+    double value = 128.0 * 1024 * 1024;   // 默认每通道约 128 MiB
+
+    static RetentionPolicy unlimited() { return make(Unit::Unlimited, 0.0); }
+    static RetentionPolicy samples(std::int64_t n) { return make(Unit::Samples, double(n)); }
+    static RetentionPolicy seconds(double s) { return make(Unit::Seconds, s); }
+    static RetentionPolicy bytes(double b) { return make(Unit::Bytes, b); }
+
+private:
+    static RetentionPolicy make(Unit u, double v)
+    {
+        RetentionPolicy p;
+        p.unit = u;
+        p.value = v;
+        return p;
+    }
+};
+
+/**
+ * @brief 冷数据策略：超出原始数据保留量（热窗口）的样点是否压缩保存、保存多少
+ *
+ * retention 限制压缩后的数据量（Bytes 按压缩后的实际内存计）。
+ * 各列的量化步长为 0 时无损压缩（XOR 编码）；大于 0 时按步长量化（误差不超过半个步长），
+ * 平稳信号可获得高得多的压缩率，步长通常取 ADC 的分辨率。
+ *
+ * 压缩率（100 万个带噪声的合成样点实测）：lossless() 约 2.5 倍，低于 5~20 倍的目标，
+ * 因为噪声使浮点尾数几乎不可压缩；quantized() 按 ADC 步长量化后约 17~30 倍。
+ * 默认不量化是因为步长取决于具体硬件，已知 ADC 分辨率时应使用 quantized()。
+ */
+struct ColdStoragePolicy {
+    bool enabled = false;
+    RetentionPolicy retention = RetentionPolicy::bytes(64.0 * 1024 * 1024);
+    double voltageStep = 0.0;   // 电压量化步长（V）
+    double currentStep = 0.0;   // 电流量化步长（A）
+    double powerStep = 0.0;     // 功率量化步长（W）；功率恰为 V*I 时不单独保存
+
+    static ColdStoragePolicy disabled() { return ColdStoragePolicy(); }
+    static ColdStoragePolicy lossless(const RetentionPolicy &retention)
+    {
+        return quantized(retention, 0.0, 0.0, 0.0);
+    }
+    static ColdStoragePolicy quantized(const RetentionPolicy &retention,
+                                       double voltageStep, double currentStep, double powerStep)
+    {
+        ColdStoragePolicy p;
+        p.enabled = true;
+        p.retention = retention;
+        p.voltageStep = voltageStep;
+        p.currentStep = currentStep;
+        p.powerStep = powerStep;
+        return p;
+    }
+};
+
+#endif // RETENTIONPOLICY_H
@@ -0,0 +1,286 @@
+#include "samplecodec.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace SampleCodec {
+
+namespace {
+
+std::uint64_t toBits(double v)
+{
+    std::uint64_t u;
+    std::memcpy(&u, &v, sizeof(u));
+    return u;
+}
+
+double fromBits(std::uint64_t u)
+{
+    double v;
+    std::memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+// x != 0
+int leadingZeros(std::uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanReverse64(&i, x);
+    return 63 - int(i);
+#else
+    int n = 0;
+    while (!(x & (std::uint64_t(1) << 63))) { x <<= 1; ++n; }
+    return n;
+#endif
+}
+
+// x != 0
+int trailingZeros(std::uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return int(i);
+#else
+    int n = 0;
+    while (!(x & 1u)) { x >>= 1; ++n; }
+    return n;
+#endif
+}
+
+std::uint64_t zigzag(std::int64_t v)
+{
+    return (std::uint64_t(v) << 1) ^ std::uint64_t(v >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t z)
+{
+    return std::int64_t(z >> 1) ^ -std::int64_t(z & 1u);
+}
+
+// 量化后的整数上限（差分不溢出）
+constexpr double kMaxScaled = 4.0e18;
+
+} // namespace
+
+void BitWriter::write(std::uint64_t value, int bits)
+{
+    if (bits <= 0) {
+        return;
+    }
+    if (bits < 64) {
+        value &= (std::uint64_t(1) << bits) - 1;
+    }
+    const int used = int(m_bits & 63);
+    if (used == 0) {
+        m_out.push_back(0);
+    }
+    const int free = 64 - used;
+    if (bits <= free) {
+        m_out.back() |= value << (free - bits);
+    } else {
+        const int rest = bits - free;
+        m_out.back() |= value >> rest;
+        m_out.push_back(value << (64 - rest));
+    }
+    m_bits += std::uint64_t(bits);
+}
+
+std::uint64_t BitReader::read(int bits)
+{
+    if (bits <= 0) {
+        return 0;
+    }
+    const std::uint64_t *w = m_words + (m_pos >> 6);
+    const int off = int(m_pos & 63);
+    const int avail = 64 - off;
+    m_pos += std::uint64_t(bits);
+    if (bits <= avail) {
+        return (w[0] << off) >> (64 - bits);
+    }
+    const int rest = bits - avail;
+    const std::uint64_t high = w[0] & ((std::uint64_t(1) << avail) - 1);
+    return (high << rest) | (w[1] >> (64 - rest));
+}
+
+/**
+ * @brief 有符号整数：zigzag 后按大小分档（0 / 6 / 13 / 20 / 64 位）
+ */
+void writeSigned(BitWriter &w, std::int64_t v)
+{
+    const std::uint64_t z = zigzag(v);
+    if (z == 0) {
+        w.write(0x0, 1);
+    } else if (z < (std::uint64_t(1) << 6)) {
+        w.write(0x2, 2);
+        w.write(z, 6);
+    } else if (z < (std::uint64_t(1) << 13)) {
+        w.write(0x6, 3);
+        w.write(z, 13);
+    } else if (z < (std::uint64_t(1) << 20)) {
+        w.write(0xE, 4);
+        w.write(z, 20);
+    } else {
+        w.write(0xF, 4);
+        w.write(z, 64);
+    }
+}
+
+std::int64_t readSigned(BitReader &r)
+{
+    if (!r.readBit()) {
+        return 0;
+    }
+    if (!r.readBit()) {
+        return unzigzag(r.read(6));
+    }
+    if (!r.readBit()) {
+        return unzigzag(r.read(13));
+    }
+    if (!r.readBit()) {
+        return unzigzag(r.read(20));
+    }
+    return unzigzag(r.read(64));
+}
+
+void encodeTicks(const std::int64_t *ticks, std::size_t n, BitWriter &w)
+{
+    if (n == 0) {
+        return;
+    }
+    w.write(std::uint64_t(ticks[0]), 64);
+    std::int64_t prevDelta = 0;
+    for (std::size_t k = 1; k < n; ++k) {
+        const std::int64_t delta = ticks[k] - ticks[k - 1];
+        writeSigned(w, delta - prevDelta);
+        prevDelta = delta;
+    }
+}
+
+void decodeTicks(BitReader &r, std::size_t n, std::int64_t *out)
+{
+    if (n == 0) {
+        return;
+    }
+    out[0] = std::int64_t(r.read(64));
+    std::int64_t delta = 0;
+    for (std::size_t k = 1; k < n; ++k) {
+        delta += readSigned(r);
+        out[k] = out[k - 1] + delta;
+    }
+}
+
+/**
+ * @brief XOR 编码：与前值相同写 '0'；有效位落在上一个窗口内写 '10' + 窗口内的位，
+ * 否则写 '11' + 前导零个数（6 位）+ 有效位数 - 1（6 位）+ 有效位
+ */
+void encodeXor(const double *v, std::size_t n, BitWriter &w)
+{
+    if (n == 0) {
+        return;
+    }
+    std::uint64_t prev = toBits(v[0]);
+    w.write(prev, 64);
+    int prevLead = -1;
+    int prevTrail = 0;
+    for (std::size_t k = 1; k < n; ++k) {
+        const std::uint64_t cur = toBits(v[k]);
+        const std::uint64_t x = cur ^ prev;
+        prev = cur;
+        if (x == 0) {
+            w.write(0x0, 1);
+            continue;
+        }
+        const int lead = leadingZeros(x);
+        const int trail = trailingZeros(x);
+        if (prevLead >= 0 && lead >= prevLead && trail >= prevTrail) {
+            w.write(0x2, 2);
+            w.write(x >> prevTrail, 64 - prevLead - prevTrail);
+        } else {
+            const int len = 64 - lead - trail;
+            w.write(0x3, 2);
+            w.write(std::uint64_t(lead), 6);
+            w.write(std::uint64_t(len - 1), 6);
+            w.write(x >> trail, len);
+            prevLead = lead;
+            prevTrail = trail;
+        }
+    }
+}
+
+void decodeXor(BitReader &r, std::size_t n, double *out)
+{
+    if (n == 0) {
+        return;
+    }
+    std::uint64_t prev = r.read(64);
+    out[0] = fromBits(prev);
+    int lead = 0;
+    int trail = 0;
+    for (std::size_t k = 1; k < n; ++k) {
+        if (r.readBit()) {
+            if (r.readBit()) {
+                lead = int(r.read(6));
+                const int len = int(r.read(6)) + 1;
+                trail = 64 - lead - len;
+            }
+            prev ^= r.read(64 - lead - trail) << trail;
+        }
+        out[k] = fromBits(prev);
+    }
+}
+
+/**
+ * @brief 量化差分编码：第一个整数写 64 位，之后写相邻整数之差
+ */
+bool encodeScaled(const double *v, std::size_t n, double step, BitWriter &w, double *recon)
+{
+    if (!(step > 0.0)) {
+        return false;
+    }
+    const double inv = 1.0 / step;
+    for (std::size_t k = 0; k < n; ++k) {
+        const double q = v[k] * inv;
+        if (!(std::fabs(q) < kMaxScaled)) {     // 同时排除 NaN / Inf
+            return false;
+        }
+    }
+    std::int64_t prev = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::int64_t q = std::llround(v[k] * inv);
+        if (k == 0) {
+            w.write(std::uint64_t(q), 64);
+        } else {
+            writeSigned(w, q - prev);
+        }
+        prev = q;
+        if (recon) {
+            recon[k] = double(q) * step;
+        }
+    }
+    return true;
+}
+
+void decodeScaled(BitReader &r, std::size_t n, double step, double *out)
+{
+    if (n == 0) {
+        return;
+    }
+    std::int64_t q = std::int64_t(r.read(64));
+    out[0] = double(q) * step;
+    for (std::size_t k = 1; k < n; ++k) {
+        q += readSigned(r);
+        out[k] = double(q) * step;
+    }
+}
+
+} // namespace SampleCodec
@@ -0,0 +1,75 @@
+#ifndef SAMPLECODEC_H
+#define SAMPLECODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 冷数据压缩用的位流编码（ColdStore 的块内编码）
+ *
+ * - 时间戳：delta-of-delta，均匀采样时每个样点 1 bit；
+ * - 数值（无损）：Gorilla 式 XOR 编码，与前一个值相同时 1 bit，相近时只保存有效位；
+ * - 数值（量化）：按步长换算为整数后做差分，平稳信号（空闲时的电源电流）每个样点 1~10 bit。
+ *
+ * 位流按 64 位字存放，写入/读取都是顺序的，每个块从头解码。
+ */
+namespace SampleCodec {
+
+/**
+ * @brief 顺序写入位流（高位在前）
+ */
+class BitWriter
+{
+public:
+    explicit BitWriter(std::vector<std::uint64_t> &out) : m_out(out) {}
+
+    void write(std::uint64_t value, int bits);      // 写入 value 的低 bits 位（0 <= bits <= 64）
+    void writeBit(bool bit) { write(bit ? 1u : 0u, 1); }
+    std::uint64_t bitCount() const { return m_bits; }
+
+private:
+    std::vector<std::uint64_t> &m_out;
+    std::uint64_t m_bits = 0;                       // 已写入的位数
+};
+
+/**
+ * @brief 顺序读取位流
+ */
+class BitReader
+{
+public:
+    BitReader(const std::uint64_t *words, std::uint64_t bitOffset = 0)
+        : m_words(words), m_pos(bitOffset) {}
+
+    std::uint64_t read(int bits);
+    bool readBit() { return read(1) != 0; }
+
+private:
+    const std::uint64_t *m_words;
+    std::uint64_t m_pos;
+};
+
+// --- 有符号整数（差分、delta-of-delta）：0 占 1 bit，越接近 0 越短 ---
+void writeSigned(BitWriter &w, std::int64_t v);
+std::int64_t readSigned(BitReader &r);
+
+// --- 时间刻度（整数）的 delta-of-delta ---
+void encodeTicks(const std::int64_t *ticks, std::size_t n, BitWriter &w);
+void decodeTicks(BitReader &r, std::size_t n, std::int64_t *out);
+
+// --- 数值：XOR（无损） ---
+void encodeXor(const double *v, std::size_t n, BitWriter &w);
+void decodeXor(BitReader &r, std::size_t n, double *out);
+
+/**
+ * @brief 数值：按步长量化为整数后差分编码
+ * @param recon 可为 nullptr；输出解码后将得到的值（q * step），用于计算块摘要
+ * @return 存在 NaN/Inf 或超出整数范围的样点时返回 false（不写入任何内容）
+ */
+bool encodeScaled(const double *v, std::size_t n, double step, BitWriter &w, double *recon);
+void decodeScaled(BitReader &r, std::size_t n, double step, double *out);
+
+} // namespace SampleCodec
+
+#endif // SAMPLECODEC_H
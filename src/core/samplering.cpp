@@ -0,0 +1,116 @@
+#include "samplering.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr std::size_t kMinCapacity = 1024;  // 首次分配的最小容量
+}
+
+void SampleRing::setCapacityLimit(std::size_t limit)
+{
+    m_limit = limit;
+    if (m_limit == 0) {
+        return;
+    }
+    if (m_size > m_limit) {
+        // 丢弃最旧的样点
+        const std::size_t drop = m_size - m_limit;
+        m_head = (m_head + drop) % std::max<std::size_t>(1, m_buf.size());
+        m_size = m_limit;
+    }
+    if (m_buf.size() > m_limit) {
+        reallocate(m_limit);
+    }
+}
+
+/**
+ * @brief 重新分配物理存储，并把保留样点线性化到新缓冲区开头
+ */
+void SampleRing::reallocate(std::size_t newCapacity)
+{
+    std::vector<double> buf(newCapacity);
+    Span parts[2];
+    const int n = spans(0, m_size, parts);
+    std::size_t off = 0;
+    for (int k = 0; k < n; ++k) {
+        std::memcpy(buf.data() + off, parts[k].data, parts[k].size * sizeof(double));
+        off += parts[k].size;
+    }
+    m_buf.swap(buf);
+    m_head = 0;
+}
+
+std::size_t SampleRing::append(const double *src, std::size_t n)
+{
+    if (n == 0) {
+        return 0;
+    }
+
+    // 预热阶段：倍增扩容直到容量上限
+    if (m_size + n > m_buf.size() && (m_limit == 0 || m_buf.size() < m_limit)) {
+        std::size_t cap = std::max(std::max(m_buf.size() * 2, m_size + n), kMinCapacity);
+        if (m_limit != 0) {
+            cap = std::min(cap, m_limit);
+        }
+        reallocate(cap);
+    }
+
+    const std::size_t cap = m_buf.size();
+    std::size_t evicted = 0;
+
+    // 单次写入超过整个环：只保留最新的 cap 个样点
+    if (n >= cap) {
+        evicted = m_size + (n - cap);
+        std::memcpy(m_buf.data(), src + (n - cap), cap * sizeof(double));
+        m_head = 0;
+        m_size = cap;
+        return evicted;
+    }
+
+    // 写入尾部（可能跨越回绕点，拆成两次拷贝）
+    std::size_t tail = m_head + m_size;
+    if (tail >= cap) tail -= cap;
+    const std::size_t first = std::min(n, cap - tail);
+    std::memcpy(m_buf.data() + tail, src, first * sizeof(double));
+    if (first < n) {
+        std::memcpy(m_buf.data(), src + first, (n - first) * sizeof(double));
+    }
+
+    m_size += n;
+    if (m_size > cap) {
+        // 覆盖最旧的样点
+        evicted = m_size - cap;
+        m_head += evicted;
+        if (m_head >= cap) m_head -= cap;
+        m_size = cap;
+    }
+    return evicted;
+}
+
+void SampleRing::clear()
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+int SampleRing::spans(std::size_t begin, std::size_t end, Span out[2]) const
+{
+    end = std::min(end, m_size);
+    if (begin >= end) {
+        return 0;
+    }
+    const std::size_t cap = m_buf.size();
+    std::size_t p = m_head + begin;
+    if (p >= cap) p -= cap;
+    const std::size_t n = end - begin;
+    const std::size_t first = std::min(n, cap - p);
+    out[0].data = m_buf.data() + p;
+    out[0].size = first;
+    if (first == n) {
+        return 1;
+    }
+    out[1].data = m_buf.data();
+    out[1].size = n - first;
+    return 2;
+}
@@ -0,0 +1,76 @@
+#ifndef SAMPLERING_H
+#define SAMPLERING_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 定长环形样点列（double）
+ *
+ * - 容量上限为 0 时无上限，按倍增方式扩容（与 QVector 行为一致）；
+ * - 设置容量上限后，预热阶段按倍增扩容直到上限，之后覆盖最旧的样点，
+ *   追加为 O(1) 且不再发生任何内存重分配；
+ * - 逻辑索引 0 始终是最旧的保留样点，跨越回绕点的区间通过 spans() 拆成至多两段连续内存。
+ */
+class SampleRing
+{
+public:
+    /**
+     * @brief 一段连续内存
+     */
+    struct Span {
+        const double *data;
+        std::size_t size;
+    };
+
+    SampleRing() = default;
+
+    /**
+     * @brief 设置容量上限（样点数，0 表示无上限）；缩小时丢弃最旧的样点
+     */
+    void setCapacityLimit(std::size_t limit);
+    std::size_t capacityLimit() const { return m_limit; }
+
+    /**
+     * @brief 追加 n 个样点，返回因容量上限被覆盖（丢弃）的最旧样点数
+     */
+    std::size_t append(const double *src, std::size_t n);
+
+    void clear();
+
+    std::size_t size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    /**
+     * @brief 第 i 个保留样点（0 为最旧）
+     */
+    double operator[](std::size_t i) const
+    {
+        std::size_t p = m_head + i;
+        if (p >= m_buf.size()) p -= m_buf.size();
+        return m_buf[p];
+    }
+    double last() const { return (*this)[m_size - 1]; }
+
+    /**
+     * @brief 将逻辑区间 [begin, end) 拆成连续内存段
+     * @param out 输出数组（至少 2 个元素）
+     * @return 段数（0、1 或 2）
+     */
+    int spans(std::size_t begin, std::size_t end, Span out[2]) const;
+
+    /**
+     * @brief 已分配的内存（字节）
+     */
+    std::size_t memoryBytes() const { return m_buf.capacity() * sizeof(double); }
+
+private:
+    void reallocate(std::size_t newCapacity);
+
+    std::vector<double> m_buf;      // 物理存储（size() 即当前环容量）
+    std::size_t m_head = 0;         // 最旧样点的物理位置
+    std::size_t m_size = 0;         // 保留样点数
+    std::size_t m_limit = 0;        // 容量上限（0 = 无上限）
+};
+
+#endif // SAMPLERING_H
@@ -0,0 +1,338 @@
+#include "timeaxis.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 时间戳与时基推算值的允许偏差（相对于采样周期）
+constexpr double kRelTolerance = 1e-3;
+}
+
+/**
+ * @brief 追加一段均匀采样
+ * 与当前时基周期一致时只更新样点数（必要时新增一个间隙分段），否则转为显式模式。
+ */
+void TimeAxis::appendUniform(double t0, double dt, std::int64_t count)
+{
+    if (count <= 0 || !(dt > 0.0)) {
+        return;
+    }
+
+    if (m_mode == Mode::Empty) {
+        m_mode = Mode::Uniform;
+        m_dt = dt;
+        m_dtKnown = true;
+        m_segments.push_back(Segment{end(), t0});
+        m_size = count;
+        enforceLimit();
+        return;
+    }
+
+    if (m_mode == Mode::Uniform) {
+        // 逐点写入只有 1 个样点时周期未知：以本块周期为准
+        if (!m_dtKnown) {
+            m_dt = dt;
+            m_dtKnown = true;
+        }
+
+        if (std::abs(dt - m_dt) <= m_dt * 1e-9) {
+            const Segment &seg = m_segments.back();
+            const double expected = seg.t0 + double(end() - seg.start) * m_dt;
+            const double tol = m_dt * kRelTolerance;
+            if (std::abs(t0 - expected) <= tol) {
+                m_size += count;
+                enforceLimit();
+                return;
+            }
+            if (t0 > expected && m_segments.size() < kMaxSegments) {
+                m_segments.push_back(Segment{end(), t0});
+                m_size += count;
+                enforceLimit();
+                return;
+            }
+        }
+        toExplicit();
+    }
+
+    // 显式模式：逐点展开（分批，避免大块时一次性申请临时内存）
+    double buf[256];
+    for (std::int64_t k = 0; k < count; ) {
+        const std::int64_t n = std::min<std::int64_t>(256, count - k);
+        for (std::int64_t j = 0; j < n; ++j) {
+            buf[j] = t0 + double(k + j) * dt;
+        }
+        appendExplicit(buf, n);
+        k += n;
+    }
+}
+
+/**
+ * @brief 追加一段逐点时间戳
+ */
+void TimeAxis::appendExplicit(const double *time, std::int64_t count)
+{
+    if (!time || count <= 0) {
+        return;
+    }
+    if (m_mode == Mode::Explicit) {
+        const std::int64_t before = m_size;
+        m_time.append(time, std::size_t(count));
+        m_size = std::int64_t(m_time.size());
+        m_first += before + count - m_size;   // 环已满时被覆盖的样点
+        return;
+    }
+    for (std::int64_t k = 0; k < count; ++k) {
+        appendOne(time[k]);
+    }
+}
+
+/**
+ * @brief 追加单个时间戳（均匀模式下校验是否落在时基上）
+ */
+void TimeAxis::appendOne(double t)
+{
+    switch (m_mode) {
+    case Mode::Empty:
+        m_mode = Mode::Uniform;
+        m_dtKnown = false;
+        m_segments.push_back(Segment{end(), t});
+        m_size = 1;
+        return;
+
+    case Mode::Uniform: {
+        if (!m_dtKnown) {
+            // 第二个样点确定采样周期
+            const double d = t - m_segments.front().t0;
+            if (d > 0.0) {
+                m_dt = d;
+                m_dtKnown = true;
+                ++m_size;
+                enforceLimit();
+                return;
+            }
+            break;
+        }
+        const Segment &seg = m_segments.back();
+        const double expected = seg.t0 + double(end() - seg.start) * m_dt;
+        const double tol = m_dt * kRelTolerance;
+        if (std::abs(t - expected) <= tol) {
+            ++m_size;
+            enforceLimit();
+            return;
+        }
+        if (t > expected && m_segments.size() < kMaxSegments) {
+            // 采集中断：记录一个间隙分段
+            m_segments.push_back(Segment{end(), t});
+            ++m_size;
+            enforceLimit();
+            return;
+        }
+        break;
+    }
+
+    case Mode::Explicit:
+        appendExplicit(&t, 1);
+        return;
+    }
+
+    // 无法用时基表达：转为显式模式后写入
+    toExplicit();
+    appendExplicit(&t, 1);
+}
+
+/**
+ * @brief 均匀模式 -> 显式模式（按时基展开已保留样点的时间戳）
+ */
+void TimeAxis::toExplicit()
+{
+    if (m_mode == Mode::Explicit) {
+        return;
+    }
+    std::vector<double> times(static_cast<std::size_t>(m_size));
+    for (std::int64_t i = 0; i < m_size; ++i) {
+        times[std::size_t(i)] = at(i);
+    }
+    m_time.clear();
+    m_time.setCapacityLimit(std::size_t(m_limit));
+    m_time.append(times.data(), times.size());
+    m_segments.clear();
+    m_segments.shrink_to_fit();
+    m_mode = Mode::Explicit;
+}
+
+/**
+ * @brief 均匀模式下超出容量上限时前移起点，并移除已完全过期的分段
+ */
+void TimeAxis::enforceLimit()
+{
+    if (m_limit <= 0 || m_size <= m_limit) {
+        return;
+    }
+    m_first += m_size - m_limit;
+    m_size = m_limit;
+
+    std::size_t expired = 0;
+    while (expired + 1 < m_segments.size() && m_segments[expired + 1].start <= m_first) {
+        ++expired;
+    }
+    if (expired > 0) {
+        m_segments.erase(m_segments.begin(), m_segments.begin() + std::ptrdiff_t(expired));
+    }
+}
+
+void TimeAxis::setCapacityLimit(std::int64_t limit)
+{
+    m_limit = std::max<std::int64_t>(0, limit);
+    m_time.setCapacityLimit(std::size_t(m_limit));
+    if (m_mode == Mode::Explicit) {
+        const std::int64_t after = std::int64_t(m_time.size());
+        m_first += m_size - after;
+        m_size = after;
+    } else {
+        enforceLimit();
+    }
+}
+
+void TimeAxis::clear()
+{
+    m_mode = Mode::Empty;
+    m_first = 0;
+    m_size = 0;
+    m_dt = 0.0;
+    m_dtKnown = false;
+    m_segments.clear();
+    m_time.clear();
+}
+
+std::size_t TimeAxis::segmentFor(std::int64_t a) const
+{
+    if (m_segments.size() == 1) {
+        return 0;
+    }
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), a,
+                               [](std::int64_t v, const Segment &s) { return v < s.start; });
+    return (it == m_segments.begin()) ? 0 : std::size_t(it - m_segments.begin()) - 1;
+}
+
+std::size_t TimeAxis::segmentForTime(double t) const
+{
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), t,
+                               [](double v, const Segment &s) { return v < s.t0; });
+    if (it == m_segments.begin()) {
+        return std::size_t(-1);
+    }
+    return std::size_t(it - m_segments.begin()) - 1;
+}
+
+std::int64_t TimeAxis::segmentEnd(std::size_t s) const
+{
+    return (s + 1 < m_segments.size()) ? m_segments[s + 1].start : end();
+}
+
+double TimeAxis::at(std::int64_t i) const
+{
+    if (m_mode == Mode::Explicit) {
+        return m_time[std::size_t(i)];
+    }
+    const std::int64_t a = m_first + i;
+    const Segment &seg = m_segments[segmentFor(a)];
+    return seg.t0 + double(a - seg.start) * m_dt;
+}
+
+/**
+ * @brief 显式模式下在环形时间列上二分查找（逻辑索引）
+ */
+std::int64_t TimeAxis::explicitLowerBound(double t, bool upper) const
+{
+    std::int64_t lo = 0, hi = m_size;
+    while (lo < hi) {
+        const std::int64_t mid = lo + (hi - lo) / 2;
+        const double v = m_time[std::size_t(mid)];
+        if (upper ? (v <= t) : (v < t)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+std::int64_t TimeAxis::lowerBound(double t) const
+{
+    if (m_size == 0) {
+        return 0;
+    }
+    if (m_mode == Mode::Explicit) {
+        return explicitLowerBound(t, false);
+    }
+
+    const std::size_t s = segmentForTime(t);
+    if (s == std::size_t(-1)) {
+        return 0;   // 早于第一个样点
+    }
+    const Segment &seg = m_segments[s];
+    const std::int64_t begin = std::max(seg.start, m_first);
+    const std::int64_t stop = segmentEnd(s);
+    if (!m_dtKnown) {
+        return ((t <= seg.t0) ? begin : stop) - m_first;
+    }
+
+    // 分段内索引运算，再用相邻样点修正浮点舍入
+    const double k = std::ceil((t - seg.t0) / m_dt);
+    std::int64_t a = (k >= double(stop - seg.start)) ? stop : seg.start + std::int64_t(std::max(0.0, k));
+    a = std::max(a, begin);
+    while (a > begin && seg.t0 + double(a - 1 - seg.start) * m_dt >= t) --a;
+    while (a < stop && seg.t0 + double(a - seg.start) * m_dt < t) ++a;
+    return a - m_first;
+}
+
+std::int64_t TimeAxis::upperBound(double t) const
+{
+    if (m_size == 0) {
+        return 0;
+    }
+    if (m_mode == Mode::Explicit) {
+        return explicitLowerBound(t, true);
+    }
+
+    const std::size_t s = segmentForTime(t);
+    if (s == std::size_t(-1)) {
+        return 0;
+    }
+    const Segment &seg = m_segments[s];
+    const std::int64_t begin = std::max(seg.start, m_first);
+    const std::int64_t stop = segmentEnd(s);
+    if (!m_dtKnown) {
+        return ((t < seg.t0) ? begin : stop) - m_first;
+    }
+
+    const double k = std::floor((t - seg.t0) / m_dt) + 1.0;
+    std::int64_t a = (k >= double(stop - seg.start)) ? stop : seg.start + std::int64_t(std::max(0.0, k));
+    a = std::max(a, begin);
+    while (a > begin && seg.t0 + double(a - 1 - seg.start) * m_dt > t) --a;
+    while (a < stop && seg.t0 + double(a - seg.start) * m_dt <= t) ++a;
+    return a - m_first;
+}
+
+std::int64_t TimeAxis::nearest(double t) const
+{
+    if (m_size == 0) {
+        return -1;
+    }
+    std::int64_t idx = lowerBound(t);
+    if (idx >= m_size) {
+        idx = m_size - 1;
+    }
+    // 比较当前点和前一个点，选择距离更近的
+    if (idx > 0 && std::abs(at(idx - 1) - t) < std::abs(at(idx) - t)) {
+        --idx;
+    }
+    return idx;
+}
+
+std::size_t TimeAxis::memoryBytes() const
+{
+    return sizeof(*this)
+         + m_segments.capacity() * sizeof(Segment)
+         + m_time.memoryBytes();
+}
@@ -0,0 +1,118 @@
+#ifndef TIMEAXIS_H
+#define TIMEAXIS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "samplering.h"
+
+/**
+ * @brief 单通道时间轴
+ *
+ * DAQ 通道通常是均匀采样的，没有必要为每个样点保存 8 字节时间戳。
+ * TimeAxis 优先使用“均匀时基”模式：只保存采样周期 dt 和若干分段起点
+ * （起始索引 + 起始时间），分段用于记录采集中断造成的时间跳变（稀疏间隙表）。
+ * 样点时间按需推导：t(i) = seg.t0 + (i - seg.start) * dt，
+ * 时间 -> 索引的查找退化为分段内的 O(1) 索引运算。
+ *
+ * 当输入时间戳不满足均匀条件（回退、周期变化、间隙过多）时，自动转换为
+ * “显式时间戳”模式，逐点保存时间，查找使用二分法，功能不受影响。
+ *
+ * 支持容量上限（与通道数据环形缓冲一致）：超出时丢弃最旧的样点。内部使用
+ * 绝对样点序号记录分段，丢弃样点只需前移起点，不搬移数据。
+ */
+class TimeAxis
+{
+public:
+    enum class Mode {
+        Empty,      // 尚无数据
+        Uniform,    // 均匀时基（t0 + k*dt，带稀疏间隙表）
+        Explicit,   // 逐点时间戳
+    };
+
+    TimeAxis() = default;
+
+    // --- 写入 ---
+    /**
+     * @brief 追加一段均匀采样：t0 + k*dt, k = 0..count-1
+     */
+    void appendUniform(double t0, double dt, std::int64_t count);
+
+    /**
+     * @brief 追加一段逐点时间戳（单调不减）
+     * 若时间戳与当前时基吻合则不单独保存；出现跳变时记录间隙；无法用时基表达时转为显式模式。
+     */
+    void appendExplicit(const double *time, std::int64_t count);
+
+    void clear();
+
+    /**
+     * @brief 设置保留样点数上限（0 表示无上限），超出部分丢弃最旧样点
+     */
+    void setCapacityLimit(std::int64_t limit);
+
+    // --- 查询 ---
+    Mode mode() const { return m_mode; }
+    bool isUniform() const { return m_mode == Mode::Uniform; }
+    bool isEmpty() const { return m_size == 0; }
+    std::int64_t size() const { return m_size; }
+    std::int64_t firstIndex() const { return m_first; }   // 最旧保留样点的绝对序号
+    double samplePeriod() const { return m_dt; }        // 均匀模式下的采样周期
+    std::size_t gapCount() const { return m_segments.empty() ? 0 : m_segments.size() - 1; }
+
+    /**
+     * @brief 第 i 个样点的时间（0 <= i < size()）
+     */
+    double at(std::int64_t i) const;
+    double first() const { return at(0); }
+    double last() const { return at(m_size - 1); }
+
+    /**
+     * @brief 第一个时间 >= t 的样点索引（不存在时返回 size()）
+     */
+    std::int64_t lowerBound(double t) const;
+
+    /**
+     * @brief 第一个时间 > t 的样点索引（不存在时返回 size()）
+     */
+    std::int64_t upperBound(double t) const;
+
+    /**
+     * @brief 与 t 最接近的样点索引（无数据时返回 -1）
+     */
+    std::int64_t nearest(double t) const;
+
+    /**
+     * @brief 时间轴占用的内存（字节）
+     */
+    std::size_t memoryBytes() const;
+
+private:
+    // 均匀时基的一个分段：从绝对序号 start 开始，时间为 t0 + (a - start) * dt
+    struct Segment {
+        std::int64_t start;
+        double t0;
+    };
+
+    void appendOne(double t);
+    void toExplicit();
+    void enforceLimit();                                   // 超出容量上限时丢弃最旧样点
+    std::size_t segmentFor(std::int64_t a) const;          // 绝对序号 a 所在分段
+    std::size_t segmentForTime(double t) const;            // 最后一个 t0 <= t 的分段（无则返回 size_t(-1)）
+    std::int64_t segmentEnd(std::size_t s) const;          // 分段结束的绝对序号
+    std::int64_t explicitLowerBound(double t, bool upper) const;
+    std::int64_t end() const { return m_first + m_size; } // 下一个样点的绝对序号
+
+    static constexpr std::size_t kMaxSegments = 4096;      // 间隙过多时转为显式模式
+
+    Mode m_mode = Mode::Empty;
+    std::int64_t m_first = 0;                              // 最旧保留样点的绝对序号
+    std::int64_t m_size = 0;                               // 保留样点数
+    std::int64_t m_limit = 0;                              // 容量上限（0 = 无上限）
+    double m_dt = 0.0;                                     // 采样周期（均匀模式）
+    bool m_dtKnown = false;                                // 逐点写入时，第二个样点到达前周期未知
+    std::vector<Segment> m_segments;                       // 均匀模式分段表（按 start/t0 递增）
+    SampleRing m_time;                                     // 显式模式时间戳（与数据列同容量的环）
+};
+
+#endif // TIMEAXIS_H
@@ -0,0 +1,234 @@
+#include "tracer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+constexpr std::size_t Tracer::kEventsPerThread;
+std::atomic<bool> Tracer::s_enabled{false};
+
+namespace {
+
+constexpr std::size_t kMaxRetiredBuffers = 32;   // 最多保留多少个已结束线程的缓冲
+
+struct TraceEvent {
+    const char *name = nullptr;
+    std::int64_t beginNs = 0;
+    std::int64_t endNs = 0;
+};
+
+/**
+ * @brief 单个线程的环形缓冲：只有所属线程写入 events / head，导出线程只读
+ */
+struct ThreadBuffer {
+    int tid = 0;
+    std::string name;                       // 受 Registry::mutex 保护
+    bool retired = false;                   // 线程已结束（受 Registry::mutex 保护）
+    std::vector<TraceEvent> events;
+    std::atomic<std::uint64_t> head{0};     // 已写入的区间总数
+    std::atomic<std::uint64_t> floor{0};    // clear() 时的 head，之前的记录不再导出
+};
+using ThreadBufferPtr = std::shared_ptr<ThreadBuffer>;
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadBufferPtr> buffers;
+    int nextTid = 1;
+};
+
+Registry &registry()
+{
+    // 不析构：线程退出（含进程退出时）仍可能访问
+    static Registry *r = new Registry;
+    return *r;
+}
+
+// 调用方持有 Registry::mutex
+void pruneRetired(Registry &r)
+{
+    std::size_t retired = 0;
+    for (const ThreadBufferPtr &b : r.buffers) {
+        retired += b->retired ? 1 : 0;
+    }
+    for (auto it = r.buffers.begin(); it != r.buffers.end() && retired > kMaxRetiredBuffers;) {
+        if ((*it)->retired) {
+            it = r.buffers.erase(it);
+            --retired;
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief 线程局部句柄：第一次记录时创建缓冲，线程结束时把缓冲标记为已结束（记录仍可导出）
+ */
+struct ThreadHandle {
+    ThreadBufferPtr buffer;
+    const char *name = nullptr;
+
+    ~ThreadHandle()
+    {
+        if (buffer) {
+            Registry &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            buffer->retired = true;
+            pruneRetired(r);
+        }
+    }
+};
+
+thread_local ThreadHandle t_handle;
+
+ThreadBuffer *currentBuffer()
+{
+    if (!t_handle.buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.resize(Tracer::kEventsPerThread);
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffer->tid = r.nextTid++;
+        buffer->name = t_handle.name ? t_handle.name : "thread " + std::to_string(buffer->tid);
+        r.buffers.push_back(buffer);
+        t_handle.buffer = buffer;
+    }
+    return t_handle.buffer.get();
+}
+
+void appendEscaped(std::string &out, const char *s)
+{
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') {
+            out += '\\';
+        }
+        out += *s;
+    }
+}
+
+} // namespace
+
+void Tracer::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::clear()
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.buffers.erase(std::remove_if(r.buffers.begin(), r.buffers.end(),
+                                   [](const ThreadBufferPtr &b) { return b->retired; }),
+                    r.buffers.end());
+    // 仍在运行的线程可能正在写入，不能重置 head，只移动导出的起点
+    for (const ThreadBufferPtr &b : r.buffers) {
+        b->floor.store(b->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+void Tracer::setThreadName(const char *name)
+{
+    if (t_handle.name == name) {
+        return;     // 线程池线程每次执行任务都会设置一次
+    }
+    t_handle.name = name;
+    if (t_handle.buffer) {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        t_handle.buffer->name = name;
+    }
+}
+
+void Tracer::record(const char *name, std::int64_t beginNs, std::int64_t endNs)
+{
+    ThreadBuffer *buffer = currentBuffer();
+    const std::uint64_t h = buffer->head.load(std::memory_order_relaxed);
+    TraceEvent &e = buffer->events[std::size_t(h % kEventsPerThread)];
+    e.name = name;
+    e.beginNs = beginNs;
+    e.endNs = endNs;
+    buffer->head.store(h + 1, std::memory_order_release);
+}
+
+std::int64_t Tracer::nowNs()
+{
+    using Clock = std::chrono::steady_clock;
+    static const Clock::time_point epoch = Clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+}
+
+bool Tracer::writeChromeTrace(const std::string &path, std::string *error)
+{
+    struct Snapshot {
+        ThreadBufferPtr buffer;
+        std::string name;
+    };
+    std::vector<Snapshot> threads;
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (const ThreadBufferPtr &b : r.buffers) {
+            threads.push_back({b, b->name});
+        }
+    }
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    char num[96];
+    std::vector<TraceEvent> events;
+    for (const Snapshot &t : threads) {
+        const ThreadBuffer &b = *t.buffer;
+
+        // 线程名元数据
+        json += first ? "" : ",\n";
+        first = false;
+        json += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + std::to_string(b.tid)
+              + ",\"args\":{\"name\":\"";
+        appendEscaped(json, t.name.c_str());
+        json += "\"}}";
+
+        // 拷贝最近的记录；拷贝期间被所属线程覆盖的部分丢弃
+        const std::uint64_t h1 = b.head.load(std::memory_order_acquire);
+        const std::uint64_t n = std::min<std::uint64_t>(h1, kEventsPerThread);
+        events.clear();
+        for (std::uint64_t i = h1 - n; i < h1; ++i) {
+            events.push_back(b.events[std::size_t(i % kEventsPerThread)]);
+        }
+        const std::uint64_t h2 = b.head.load(std::memory_order_acquire);
+        std::uint64_t begin = h1 - n;
+        if (h2 >= kEventsPerThread) {
+            begin = std::max(begin, h2 - kEventsPerThread + 1);
+        }
+        begin = std::max(begin, b.floor.load(std::memory_order_relaxed));
+
+        for (std::uint64_t i = begin; i < h1; ++i) {
+            const TraceEvent &e = events[std::size_t(i - (h1 - n))];
+            std::snprintf(num, sizeof(num), "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                          double(e.beginNs) / 1000.0, double(e.endNs - e.beginNs) / 1000.0, b.tid);
+            json += ",\n{\"ph\":\"X\",\"name\":\"";
+            appendEscaped(json, e.name);
+            json += "\",";
+            json += num;
+        }
+    }
+    json += "\n]}\n";
+
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        if (error) {
+            *error = std::strerror(errno);
+        }
+        return false;
+    }
+    const bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    if (std::fclose(file) != 0 || !ok) {
+        if (error) {
+            *error = "write failed";
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,95 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 流水线时间线记录（导出为 Chrome / Perfetto 的 trace JSON）
+ *
+ * 在热路径上放置 TraceSpan（或 POWERDAQ_TRACE_SCOPE），记录各阶段在各线程上的起止时间：
+ * - 每个线程第一次记录时创建自己的环形缓冲（只有该线程写入，无锁），
+ *   写满后覆盖最旧的记录，只保留最近 kEventsPerThread 个区间；
+ * - writeChromeTrace() 按需导出所有线程（含已结束线程）的记录，
+ *   可直接在 chrome://tracing 或 ui.perfetto.dev 中打开；
+ * - 关闭时（默认）每个区间的开销只有一次原子读和一个分支，不读时钟、不写缓冲。
+ *
+ * 区间名必须是字符串字面量（只保存指针）。
+ */
+class Tracer
+{
+public:
+    static constexpr std::size_t kEventsPerThread = 16384;   // 每线程保留的区间数
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 开始 / 停止记录（开始时不清空已有记录，需要时先调用 clear()）
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * @brief 丢弃所有线程的记录（以及已结束线程的缓冲）
+     */
+    static void clear();
+
+    /**
+     * @brief 当前线程在时间线中显示的名称（如 "acquisition"、"writer"）
+     */
+    static void setThreadName(const char *name);
+
+    /**
+     * @brief 记录当前线程的一个区间（时间为 nowNs() 的返回值）
+     */
+    static void record(const char *name, std::int64_t beginNs, std::int64_t endNs);
+
+    /**
+     * @brief 单调时钟（纳秒，以进程内第一次调用为零点）
+     */
+    static std::int64_t nowNs();
+
+    /**
+     * @brief 导出为 Chrome trace-event JSON（"X" 完整事件 + 线程名元数据）
+     * @return 写入失败时返回 false，并在 error 中给出原因
+     */
+    static bool writeChromeTrace(const std::string &path, std::string *error = nullptr);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * @brief 作用域区间：构造时开始，析构时记录（未开启记录时什么也不做）
+ */
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name)
+        : m_name(Tracer::isEnabled() ? name : nullptr)
+    {
+        if (m_name) {
+            m_beginNs = Tracer::nowNs();
+        }
+    }
+
+    ~TraceSpan()
+    {
+        if (m_name) {
+            Tracer::record(m_name, m_beginNs, Tracer::nowNs());
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *m_name;
+    std::int64_t m_beginNs = 0;
+};
+
+#define POWERDAQ_TRACE_CONCAT2(a, b) a##b
+#define POWERDAQ_TRACE_CONCAT(a, b) POWERDAQ_TRACE_CONCAT2(a, b)
+#define POWERDAQ_TRACE_SCOPE(name) TraceSpan POWERDAQ_TRACE_CONCAT(traceSpan_, __LINE__)(name)
+
+#endif // TRACER_H
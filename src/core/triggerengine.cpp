@@ -0,0 +1,446 @@
+#include "triggerengine.h"
+#include "reducekernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 扫描时每次做最值归约的样点数
+constexpr std::size_t kScanChunk = 64;
+
+const SampleRing &sourceColumn(const ChannelBuffer &data, TriggerSettings::Source source)
+{
+    switch (source) {
+    case TriggerSettings::Source::Voltage: return data.voltage();
+    case TriggerSettings::Source::Current: return data.current();
+    case TriggerSettings::Source::Power:   return data.power();
+    }
+    return data.voltage();
+}
+}
+
+TriggerEngine::TriggerEngine()
+{
+    setSettings(TriggerSettings());
+}
+
+void TriggerEngine::setSettings(const TriggerSettings &settings)
+{
+    m_settings = settings;
+
+    // 各触发类型归结为两个门限
+    const double hysteresis = std::fabs(settings.hysteresis);
+    switch (settings.type) {
+    case TriggerSettings::Type::Edge:
+        if (settings.polarity == TriggerSettings::Polarity::Positive) {
+            m_t0 = settings.level - hysteresis;
+            m_t1 = settings.level;
+        } else {
+            m_t0 = settings.level;
+            m_t1 = settings.level + hysteresis;
+        }
+        break;
+    case TriggerSettings::Type::Level:
+    case TriggerSettings::Type::PulseWidth:
+        m_t0 = m_t1 = settings.level;
+        break;
+    case TriggerSettings::Type::Window:
+    case TriggerSettings::Type::Runt:
+        m_t0 = std::min(settings.low, settings.high);
+        m_t1 = std::max(settings.low, settings.high);
+        break;
+    }
+
+    const std::size_t pre = settings.preTriggerSamples;
+    m_historyTime.setCapacityLimit(pre);
+    m_historyVoltage.setCapacityLimit(pre);
+    m_historyCurrent.setCapacityLimit(pre);
+    m_historyPower.setCapacityLimit(pre);
+    reset();
+
+    const std::size_t keep = std::max<std::size_t>(1, settings.maxCaptures);
+    if (m_captures.size() > keep) {
+        m_captures.erase(m_captures.begin(), m_captures.end() - std::ptrdiff_t(keep));
+    }
+}
+
+void TriggerEngine::reset()
+{
+    resetDetector();
+    m_pending.clear();
+    m_busyUntil = std::numeric_limits<std::int64_t>::min();
+    m_holdoffUntil = -std::numeric_limits<double>::infinity();
+    m_lastEventTime = std::numeric_limits<double>::quiet_NaN();
+    m_historyTime.clear();
+    m_historyVoltage.clear();
+    m_historyCurrent.clear();
+    m_historyPower.clear();
+}
+
+void TriggerEngine::resetDetector()
+{
+    m_band = -1;
+    m_ready = false;
+    m_inPulse = false;
+    m_exceeded = false;
+    m_pulseStart = 0.0;
+}
+
+void TriggerEngine::arm()
+{
+    if (m_armed) {
+        return;
+    }
+    // 停止期间不记录历史：重新开始时从空的预触发缓冲和初始检测状态开始
+    m_armed = true;
+    resetDetector();
+    m_lastEventTime = std::numeric_limits<double>::quiet_NaN();
+    if (m_pending.empty()) {
+        m_historyTime.clear();
+        m_historyVoltage.clear();
+        m_historyCurrent.clear();
+        m_historyPower.clear();
+    }
+}
+
+void TriggerEngine::stop()
+{
+    m_armed = false;
+}
+
+TriggerCapturePtr TriggerEngine::capture(int index) const
+{
+    if (index < 0 || index >= int(m_captures.size())) {
+        return TriggerCapturePtr();
+    }
+    return m_captures[std::size_t(index)];
+}
+
+void TriggerEngine::clearCaptures()
+{
+    m_captures.clear();
+}
+
+/**
+ * @brief 样点进入新的区时更新检测状态
+ * @param raw 新的区（0 / 1 / 2）
+ * @param t 该样点的时间
+ * @return 是否满足触发条件
+ */
+bool TriggerEngine::onBand(int raw, double t)
+{
+    const int prevRaw = m_band;
+    m_band = raw;
+    const bool positive = (m_settings.polarity == TriggerSettings::Polarity::Positive);
+
+    if (m_settings.type == TriggerSettings::Type::Window) {
+        // 先处于“另一侧”，再进入触发侧时触发
+        const bool inside = (raw == 1);
+        if (inside == positive) {
+            m_ready = true;
+            return false;
+        }
+        const bool fire = m_ready;
+        m_ready = false;
+        return fire;
+    }
+
+    // 其余类型按正极性书写，负极性把区镜像后复用同一套逻辑
+    const int b = positive ? raw : 2 - raw;
+    const int prev = (prevRaw < 0) ? -1 : (positive ? prevRaw : 2 - prevRaw);
+
+    switch (m_settings.type) {
+    case TriggerSettings::Type::Edge:
+    case TriggerSettings::Type::Level:
+        // 电平触发开始监测时即处于预备状态；边沿触发需先回到门限另一侧（含迟滞）
+        if (prev < 0 && m_settings.type == TriggerSettings::Type::Level) {
+            m_ready = true;
+        }
+        if (b == 0) {
+            m_ready = true;
+        } else if (b == 2 && m_ready) {
+            m_ready = false;
+            return true;
+        }
+        return false;
+
+    case TriggerSettings::Type::PulseWidth:
+        if (b == 2) {
+            // 只有看到脉冲起点才计时（开始监测时已在脉冲中则不计）
+            if (prev == 0) {
+                m_inPulse = true;
+                m_pulseStart = t;
+            }
+            return false;
+        }
+        if (m_inPulse) {
+            m_inPulse = false;
+            const double width = t - m_pulseStart;
+            return width >= m_settings.minWidth && width <= m_settings.maxWidth;
+        }
+        return false;
+
+    case TriggerSettings::Type::Runt:
+        if (b == 0) {
+            if (m_inPulse) {
+                m_inPulse = false;
+                return !m_exceeded;
+            }
+            return false;
+        }
+        if (prev == 0) {
+            m_inPulse = true;
+            m_exceeded = false;
+        }
+        if (b == 2) {
+            m_exceeded = true;
+        }
+        return false;
+
+    case TriggerSettings::Type::Window:
+        break;
+    }
+    return false;
+}
+
+bool TriggerEngine::accept(std::int64_t index, double t)
+{
+    return m_armed && index >= m_busyUntil && t >= m_holdoffUntil;
+}
+
+/**
+ * @brief 扫描逻辑区间 [begin, end)，把接受的触发记入 m_fires
+ */
+void TriggerEngine::scan(const ChannelBuffer &data, std::int64_t begin, std::int64_t end)
+{
+    const TimeAxis &time = data.time();
+    const std::int64_t first = time.firstIndex();
+    const std::int64_t post = std::max<std::int64_t>(1, std::int64_t(m_settings.postTriggerSamples));
+    const bool autoMode = (m_settings.mode == TriggerSettings::Mode::Auto);
+
+    auto fire = [&](std::int64_t i, double t, bool forced) {
+        Fire f;
+        f.index = first + i;
+        f.time = t;
+        f.forced = forced;
+        m_fires.push_back(f);
+        m_busyUntil = f.index + post;
+        m_holdoffUntil = t + m_settings.holdoff;
+        m_lastEventTime = t;
+        if (m_settings.mode == TriggerSettings::Mode::Single) {
+            m_armed = false;
+        }
+    };
+
+    SampleRing::Span parts[2];
+    const int n = sourceColumn(data, m_settings.source).spans(std::size_t(begin), std::size_t(end), parts);
+    std::int64_t i = begin;
+    for (int k = 0; k < n; ++k) {
+        std::size_t len = 0;
+        for (std::size_t off = 0; off < parts[k].size; off += len, i += std::int64_t(len)) {
+            const double *v = parts[k].data + off;
+            len = std::min(kScanChunk, parts[k].size - off);
+            if (!m_armed) {
+                return;
+            }
+
+            // Auto：超时未触发时在块首强制采集一段
+            if (autoMode) {
+                const double t = time.at(i);
+                if (std::isnan(m_lastEventTime)) {
+                    m_lastEventTime = t;
+                } else if (t - m_lastEventTime >= m_settings.autoTimeout && accept(first + i, t)) {
+                    fire(i, t, true);
+                }
+            }
+
+            // 整块都在当前区内：状态不会变化，跳过
+            SpanReduction r;
+            reduceSpan(v, len, r);
+            if (r.count == 0 || (band(r.min) == m_band && band(r.max) == m_band)) {
+                continue;
+            }
+            for (std::size_t j = 0; j < len; ++j) {
+                const double x = v[j];
+                if (std::isnan(x)) {
+                    continue;
+                }
+                const int b = band(x);
+                if (b == m_band) {
+                    continue;
+                }
+                const std::int64_t at = i + std::int64_t(j);
+                const double t = time.at(at);
+                if (onBand(b, t) && accept(first + at, t)) {
+                    fire(at, t, false);
+                }
+            }
+        }
+    }
+}
+
+std::size_t TriggerEngine::process(int channelId, const ChannelBuffer &data, std::size_t count)
+{
+    if (channelId != m_settings.channelId || count == 0 || (!m_armed && m_pending.empty())) {
+        return 0;
+    }
+    const std::int64_t n = data.size();
+    const std::int64_t begin = n - std::min<std::int64_t>(n, std::int64_t(count));
+
+    m_fires.clear();
+    if (m_armed) {
+        scan(data, begin, n);
+    }
+    for (const Fire &f : m_fires) {
+        startCapture(f, data, begin);
+    }
+    const std::size_t done = feedPending(data, begin);
+    pushHistory(data, begin, n);
+    return done;
+}
+
+/**
+ * @brief 新建采集段：先填入触发点之前的样点（预触发历史 + 本块触发点之前的部分）
+ */
+void TriggerEngine::startCapture(const Fire &fire, const ChannelBuffer &data, std::int64_t begin)
+{
+    auto capture = std::make_shared<TriggerCapture>();
+    capture->sequence = ++m_sequence;
+    capture->channelId = m_settings.channelId;
+    capture->triggerTime = fire.time;
+    capture->forced = fire.forced;
+    capture->data.setRetention(RetentionPolicy::unlimited());
+
+    const std::int64_t first = data.time().firstIndex();
+    const std::int64_t blockBegin = first + begin;
+    const std::int64_t preBegin = fire.index - std::int64_t(m_settings.preTriggerSamples);
+    if (preBegin < blockBegin) {
+        const std::size_t need = std::size_t(blockBegin - preBegin);
+        const std::size_t have = m_historyTime.size();
+        appendHistory(capture->data, have - std::min(need, have));
+    }
+    appendRange(capture->data, data, std::max(preBegin, blockBegin) - first, fire.index - first);
+
+    Pending p;
+    p.capture = capture;
+    p.end = fire.index + std::int64_t(m_settings.postTriggerSamples);
+    p.next = fire.index;
+    m_pending.push_back(p);
+}
+
+/**
+ * @brief 把本块中属于各采集段触发后部分的样点追加进去，返回完成的段数
+ */
+std::size_t TriggerEngine::feedPending(const ChannelBuffer &data, std::int64_t begin)
+{
+    const std::int64_t first = data.time().firstIndex();
+    const std::int64_t blockBegin = first + begin;
+    const std::int64_t blockEnd = first + data.size();
+    const std::size_t keep = std::max<std::size_t>(1, m_settings.maxCaptures);
+
+    std::size_t done = 0;
+    for (std::size_t k = 0; k < m_pending.size();) {
+        Pending &p = m_pending[k];
+        const std::int64_t from = std::max(p.next, blockBegin);
+        const std::int64_t to = std::min(p.end, blockEnd);
+        if (from < to) {
+            appendRange(p.capture->data, data, from - first, to - first);
+        }
+        p.next = std::max(p.next, to);
+        if (p.next < p.end) {
+            ++k;
+            continue;
+        }
+
+        m_captures.push_back(p.capture);
+        if (m_captures.size() > keep) {
+            m_captures.erase(m_captures.begin());
+        }
+        m_pending.erase(m_pending.begin() + std::ptrdiff_t(k));
+        ++done;
+    }
+    return done;
+}
+
+/**
+ * @brief 拷贝 src 的逻辑区间 [b, e) 到 dst（时间轴按逐点时间戳写入）
+ */
+void TriggerEngine::appendRange(ChannelBuffer &dst, const ChannelBuffer &src, std::int64_t b, std::int64_t e)
+{
+    b = std::max<std::int64_t>(b, 0);
+    if (b >= e) {
+        return;
+    }
+    const std::size_t n = std::size_t(e - b);
+    const SampleRing *columns[3] = {&src.voltage(), &src.current(), &src.power()};
+    m_scratch[0].resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        m_scratch[0][i] = src.time().at(b + std::int64_t(i));
+    }
+    for (int c = 0; c < 3; ++c) {
+        std::vector<double> &out = m_scratch[c + 1];
+        out.clear();
+        SampleRing::Span parts[2];
+        const int count = columns[c]->spans(std::size_t(b), std::size_t(e), parts);
+        for (int k = 0; k < count; ++k) {
+            out.insert(out.end(), parts[k].data, parts[k].data + parts[k].size);
+        }
+    }
+    dst.append(m_scratch[0].data(), 0.0, 0.0,
+               m_scratch[1].data(), m_scratch[2].data(), m_scratch[3].data(), n);
+}
+
+/**
+ * @brief 拷贝预触发历史中 [from, size) 的样点到 dst
+ */
+void TriggerEngine::appendHistory(ChannelBuffer &dst, std::size_t from)
+{
+    const std::size_t size = m_historyTime.size();
+    if (from >= size) {
+        return;
+    }
+    const SampleRing *rings[4] = {&m_historyTime, &m_historyVoltage, &m_historyCurrent, &m_historyPower};
+    for (int c = 0; c < 4; ++c) {
+        std::vector<double> &out = m_scratch[c];
+        out.clear();
+        SampleRing::Span parts[2];
+        const int count = rings[c]->spans(from, size, parts);
+        for (int k = 0; k < count; ++k) {
+            out.insert(out.end(), parts[k].data, parts[k].data + parts[k].size);
+        }
+    }
+    dst.append(m_scratch[0].data(), 0.0, 0.0,
+               m_scratch[1].data(), m_scratch[2].data(), m_scratch[3].data(), size - from);
+}
+
+/**
+ * @brief 把逻辑区间 [b, e) 记入预触发历史（只需最后 preTriggerSamples 个）
+ */
+void TriggerEngine::pushHistory(const ChannelBuffer &data, std::int64_t b, std::int64_t e)
+{
+    const std::int64_t pre = std::int64_t(m_settings.preTriggerSamples);
+    if (pre == 0) {
+        return;
+    }
+    b = std::max(b, e - pre);
+    if (b >= e) {
+        return;
+    }
+
+    std::vector<double> &times = m_scratch[0];
+    times.resize(std::size_t(e - b));
+    for (std::int64_t i = b; i < e; ++i) {
+        times[std::size_t(i - b)] = data.time().at(i);
+    }
+    m_historyTime.append(times.data(), times.size());
+
+    const SampleRing *columns[3] = {&data.voltage(), &data.current(), &data.power()};
+    SampleRing *rings[3] = {&m_historyVoltage, &m_historyCurrent, &m_historyPower};
+    for (int c = 0; c < 3; ++c) {
+        SampleRing::Span parts[2];
+        const int count = columns[c]->spans(std::size_t(b), std::size_t(e), parts);
+        for (int k = 0; k < count; ++k) {
+            rings[c]->append(parts[k].data, parts[k].size);
+        }
+    }
+}
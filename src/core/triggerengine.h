@@ -0,0 +1,170 @@
+#ifndef TRIGGERENGINE_H
+#define TRIGGERENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "channelbuffer.h"
+#include "samplering.h"
+
+/**
+ * @brief 触发条件设置
+ *
+ * polarity 的含义随触发类型而定：
+ * - Edge：Positive = 上升沿（穿越 level，需先低于 level - hysteresis），Negative = 下降沿；
+ * - Level：Positive = 高于 level，Negative = 低于 level（开始监测时条件已满足也会触发）；
+ * - Window：Positive = 离开 [low, high)，Negative = 进入 [low, high)；
+ * - PulseWidth：Positive = 高于 level 的正脉冲，Negative = 低于 level 的负脉冲，
+ *   脉冲结束时宽度落在 [minWidth, maxWidth] 内则触发；
+ * - Runt：Positive = 越过 low 但未达到 high 就回落的正向欠幅脉冲，Negative 反之。
+ */
+struct TriggerSettings {
+    enum class Type { Edge, Level, Window, PulseWidth, Runt };
+    enum class Polarity { Positive, Negative };
+    enum class Mode {
+        Single,     // 触发一次后停止，需重新 arm
+        Normal,     // 每次满足条件都采集
+        Auto,       // 同 Normal；超过 autoTimeout 未触发时强制采集一段
+    };
+    enum class Source { Voltage, Current, Power };
+
+    Type type = Type::Edge;
+    Polarity polarity = Polarity::Positive;
+    Mode mode = Mode::Normal;
+    int channelId = 0;
+    Source source = Source::Current;
+
+    double level = 0.0;         // Edge / Level / PulseWidth 的门限
+    double hysteresis = 0.0;    // Edge 的迟滞（抑制噪声反复触发）
+    double low = 0.0;           // Window / Runt 的下门限
+    double high = 0.0;          // Window / Runt 的上门限
+    double minWidth = 0.0;                                      // PulseWidth：最小脉宽（秒）
+    double maxWidth = std::numeric_limits<double>::infinity();  // PulseWidth：最大脉宽（秒）
+
+    double holdoff = 0.0;       // 一次触发后至少间隔多久（秒）才接受下一次触发
+    double autoTimeout = 1.0;   // Auto 模式：多久（秒）未触发时强制采集
+
+    std::size_t preTriggerSamples = 4096;   // 触发点之前保留的样点数
+    std::size_t postTriggerSamples = 4096;  // 触发点（含）之后采集的样点数
+    std::size_t maxCaptures = 64;           // 最多保留的采集段数，超出后丢弃最旧的
+};
+
+/**
+ * @brief 一次触发采集到的数据段
+ */
+struct TriggerCapture {
+    std::int64_t sequence = 0;  // 触发序号（从 1 开始，丢弃旧段后仍保持递增）
+    int channelId = 0;
+    double triggerTime = 0.0;
+    bool forced = false;        // Auto 模式超时强制采集
+    ChannelBuffer data;         // 触发前 preTriggerSamples + 触发后 postTriggerSamples 个样点
+};
+using TriggerCapturePtr = std::shared_ptr<const TriggerCapture>;
+
+/**
+ * @brief 流式触发引擎：在数据写入路径上检测触发条件并截取前后数据段
+ *
+ * 每种触发条件都归结为按一到两个门限把样点分成三个区（band），状态只在区发生变化时更新。
+ * 扫描时每 64 个样点先做一次 SIMD 最值归约：整块落在当前区内时直接跳过，
+ * 只有可能跨越门限的块才逐点检查，绝大多数平稳数据不逐点比较。
+ *
+ * 触发通道的最近 preTriggerSamples 个样点保存在环形缓冲中，触发时与触发点之后的
+ * 样点拼接成一个采集段；采集段完成前（busy）以及 holdoff 期间的触发被忽略。
+ *
+ * 与 ChannelBuffer 相同，只在写入线程（GUI 线程）调用。
+ */
+class TriggerEngine
+{
+public:
+    TriggerEngine();
+
+    /**
+     * @brief 修改触发设置（清空预触发缓冲和进行中的采集，已完成的采集段保留）
+     */
+    void setSettings(const TriggerSettings &settings);
+    const TriggerSettings &settings() const { return m_settings; }
+
+    /**
+     * @brief 开始监测（Single 模式触发后需再次调用）
+     */
+    void arm();
+
+    /**
+     * @brief 停止监测（进行中的采集仍会补齐）
+     */
+    void stop();
+
+    /**
+     * @brief 丢弃预触发历史和进行中的采集（触发通道的数据被清空时调用）
+     */
+    void reset();
+
+    bool isArmed() const { return m_armed; }
+    bool isCapturing() const { return !m_pending.empty(); }
+
+    /**
+     * @brief 处理某通道刚写入的数据（data 的最后 count 个样点）
+     * @return 本次完成的采集段数
+     */
+    std::size_t process(int channelId, const ChannelBuffer &data, std::size_t count);
+
+    int captureCount() const { return int(m_captures.size()); }
+    TriggerCapturePtr capture(int index) const;
+    void clearCaptures();
+
+private:
+    struct Pending {
+        std::shared_ptr<TriggerCapture> capture;
+        std::int64_t next = 0;  // 下一个待追加样点的绝对序号
+        std::int64_t end = 0;   // 采集结束的绝对序号（不含）
+    };
+    struct Fire {
+        std::int64_t index = 0; // 触发样点的绝对序号
+        double time = 0.0;
+        bool forced = false;
+    };
+
+    void resetDetector();
+    int band(double x) const { return int(x >= m_t0) + int(x >= m_t1); }
+    bool onBand(int b, double t);                   // 区变化时更新状态，返回是否满足触发条件
+    bool accept(std::int64_t index, double t);      // 是否接受该时刻的触发（busy / holdoff / 模式）
+    void scan(const ChannelBuffer &data, std::int64_t begin, std::int64_t end);
+    void startCapture(const Fire &fire, const ChannelBuffer &data, std::int64_t begin);
+    std::size_t feedPending(const ChannelBuffer &data, std::int64_t begin);
+    void appendRange(ChannelBuffer &dst, const ChannelBuffer &src, std::int64_t b, std::int64_t e);
+    void appendHistory(ChannelBuffer &dst, std::size_t from);
+    void pushHistory(const ChannelBuffer &data, std::int64_t b, std::int64_t e);
+
+    TriggerSettings m_settings;
+    double m_t0 = 0.0;                  // 分区门限：band = (x >= t0) + (x >= t1)
+    double m_t1 = 0.0;
+    bool m_armed = false;
+
+    // 检测状态（只在区变化时更新）
+    int m_band = -1;                    // 当前区（-1 = 尚无样点）
+    bool m_ready = false;               // Edge / Level / Window：已进入预备区，等待进入触发区
+    bool m_inPulse = false;             // PulseWidth / Runt：脉冲进行中
+    bool m_exceeded = false;            // Runt：本次脉冲已达到 high
+    double m_pulseStart = 0.0;
+
+    // 接受触发的约束
+    std::int64_t m_busyUntil = std::numeric_limits<std::int64_t>::min();   // 采集段完成前不接受新触发
+    double m_holdoffUntil = -std::numeric_limits<double>::infinity();
+    double m_lastEventTime = std::numeric_limits<double>::quiet_NaN();     // Auto 超时的计时起点
+
+    // 预触发历史：触发通道最近 preTriggerSamples 个样点
+    SampleRing m_historyTime;
+    SampleRing m_historyVoltage;
+    SampleRing m_historyCurrent;
+    SampleRing m_historyPower;
+
+    std::vector<Fire> m_fires;          // 本次扫描接受的触发（复用缓冲）
+    std::vector<Pending> m_pending;     // 等待触发后样点的采集段
+    std::vector<TriggerCapturePtr> m_captures;
+    std::int64_t m_sequence = 0;
+    std::vector<double> m_scratch[4];   // 拷贝时间轴 / 三列数据的复用缓冲
+};
+
+#endif // TRIGGERENGINE_H
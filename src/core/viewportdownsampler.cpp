@@ -0,0 +1,352 @@
+#include "viewportdownsampler.h"
+
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QThread>
+#include "tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief 线程池任务：处理一个通道的降采样请求
+ */
+class ViewportDownsampler::Job : public QRunnable
+{
+public:
+    Job(ViewportDownsampler *owner, int channelId)
+        : m_owner(owner), m_channelId(channelId) {}
+
+    void run() override { m_owner->runChannel(m_channelId); }
+
+private:
+    ViewportDownsampler *m_owner;
+    int m_channelId;
+};
+
+ViewportDownsampler::ViewportDownsampler(QObject *parent)
+    : QObject(parent)
+{
+    // 留一个核心给 GUI 线程
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+ViewportDownsampler::~ViewportDownsampler()
+{
+    cancelAll();
+    m_pool.waitForDone();
+}
+
+void ViewportDownsampler::setViewport(const TimeRange &range)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (range.lower == m_range.lower && range.upper == m_range.upper) {
+        return;
+    }
+    m_range = range;
+    ++m_generation;
+}
+
+void ViewportDownsampler::cancelAll()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_generation;
+    m_back.clear();
+}
+
+void ViewportDownsampler::request(int channelId, const ChannelSlotPtr &slot,
+                                  const QVector<Target> &targets)
+{
+    if (!slot || targets.isEmpty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ChannelState &state = m_channels[channelId];
+        state.slot = slot;
+        state.targets = targets;
+        if (state.running) {
+            // 合并：当前任务结束后按最新参数再跑一次
+            state.rerun = true;
+            return;
+        }
+        state.running = true;
+    }
+    Job *job = new Job(this, channelId);
+    job->setAutoDelete(true);
+    m_pool.start(job);
+}
+
+void ViewportDownsampler::runChannel(int channelId)
+{
+    Tracer::setThreadName("downsample");
+    for (;;) {
+        POWERDAQ_TRACE_SCOPE("downsample");
+        ChannelSlotPtr slot;
+        QVector<Target> targets;
+        TimeRange range;
+        quint64 generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ChannelState &state = m_channels[channelId];
+            slot = state.slot;
+            targets = state.targets;
+            range = m_range;
+            generation = m_generation.load();
+            state.rerun = false;
+        }
+
+        QElapsedTimer clock;
+        clock.start();
+        std::vector<Result> results;
+        if (range.size() > 0) {
+            std::lock_guard<std::mutex> dataLock(slot->mutex);
+            const ChannelBuffer &data = slot->data;
+            for (const Target &t : targets) {
+                if (m_generation.load() != generation) {
+                    break;  // 视口已变化，放弃本次结果
+                }
+                if (slot->isEmpty() || t.width <= 0) {
+                    continue;
+                }
+                auto columns = std::make_shared<MinMaxColumns>();
+                if (slot->file) {
+                    downsample(*slot->file, slot->fileChannel, t.column, range, t.width, *columns);
+                } else {
+                    downsample(data, t.column, range, t.width, *columns);
+                }
+
+                Result r;
+                r.channelId = channelId;
+                r.column = t.column;
+                r.generation = generation;
+                r.columns = columns;
+                results.push_back(r);
+            }
+        }
+        m_passes.fetch_add(1, std::memory_order_relaxed);
+        m_busyNs.fetch_add(quint64(clock.nsecsElapsed()), std::memory_order_relaxed);
+
+        bool notify = false;
+        bool again = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_generation.load() == generation && !results.empty()) {
+                // 双缓冲：同一曲线只保留最新结果
+                for (Result &r : results) {
+                    auto it = std::find_if(m_back.begin(), m_back.end(), [&r](const Result &o) {
+                        return o.channelId == r.channelId && o.column == r.column;
+                    });
+                    if (it != m_back.end()) {
+                        *it = r;
+                    } else {
+                        m_back.push_back(r);
+                    }
+                }
+                notify = !m_notified;
+                m_notified = true;
+            }
+
+            ChannelState &state = m_channels[channelId];
+            again = state.rerun;
+            if (!again) {
+                state.running = false;
+                state.slot.reset();
+            }
+        }
+
+        if (notify) {
+            emit resultsReady();
+        }
+        if (!again) {
+            return;
+        }
+    }
+}
+
+void ViewportDownsampler::takeResults(std::vector<Result> &out)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out.clear();
+    const quint64 generation = m_generation.load();
+    for (Result &r : m_back) {
+        if (r.generation == generation) {
+            out.push_back(r);
+        }
+    }
+    m_back.clear();
+    m_notified = false;
+}
+
+const SampleRing &ViewportDownsampler::columnValues(const ChannelBuffer &data, Column column)
+{
+    return (column == Column::Voltage) ? data.voltage()
+         : (column == Column::Current) ? data.current()
+                                       : data.power();
+}
+
+const MinMaxPyramid &ViewportDownsampler::columnPyramid(const ChannelBuffer &data, Column column)
+{
+    return (column == Column::Voltage) ? data.voltagePyramid()
+         : (column == Column::Current) ? data.currentPyramid()
+                                       : data.powerPyramid();
+}
+
+void ViewportDownsampler::downsample(const TimeAxis &time, const SampleRing &values,
+                                     const MinMaxPyramid &pyramid, const TimeRange &xr, int w,
+                                     MinMaxColumns &out)
+{
+    out.first.clear();
+    out.second.clear();
+    out.lower = xr.lower;
+    out.bin = (w > 0) ? (xr.upper - xr.lower) / w : 0.0;   // 每个像素对应的时间跨度
+
+    const std::int64_t n = std::min<std::int64_t>(time.size(), std::int64_t(values.size()));
+    const std::int64_t i0 = std::min(n, time.lowerBound(xr.lower));  // 可视范围起始索引
+    const std::int64_t i1 = std::min(n, time.upperBound(xr.upper));  // 可视范围结束索引（包含等于 xr.upper 的点）
+    if (w <= 0 || drawsRaw(i1 - i0, w)) {
+        return;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    out.first.assign(std::size_t(w), nan);
+    out.second.assign(std::size_t(w), nan);
+
+    double tBinStart = xr.lower;
+    std::int64_t idx = i0;
+    for (int px = 0; px < w && idx < i1; ++px) {
+        // 最后一列包含右边界点，其他列不包含右边界（避免重复）
+        const bool isLastBin = (px == w - 1);
+        const double tBinEnd = isLastBin ? xr.upper : (tBinStart + out.bin);
+        const std::int64_t binEnd = isLastBin ? i1 : std::max(idx, std::min(i1, time.lowerBound(tBinEnd)));
+        tBinStart = tBinEnd;
+        if (binEnd <= idx) {
+            continue;
+        }
+
+        const MinMaxPyramid::Summary sum = pyramid.summarize(values, time.firstIndex(), idx, binEnd);
+        idx = binEnd;
+
+        // 同一像素列内先画时间早的点，再画时间晚的点
+        const bool minFirst = sum.minAt <= sum.maxAt;
+        out.first[std::size_t(px)] = minFirst ? sum.min : sum.max;
+        out.second[std::size_t(px)] = minFirst ? sum.max : sum.min;
+    }
+}
+
+void ViewportDownsampler::downsample(const ChannelBuffer &data, Column column, const TimeRange &xr,
+                                     int w, MinMaxColumns &out)
+{
+    const TimeAxis &time = data.time();
+    const SampleRing &values = columnValues(data, column);
+    const MinMaxPyramid &pyramid = columnPyramid(data, column);
+    const ColdStore &cold = data.cold();
+    if (cold.isEmpty() || xr.lower > cold.lastTime()) {
+        downsample(time, values, pyramid, xr, w, out);
+        return;
+    }
+
+    out.first.clear();
+    out.second.clear();
+    out.lower = xr.lower;
+    out.bin = (w > 0) ? (xr.upper - xr.lower) / w : 0.0;
+
+    const std::int64_t n = std::min<std::int64_t>(time.size(), std::int64_t(values.size()));
+    const std::int64_t h0 = std::min(n, time.lowerBound(xr.lower));
+    const std::int64_t h1 = std::min(n, time.upperBound(xr.upper));
+    const std::int64_t c0 = cold.lowerBound(xr.lower);
+    const std::int64_t c1 = cold.upperBound(xr.upper);
+    if (w <= 0 || drawsRaw((h1 - h0) + (c1 - c0), w)) {
+        return;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    out.first.assign(std::size_t(w), nan);
+    out.second.assign(std::size_t(w), nan);
+
+    // 冷数据在热窗口之前：比较先后时，热窗口的位置统一加上冷数据的样点数
+    const ColdStore::Column col = coldColumn(column);
+    const std::int64_t coldSize = cold.size();
+    double tBinStart = xr.lower;
+    std::int64_t ci = c0;
+    std::int64_t hi = h0;
+    for (int px = 0; px < w && (ci < c1 || hi < h1); ++px) {
+        const bool isLastBin = (px == w - 1);
+        const double tBinEnd = isLastBin ? xr.upper : (tBinStart + out.bin);
+        const std::int64_t cEnd = isLastBin ? c1 : std::max(ci, std::min(c1, cold.lowerBound(tBinEnd)));
+        const std::int64_t hEnd = isLastBin ? h1 : std::max(hi, std::min(h1, time.lowerBound(tBinEnd)));
+        tBinStart = tBinEnd;
+
+        double mn = nan, mx = nan;
+        std::int64_t mnAt = -1, mxAt = -1;
+        if (cEnd > ci) {
+            const ColdStore::Summary s = cold.summarize(col, ci, cEnd);
+            mn = s.min;
+            mx = s.max;
+            mnAt = s.minAt;
+            mxAt = s.maxAt;
+        }
+        if (hEnd > hi) {
+            const MinMaxPyramid::Summary s = pyramid.summarize(values, time.firstIndex(), hi, hEnd);
+            if (mnAt < 0 || std::isnan(mn) || s.min < mn) {
+                mn = s.min;
+                mnAt = coldSize + s.minAt;
+            }
+            if (mxAt < 0 || std::isnan(mx) || s.max > mx) {
+                mx = s.max;
+                mxAt = coldSize + s.maxAt;
+            }
+        }
+        ci = cEnd;
+        hi = hEnd;
+        if (mnAt < 0) {
+            continue;
+        }
+
+        const bool minFirst = mnAt <= mxAt;
+        out.first[std::size_t(px)] = minFirst ? mn : mx;
+        out.second[std::size_t(px)] = minFirst ? mx : mn;
+    }
+}
+
+void ViewportDownsampler::downsample(const CaptureFile &file, int channelId, Column column,
+                                     const TimeRange &xr, int w, MinMaxColumns &out)
+{
+    out.first.clear();
+    out.second.clear();
+    out.lower = xr.lower;
+    out.bin = (w > 0) ? (xr.upper - xr.lower) / w : 0.0;
+
+    const std::int64_t i0 = file.lowerBound(channelId, xr.lower);
+    const std::int64_t i1 = file.upperBound(channelId, xr.upper);
+    if (w <= 0 || drawsRaw(i1 - i0, w)) {
+        return;
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    out.first.assign(std::size_t(w), nan);
+    out.second.assign(std::size_t(w), nan);
+
+    const CaptureFile::Column col = fileColumn(column);
+    double tBinStart = xr.lower;
+    std::int64_t idx = i0;
+    for (int px = 0; px < w && idx < i1; ++px) {
+        const bool isLastBin = (px == w - 1);
+        const double tBinEnd = isLastBin ? xr.upper : (tBinStart + out.bin);
+        const std::int64_t binEnd = isLastBin ? i1 : std::max(idx, std::min(i1, file.lowerBound(channelId, tBinEnd)));
+        tBinStart = tBinEnd;
+        if (binEnd <= idx) {
+            continue;
+        }
+
+        const CaptureFile::Summary sum = file.summarize(channelId, col, idx, binEnd);
+        idx = binEnd;
+        if (sum.minAt < 0) {
+            continue;   // 列内全部为 NaN
+        }
+
+        const bool minFirst = sum.minAt <= sum.maxAt;
+        out.first[std::size_t(px)] = minFirst ? sum.min : sum.max;
+        out.second[std::size_t(px)] = minFirst ? sum.max : sum.min;
+    }
+}
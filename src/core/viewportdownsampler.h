@@ -0,0 +1,192 @@
+#ifndef VIEWPORTDOWNSAMPLER_H
+#define VIEWPORTDOWNSAMPLER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QMap>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "channelstore.h"
+
+/**
+ * @brief 时间范围 [lower, upper]（秒），即视口的 X 轴范围
+ */
+struct TimeRange {
+    double lower = 0.0;
+    double upper = 0.0;
+
+    TimeRange() = default;
+    TimeRange(double lower, double upper) : lower(lower), upper(upper) {}
+    double size() const { return upper - lower; }
+};
+
+/**
+ * @brief 一条曲线在某个视口下的逐像素列 Min-Max 汇总
+ *
+ * 第 c 列覆盖时间 [lower + c*bin, lower + (c+1)*bin)；first/second 为该列最值按时间先后
+ * 排列的两个值，列内没有样点时为 NaN。绘制时按列中心时间定位，不再保存逐点时间戳。
+ */
+struct MinMaxColumns {
+    double lower = 0.0;         // 第 0 列的起始时间
+    double bin = 0.0;           // 每列的时间跨度
+    std::vector<double> first;  // 列内较早出现的最值
+    std::vector<double> second; // 列内较晚出现的最值
+
+    int width() const { return int(first.size()); }
+    double columnCenter(int c) const { return lower + (c + 0.5) * bin; }
+};
+using MinMaxColumnsPtr = std::shared_ptr<const MinMaxColumns>;
+
+/**
+ * @brief 视口降采样器：在线程池中为各通道计算 Min-Max 绘制点
+ *
+ * - request()：GUI 线程提交某通道的降采样请求；同一通道同时只有一个任务在跑，
+ *   运行期间的新请求合并为一次“重跑”（取最新数据和视口）；
+ * - setViewport()：视口变化时推进代数（generation），旧代数的任务在列之间检查后提前放弃，
+ *   已完成的旧结果不会发布；
+ * - 结果以双缓冲发布：工作线程把 MinMaxColumns 写入后台缓冲并发出 resultsReady()，
+ *   GUI 线程调用 takeResults() 取走后只需把共享指针交给对应曲线（ChannelPlottable）并重绘。
+ */
+class ViewportDownsampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Column { Voltage, Current, Power };
+
+    /**
+     * @brief 一条待绘制曲线（通道由 request() 指定，曲线由通道和列确定）
+     */
+    struct Target {
+        Column column = Column::Voltage;
+        int width = 0;              // 绘图宽度（像素），决定 bin 数
+    };
+
+    /**
+     * @brief 一条曲线的降采样结果
+     */
+    struct Result {
+        int channelId = 0;
+        Column column = Column::Voltage;
+        quint64 generation = 0;
+        MinMaxColumnsPtr columns;
+    };
+
+    explicit ViewportDownsampler(QObject *parent = nullptr);
+    ~ViewportDownsampler() override;
+
+    /**
+     * @brief 设置当前视口（X 轴范围）；范围变化时作废所有进行中的任务
+     */
+    void setViewport(const TimeRange &range);
+
+    /**
+     * @brief 作废所有进行中的任务和未取走的结果（清空数据时调用）
+     */
+    void cancelAll();
+
+    /**
+     * @brief 提交一个通道的降采样请求（GUI 线程）
+     */
+    void request(int channelId, const ChannelSlotPtr &slot, const QVector<Target> &targets);
+
+    /**
+     * @brief 取走已完成的结果（GUI 线程），只返回当前代数的结果
+     */
+    void takeResults(std::vector<Result> &out);
+
+    /**
+     * @brief 累计完成的降采样轮次 / 工作线程耗时（纳秒），无锁计数，供性能统计采样
+     */
+    quint64 completedPasses() const { return m_passes.load(std::memory_order_relaxed); }
+    quint64 busyNs() const { return m_busyNs.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 通道数据中某一列的原始数据 / Min-Max 金字塔
+     */
+    static const SampleRing &columnValues(const ChannelBuffer &data, Column column);
+    static const MinMaxPyramid &columnPyramid(const ChannelBuffer &data, Column column);
+
+    /**
+     * @brief 可见样点数不超过每像素 kRawPointsPerPixel 个时直接绘制原始点，不需要降采样
+     */
+    static constexpr int kRawPointsPerPixel = 2;
+    static bool drawsRaw(std::int64_t visibleSamples, int width)
+    {
+        return visibleSamples <= std::int64_t(kRawPointsPerPixel) * width;
+    }
+
+    /**
+     * @brief Min-Max 降采样（同步版本，工作线程和基准测试直接调用）
+     *
+     * 将可视时间范围按像素宽度分成 w 列，每列求最小值和最大值（按时间先后写入 out）。
+     * 列边界通过 TimeAxis 定位，列内的最值由 Min/Max 金字塔汇总，总代价只与屏幕宽度成正比。
+     * 可见样点很少（drawsRaw() 为 true）时 out 为空，由绘制端直接读取原始数据。
+     */
+    static void downsample(const TimeAxis &time, const SampleRing &values,
+                           const MinMaxPyramid &pyramid, const TimeRange &xr, int w,
+                           MinMaxColumns &out);
+
+    /**
+     * @brief 同上，整个通道：视口覆盖冷数据时，冷数据部分的列由 ColdStore 的块摘要汇总
+     */
+    static void downsample(const ChannelBuffer &data, Column column, const TimeRange &xr, int w,
+                           MinMaxColumns &out);
+
+    /**
+     * @brief 同上，数据来自采集文件：列内的最值由块摘要汇总，只有列边界附近读取原始样点
+     */
+    static void downsample(const CaptureFile &file, int channelId, Column column,
+                           const TimeRange &xr, int w, MinMaxColumns &out);
+
+    static ColdStore::Column coldColumn(Column column)
+    {
+        return (column == Column::Voltage) ? ColdStore::Column::Voltage
+             : (column == Column::Current) ? ColdStore::Column::Current
+                                           : ColdStore::Column::Power;
+    }
+
+    static CaptureFile::Column fileColumn(Column column)
+    {
+        return (column == Column::Voltage) ? CaptureFile::Column::Voltage
+             : (column == Column::Current) ? CaptureFile::Column::Current
+                                           : CaptureFile::Column::Power;
+    }
+
+signals:
+    /**
+     * @brief 有新结果可取（由工作线程发出，经队列连接在 GUI 线程处理；取走前只发一次）
+     */
+    void resultsReady();
+
+private:
+    class Job;
+
+    /**
+     * @brief 每个通道的任务状态（受 m_mutex 保护）
+     */
+    struct ChannelState {
+        bool running = false;       // 是否有任务在执行
+        bool rerun = false;         // 执行期间是否收到了新请求
+        ChannelSlotPtr slot;
+        QVector<Target> targets;
+    };
+
+    void runChannel(int channelId);     // 工作线程：循环处理某通道直到没有新请求
+
+    QThreadPool m_pool;
+    std::atomic<quint64> m_generation{0};
+    std::atomic<quint64> m_passes{0};     // 统计：完成的降采样轮次
+    std::atomic<quint64> m_busyNs{0};     // 统计：降采样累计耗时
+
+    std::mutex m_mutex;                 // 保护以下成员
+    TimeRange m_range;
+    QMap<int, ChannelState> m_channels;
+    std::vector<Result> m_back;         // 后台缓冲：已完成、尚未被 GUI 取走的结果
+    bool m_notified = false;            // 已发出 resultsReady 且尚未被取走
+};
+
+#endif // VIEWPORTDOWNSAMPLER_H
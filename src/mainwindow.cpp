@@ -1,13 +1,34 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "modules/WaveformView/waveformwidget.h"
+#include "samplequeue.h"
+#include "daqsimulator.h"
+#include "acquisitioncontroller.h"
+#include "capturefilewriter.h"
+#include "tracer.h"
+#include "asynclogger.h"
 #include <QCheckBox>
 #include <QHBoxLayout>
 #include <QTableWidget>
 #include <QTableWidgetItem>
 #include <QHeaderView>
 #include <QCheckBox>
-#include <QDebug>
+#include <algorithm>
+#include <QMenu>
+#include <QActionGroup>
+#include <QDateTime>
+#include <QSignalBlocker>
+#include <QDir>
+#include <QFileDialog>
+#include <QStandardPaths>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QSpinBox>
+#include <cmath>
+#include <functional>
+#include <limits>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -16,15 +37,22 @@ MainWindow::MainWindow(QWidget *parent)
     ui->setupUi(this);
     initChannelTable();
     wireChannelToggles();
+    initAcquisitionControls();
+    initSampleRateMenu();
+    initFileMenu();
+    initTriggerMenu();
 
-    // 启动测试：3个通道，全部显示
-    startWaveformTest(50);
-    configureAllChannelsDisplay(3, true);
+    // 默认数据源：模拟器，4个通道（与通道表对应），100 kS/s，全部显示；点击“开始”采集
+    startWaveformTest(4, 100e3);
+    configureAllChannelsDisplay(4, true);
 
 }
 
 MainWindow::~MainWindow()
 {
+    // 先停止采集线程，再销毁它投递数据的波形控件
+    delete m_acquisition;
+    delete m_recorder;
     delete ui;
 }
 
@@ -43,14 +71,14 @@ void MainWindow::initChannelTable()
     QTableWidget *table = ui->tableChannels;
 
     // 1. 基础属性设置
-    table->setColumnCount(4);
+    table->setColumnCount(5);
     table->verticalHeader()->setVisible(false);       // 隐藏行号
     table->setSelectionBehavior(QAbstractItemView::SelectRows); // 选中整行
     table->setSelectionMode(QAbstractItemView::SingleSelection); // 单选
 
     // 设置表头文字
     QStringList headers;
-    headers << "通道信息" << "I" << "V" << "P";
+    headers << "通道信息" << "I" << "V" << "P" << "累计";
     table->setHorizontalHeaderLabels(headers);
 
     // 2. 关键：设置列宽自适应策略
@@ -69,6 +97,9 @@ void MainWindow::initChannelTable()
     table->setColumnWidth(2, 35);
     table->setColumnWidth(3, 35);
 
+    // 第4列 (电荷量/能量累计): 按内容宽度
+    header->setSectionResizeMode(4, QHeaderView::ResizeToContents);
+
     // 3. 准备数据 (模拟 4 个通道)
     struct ChannelData {
         QString name;
@@ -102,6 +133,21 @@ void MainWindow::initChannelTable()
         table->setCellWidget(row, 1, createCenteredCheckBox()); // I (电流)
         table->setCellWidget(row, 2, createCenteredCheckBox()); // V (电压)
         table->setCellWidget(row, 3, createCenteredCheckBox()); // P (功率)
+
+        // --- 第4列：电荷量 / 能量累计（由定时器刷新） ---
+        QTableWidgetItem *totals = new QTableWidgetItem();
+        totals->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        totals->setFlags(totals->flags() & ~Qt::ItemIsEditable);
+        table->setItem(row, 4, totals);
+    }
+    updateChannelTotals();
+
+    // 累计值在数据写入时积分，这里只按固定间隔读取显示
+    if (!m_totalsTimer) {
+        m_totalsTimer = new QTimer(this);
+        m_totalsTimer->setInterval(250);
+        connect(m_totalsTimer, &QTimer::timeout, this, &MainWindow::updateChannelTotals);
+        m_totalsTimer->start();
     }
 
     // 5. 设置默认行高
@@ -111,6 +157,32 @@ void MainWindow::initChannelTable()
     // =========================================================
 }
 
+// =========================================================
+//  刷新通道表中的电荷量 / 能量累计（mAh / mWh）
+//  纯采集模式的数据不进入波形控件，累计值由落盘接收端在写入时积分
+// =========================================================
+void MainWindow::updateChannelTotals()
+{
+    QTableWidget *table = ui->tableChannels;
+    if (!table || !ui->waveformContainer) return;
+
+    const bool fromRecorder = m_captureOnly && m_recorder;
+    ChannelIntegrator snapshot;
+    for (int r = 0; r < table->rowCount(); ++r) {
+        QTableWidgetItem *item = table->item(r, 4);
+        if (!item) continue;
+        const ChannelIntegrator *integrator = nullptr;
+        if (fromRecorder) {
+            integrator = m_recorder->integrator(r, snapshot) ? &snapshot : nullptr;
+        } else {
+            integrator = ui->waveformContainer->channelIntegrator(r);
+        }
+        const double charge = integrator ? integrator->chargeMilliampHours() : 0.0;
+        const double energy = integrator ? integrator->energyMilliwattHours() : 0.0;
+        item->setText(QString("%1 mAh\n%2 mWh").arg(charge, 0, 'f', 3).arg(energy, 0, 'f', 3));
+    }
+}
+
 void MainWindow::wireChannelToggles()
 {
 
@@ -140,7 +212,7 @@ void MainWindow::wireChannelToggles()
         ui->waveformContainer->setPowerVisible(anyP);
         
         // 使用新接口：为每个通道单独设置显示状态
-        for (int r = 0; r < table->rowCount() && r < WaveformWidget::kChannelCount; ++r) {
+        for (int r = 0; r < table->rowCount(); ++r) {
             auto cbI = getCheckBoxAt(r, 1);
             auto cbV = getCheckBoxAt(r, 2);
             auto cbP = getCheckBoxAt(r, 3);
@@ -193,50 +265,519 @@ QWidget* MainWindow::createCenteredCheckBox()
 // =========================================================
 
 /**
- * @brief 启动波形测试数据生成
- * @param channelCount 要测试的通道数量（1-10）
- * @param updateInterval 更新间隔（毫秒），默认33ms（约30Hz）
+ * @brief 使用模拟器作为数据源（正在采集时以新参数重新开始）
+ * @param channelCount 要测试的通道数量（1-256，超出波形控件通道数的部分不显示）
+ * @param sampleRate 每通道采样率（1 kS/s - 2 MS/s）
  */
-void MainWindow::startWaveformTest(int channelCount, int updateInterval)
+void MainWindow::startWaveformTest(int channelCount, double sampleRate)
 {
-    if (!ui->waveformContainer) {
-        qDebug() << "错误：waveformContainer 未初始化";
+    if (!ui->waveformContainer || !m_acquisition) {
+        POWERDAQ_LOG(LogLevel::Error, "waveformContainer 未初始化");
         return;
     }
     
     // 限制通道数量范围
-    m_testChannelCount = qBound(1, channelCount, 10);
-    
-    // 停止之前的测试（如果存在）
-    stopWaveformTest();
+    m_testChannelCount = qBound(1, channelCount, SimulatorConfig::kMaxChannels);
     
-    // 清空之前的数据
-    ui->waveformContainer->clear();
-    m_testTime = 0.0;
+    const bool restart = m_acquisition->isActive();
+    stopAcquisition();
     
-    // 创建定时器
-    m_testTimer = new QTimer(this);
-    m_testTimer->setInterval(updateInterval);
-    connect(m_testTimer, &QTimer::timeout, this, &MainWindow::generateTestData);
+    SimulatorConfig config;
+    config.channelCount = m_testChannelCount;
+    config.sampleRate = sampleRate;
+    DaqSimulator *simulator = new DaqSimulator(config);
+    m_testSampleRate = simulator->config().sampleRate;
+    m_acquisition->setSource(std::unique_ptr<IDataSource>(simulator));
+    ui->btnSampleRate->setText(QString("采样率 %1").arg(formatSampleRate(m_testSampleRate)));
     
-    // 启动定时器
-    m_testTimer->start();
+    POWERDAQ_LOG(LogLevel::Info, QString("数据源：模拟器，%1 个通道，每通道 %2")
+                 .arg(m_testChannelCount).arg(formatSampleRate(m_testSampleRate)));
     
-    qDebug() << QString("启动波形测试：%1 个通道，更新间隔 %2 ms").arg(m_testChannelCount).arg(updateInterval);
+    if (restart) {
+        startAcquisition();
+    }
+}
+
+// =========================================================
+//  采集控制：开始 / 暂停 / 停止
+// =========================================================
+void MainWindow::initAcquisitionControls()
+{
+    m_acquisition = new AcquisitionController(ui->waveformContainer->sampleQueue());
+
+    connect(ui->btnStart, &QPushButton::clicked, this, &MainWindow::startAcquisition);
+    connect(ui->btnPause, &QPushButton::clicked, this, &MainWindow::pauseAcquisition);
+    connect(ui->btnStop, &QPushButton::clicked, this, &MainWindow::stopAcquisition);
+
+    // 纯采集模式：只在停止状态下切换
+    ui->btnCaptureMode->setCheckable(true);
+    connect(ui->btnCaptureMode, &QPushButton::toggled, this, &MainWindow::setCaptureOnly);
+
+    // 数据源可能自行结束（如回放到文件末尾），定时检查并刷新状态栏统计
+    m_acquisitionTimer = new QTimer(this);
+    m_acquisitionTimer->setInterval(250);
+    connect(m_acquisitionTimer, &QTimer::timeout, this, &MainWindow::pollAcquisition);
+
+    updateAcquisitionButtons();
+}
+
+/**
+ * @brief 开始采集（空闲时清空旧数据从头开始；暂停时继续）
+ */
+void MainWindow::startAcquisition()
+{
+    if (!m_acquisition) return;
+
+    if (m_acquisition->isPaused()) {
+        m_acquisition->resume();
+        ui->waveformContainer->setDisplayPaused(false);
+    } else if (!m_acquisition->isActive()) {
+        if (m_captureOnly && !openCaptureFile()) {
+            return;
+        }
+        // 数据源的时间轴从 0 开始（正在查看的采集文件一并关闭）
+        ui->waveformContainer->closeCaptureFile();
+        ui->waveformContainer->clear();
+        if (!m_acquisition->start()) {
+            ui->statusbar->showMessage("数据源打开失败");
+            if (m_captureOnly) {
+                m_recorder->close();
+            }
+            return;
+        }
+        m_captureClock.start();
+        m_captureLastBytes = 0;
+        m_acquisitionTimer->setInterval(m_captureOnly ? 500 : 250);
+        m_acquisitionTimer->start();
+        POWERDAQ_LOG(LogLevel::Info, "开始采集：" + m_acquisition->source()->name());
+    }
+    updateAcquisitionButtons();
 }
 
 /**
- * @brief 停止波形测试数据生成
+ * @brief 暂停 / 继续：暂停期间数据照常写入缓冲，只是显示不再刷新
  */
-void MainWindow::stopWaveformTest()
+void MainWindow::pauseAcquisition()
 {
-    if (m_testTimer) {
-        m_testTimer->stop();
-        m_testTimer->deleteLater();
-        m_testTimer = nullptr;
+    if (!m_acquisition) return;
+
+    if (m_acquisition->isPaused()) {
+        startAcquisition();
+        return;
+    }
+    if (m_acquisition->state() == AcquisitionController::State::Running) {
+        m_acquisition->pause();
+        ui->waveformContainer->setDisplayPaused(true);
+        updateAcquisitionButtons();
     }
-    m_testTime = 0.0;
-    qDebug() << "停止波形测试";
+}
+
+/**
+ * @brief 停止采集：结束采集线程，取完队列中剩余的数据并刷新显示
+ */
+void MainWindow::stopAcquisition()
+{
+    if (!m_acquisition || !m_acquisition->isActive()) return;
+
+    m_acquisition->stop();
+    m_acquisitionTimer->stop();
+    ui->waveformContainer->flushSampleQueue();
+    ui->waveformContainer->setDisplayPaused(m_captureOnly);
+
+    const AcquisitionStats stats = m_acquisition->stats();
+    POWERDAQ_LOGF(LogLevel::Info, "停止采集：已投递 %llu 个样点，丢弃 %llu 个",
+                  static_cast<unsigned long long>(stats.deliveredSamples),
+                  static_cast<unsigned long long>(stats.droppedSamples));
+    updateAcquisitionButtons();
+
+    if (m_captureOnly && m_recorder->isOpen()) {
+        const bool ok = m_recorder->close();
+        const QString file = QString::fromLocal8Bit(m_recorder->path().c_str());
+        ui->statusbar->showMessage(ok
+            ? QString("已保存 %1（%2 点，%3 MB）").arg(file).arg(m_recorder->recordedSamples())
+                  .arg(m_recorder->bytesFlushed() / 1048576.0, 0, 'f', 1)
+            : QString("写入 %1 失败（磁盘已满或不可写）").arg(file));
+    }
+}
+
+void MainWindow::pollAcquisition()
+{
+    if (!m_acquisition) return;
+
+    if (m_acquisition->finished()) {
+        stopAcquisition();
+        return;
+    }
+    const AcquisitionStats stats = m_acquisition->stats();
+    if (m_captureOnly) {
+        // 纯采集模式只显示低频统计：写盘速率、已写样点、丢弃、写盘等待
+        const std::uint64_t bytes = m_recorder->bytesWritten();
+        const double seconds = std::max(1e-3, m_captureClock.restart() / 1000.0);
+        const double rate = (bytes - m_captureLastBytes) / seconds / 1048576.0;
+        m_captureLastBytes = bytes;
+        ui->statusbar->showMessage(QString("纯采集  %1 MB/s  已写 %2 点 / %3 MB  丢弃 %4 点  写盘等待 %5 次%6")
+                                   .arg(rate, 0, 'f', 1)
+                                   .arg(m_recorder->recordedSamples())
+                                   .arg(bytes / 1048576.0, 0, 'f', 1)
+                                   .arg(stats.droppedSamples)
+                                   .arg(m_recorder->stalls())
+                                   .arg(m_recorder->failed() ? "  写盘失败" : ""));
+        return;
+    }
+    ui->statusbar->showMessage(QString("%1  已采集 %2 点  丢弃 %3 点  队列 %4 块%5")
+                               .arg(m_acquisition->isPaused() ? "已暂停（缓冲中）" : "采集中")
+                               .arg(stats.deliveredSamples).arg(stats.droppedSamples)
+                               .arg(stats.queuedBlocks).arg(triggerStatus()));
+}
+
+void MainWindow::updateAcquisitionButtons()
+{
+    const bool active = m_acquisition && m_acquisition->isActive();
+    const bool paused = m_acquisition && m_acquisition->isPaused();
+    ui->btnStart->setEnabled(!active || paused);
+    ui->btnPause->setEnabled(active);
+    ui->btnPause->setText(paused ? "继续" : "暂停");
+    ui->btnStop->setEnabled(active);
+    ui->btnCaptureMode->setEnabled(!active);
+    if (m_captureOnly) {
+        ui->btnPause->setEnabled(false);    // 纯采集没有显示可暂停
+    }
+    if (!active) {
+        ui->statusbar->showMessage("已停止");
+    }
+}
+
+/**
+ * @brief 纯采集模式：数据块从数据源直接顺序写盘，波形显示暂停，只显示低频统计
+ */
+void MainWindow::setCaptureOnly(bool enabled)
+{
+    if (!m_acquisition || m_acquisition->isActive()) {
+        // 采集中不切换，按钮状态还原
+        QSignalBlocker blocker(ui->btnCaptureMode);
+        ui->btnCaptureMode->setChecked(m_captureOnly);
+        return;
+    }
+    if (!m_recorder) {
+        m_recorder = new CaptureFileWriter;
+    }
+    m_captureOnly = enabled;
+    m_acquisition->setCaptureSink(enabled ? m_recorder : nullptr);
+    ui->waveformContainer->setDisplayPaused(enabled);
+    updateAcquisitionButtons();
+    updateChannelTotals();          // 累计值的来源随模式切换
+}
+
+/**
+ * @brief 选择并打开纯采集的输出文件
+ */
+bool MainWindow::openCaptureFile()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/PowerDAQ";
+    QDir().mkpath(dir);
+    const QString suggested = QString("%1/capture_%2.pdaq")
+        .arg(dir, QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    const QString path = QFileDialog::getSaveFileName(this, "纯采集：保存到", suggested,
+                                                      "PowerDAQ 采集文件 (*.pdaq)");
+    if (path.isEmpty()) {
+        return false;
+    }
+    if (!m_recorder->open(QFile::encodeName(path).toStdString())) {
+        ui->statusbar->showMessage(QString("无法创建 %1").arg(path));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 文件菜单：打开已保存的采集文件查看 / 返回实时数据 / 性能统计浮层（F3）/ 条带图
+ */
+void MainWindow::initFileMenu()
+{
+    QMenu *menu = new QMenu(ui->btnFile);
+    menu->addAction("打开采集文件...", this, &MainWindow::viewCaptureFile);
+    menu->addAction("返回实时波形", this, [this]() {
+        ui->waveformContainer->closeCaptureFile();
+    });
+    menu->addSeparator();
+    QAction *hud = menu->addAction("性能统计浮层");
+    hud->setCheckable(true);
+    hud->setShortcut(Qt::Key_F3);
+    connect(hud, &QAction::toggled, ui->waveformContainer, &WaveformWidget::setPerfHudVisible);
+    addAction(hud);     // 菜单未弹出时快捷键也有效
+
+    // 条带图：自动跟随时只绘制新到达的像素列（关闭后每帧按整个视口绘制，便于对比）
+    QAction *strip = menu->addAction("滚动绘制（条带图）");
+    strip->setCheckable(true);
+    strip->setChecked(ui->waveformContainer->isStripChartEnabled());
+    connect(strip, &QAction::toggled, ui->waveformContainer, &WaveformWidget::setStripChartEnabled);
+
+    // 时间线：记录各线程上写入 / 降采样 / 重绘 / 落盘的区间，导出后在 chrome://tracing 或 Perfetto 中查看
+    QAction *trace = menu->addAction("记录时间线");
+    trace->setCheckable(true);
+    connect(trace, &QAction::toggled, this, [](bool on) {
+        if (on) {
+            Tracer::clear();
+        }
+        Tracer::setEnabled(on);
+    });
+    menu->addAction("导出时间线...", this, &MainWindow::exportTrace);
+    ui->btnFile->setMenu(menu);
+}
+
+/**
+ * @brief 导出时间线：把各线程最近的区间记录写成 Chrome trace JSON
+ */
+void MainWindow::exportTrace()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/PowerDAQ";
+    QDir().mkpath(dir);
+    const QString name = QDateTime::currentDateTime().toString("'trace_'yyyyMMdd_HHmmss'.json'");
+    const QString path = QFileDialog::getSaveFileName(this, "导出时间线", dir + "/" + name,
+                                                      "Chrome Trace (*.json)");
+    if (path.isEmpty()) {
+        return;
+    }
+    std::string error;
+    if (!Tracer::writeChromeTrace(QFile::encodeName(path).toStdString(), &error)) {
+        ui->statusbar->showMessage(QString("无法写入 %1：%2").arg(path, QString::fromLocal8Bit(error.c_str())));
+        return;
+    }
+    ui->statusbar->showMessage(QString("已导出时间线 %1%2").arg(path)
+                               .arg(Tracer::isEnabled() ? "" : "（未开启记录时只包含之前记录的区间）"));
+}
+
+/**
+ * @brief 打开采集文件：文件内存映射，波形直接从文件绘制（采集可以继续在后台进行）
+ */
+void MainWindow::viewCaptureFile()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/PowerDAQ";
+    const QString path = QFileDialog::getOpenFileName(this, "打开采集文件", dir,
+                                                      "PowerDAQ 采集文件 (*.pdaq)");
+    if (path.isEmpty()) {
+        return;
+    }
+    QString error;
+    if (!ui->waveformContainer->openCaptureFile(path, &error)) {
+        ui->statusbar->showMessage(QString("无法打开 %1：%2").arg(path, error));
+        return;
+    }
+    const CaptureFilePtr file = ui->waveformContainer->captureFile();
+    ui->statusbar->showMessage(QString("查看 %1（%2 MB%3）").arg(path)
+                               .arg(file->fileSize() / 1048576.0, 0, 'f', 1)
+                               .arg(file->isRecovered() ? "，文件未正常结束，已按数据块恢复" : ""));
+}
+
+/**
+ * @brief 触发菜单：触发条件（类型 / 极性 / 通道 / 触发源 / 模式 / 门限）、启动 / 停止、翻看采集段
+ *
+ * 触发在数据写入时检测（与显示是否暂停无关）；纯采集模式的数据不经过波形控件，不参与触发。
+ */
+void MainWindow::initTriggerMenu()
+{
+    WaveformWidget *wave = ui->waveformContainer;
+    QMenu *menu = new QMenu(ui->btnTrigger);
+
+    // 单选子菜单：选中后修改当前设置的一项并立即生效
+    auto addChoices = [this, wave, menu](const QString &title, const QStringList &names, int current,
+                                         std::function<void(TriggerSettings &, int)> apply) {
+        QMenu *sub = menu->addMenu(title);
+        QActionGroup *group = new QActionGroup(sub);
+        for (int k = 0; k < names.size(); ++k) {
+            QAction *action = sub->addAction(names[k]);
+            action->setCheckable(true);
+            action->setChecked(k == current);
+            group->addAction(action);
+            connect(action, &QAction::triggered, this, [wave, apply, k]() {
+                TriggerSettings settings = wave->triggerSettings();
+                apply(settings, k);
+                wave->setTriggerSettings(settings);
+            });
+        }
+    };
+
+    const TriggerSettings &settings = wave->triggerSettings();
+    addChoices("类型", {"边沿", "电平", "窗口", "脉宽", "欠幅"}, int(settings.type),
+               [](TriggerSettings &s, int k) { s.type = TriggerSettings::Type(k); });
+    addChoices("极性", {"正向（上升沿 / 高于 / 离开窗口）", "负向（下降沿 / 低于 / 进入窗口）"},
+               int(settings.polarity),
+               [](TriggerSettings &s, int k) { s.polarity = TriggerSettings::Polarity(k); });
+    QStringList channels;
+    for (int r = 0; r < ui->tableChannels->rowCount(); ++r) {
+        channels << QString("通道%1").arg(r + 1);
+    }
+    addChoices("通道", channels, settings.channelId,
+               [](TriggerSettings &s, int k) { s.channelId = k; });
+    addChoices("触发源", {"电压", "电流", "功率"}, int(settings.source),
+               [](TriggerSettings &s, int k) { s.source = TriggerSettings::Source(k); });
+    addChoices("模式", {"单次", "正常", "自动"}, int(settings.mode),
+               [](TriggerSettings &s, int k) { s.mode = TriggerSettings::Mode(k); });
+    menu->addAction("门限与采集长度...", this, &MainWindow::editTriggerThresholds);
+
+    menu->addSeparator();
+    menu->addAction("启动触发", this, [this, wave]() {
+        wave->armTrigger();
+        updateTriggerButton();
+    });
+    menu->addAction("停止触发", this, [this, wave]() {
+        wave->stopTrigger();
+        updateTriggerButton();
+    });
+
+    menu->addSeparator();
+    menu->addAction("上一段", this, [wave]() { wave->stepTriggerCapture(-1); });
+    menu->addAction("下一段", this, [wave]() { wave->stepTriggerCapture(1); });
+    menu->addAction("返回实时波形", wave, &WaveformWidget::showLive);
+    ui->btnTrigger->setMenu(menu);
+
+    connect(wave, &WaveformWidget::triggerCaptured, this, &MainWindow::onTriggerCaptured);
+    updateTriggerButton();
+}
+
+/**
+ * @brief 门限设置对话框（只显示与当前触发类型相关的项）
+ */
+void MainWindow::editTriggerThresholds()
+{
+    WaveformWidget *wave = ui->waveformContainer;
+    TriggerSettings settings = wave->triggerSettings();
+    static const char *const units[] = {"V", "A", "W"};
+    const QString unit = units[int(settings.source)];
+    const TriggerSettings::Type type = settings.type;
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("触发门限");
+    QFormLayout *form = new QFormLayout(&dialog);
+    auto addValue = [&dialog, form](const QString &label, double value, const QString &suffix) {
+        QDoubleSpinBox *box = new QDoubleSpinBox(&dialog);
+        box->setRange(-1e6, 1e6);
+        box->setDecimals(6);
+        box->setValue(value);
+        box->setSuffix(" " + suffix);
+        form->addRow(label, box);
+        return box;
+    };
+    auto addCount = [&dialog, form](const QString &label, std::size_t value) {
+        QSpinBox *box = new QSpinBox(&dialog);
+        box->setRange(1, 10000000);
+        box->setValue(int(std::min<std::size_t>(value, 10000000)));
+        form->addRow(label, box);
+        return box;
+    };
+
+    const bool usesLevel = type == TriggerSettings::Type::Edge || type == TriggerSettings::Type::Level
+        || type == TriggerSettings::Type::PulseWidth;
+    const bool usesWindow = type == TriggerSettings::Type::Window || type == TriggerSettings::Type::Runt;
+    QDoubleSpinBox *level = usesLevel ? addValue("门限", settings.level, unit) : nullptr;
+    QDoubleSpinBox *hysteresis = (type == TriggerSettings::Type::Edge)
+        ? addValue("迟滞", settings.hysteresis, unit) : nullptr;
+    QDoubleSpinBox *low = usesWindow ? addValue("下门限", settings.low, unit) : nullptr;
+    QDoubleSpinBox *high = usesWindow ? addValue("上门限", settings.high, unit) : nullptr;
+    QDoubleSpinBox *minWidth = nullptr;
+    QDoubleSpinBox *maxWidth = nullptr;
+    if (type == TriggerSettings::Type::PulseWidth) {
+        // 最大脉宽为 0 表示不限
+        minWidth = addValue("最小脉宽", settings.minWidth * 1e3, "ms");
+        maxWidth = addValue("最大脉宽（0 = 不限）",
+                            std::isinf(settings.maxWidth) ? 0.0 : settings.maxWidth * 1e3, "ms");
+    }
+    QDoubleSpinBox *holdoff = addValue("触发间隔（holdoff）", settings.holdoff * 1e3, "ms");
+    QDoubleSpinBox *autoTimeout = (settings.mode == TriggerSettings::Mode::Auto)
+        ? addValue("自动模式超时", settings.autoTimeout * 1e3, "ms") : nullptr;
+    QSpinBox *pre = addCount("触发前样点数", settings.preTriggerSamples);
+    QSpinBox *post = addCount("触发后样点数", settings.postTriggerSamples);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    form->addRow(buttons);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    if (level) settings.level = level->value();
+    if (hysteresis) settings.hysteresis = hysteresis->value();
+    if (low) settings.low = low->value();
+    if (high) settings.high = high->value();
+    if (minWidth) settings.minWidth = std::max(0.0, minWidth->value() / 1e3);
+    if (maxWidth) {
+        settings.maxWidth = maxWidth->value() > 0.0 ? maxWidth->value() / 1e3
+                                                    : std::numeric_limits<double>::infinity();
+    }
+    settings.holdoff = std::max(0.0, holdoff->value() / 1e3);
+    if (autoTimeout) settings.autoTimeout = std::max(1e-3, autoTimeout->value() / 1e3);
+    settings.preTriggerSamples = std::size_t(pre->value());
+    settings.postTriggerSamples = std::size_t(post->value());
+    wave->setTriggerSettings(settings);
+}
+
+/**
+ * @brief 新的采集段完成：单次模式下直接查看该段，其余模式只在状态栏提示
+ */
+void MainWindow::onTriggerCaptured(int index)
+{
+    WaveformWidget *wave = ui->waveformContainer;
+    const TriggerCapturePtr capture = wave->triggerCapture(index);
+    if (!capture) return;
+
+    if (wave->triggerSettings().mode == TriggerSettings::Mode::Single) {
+        wave->showTriggerCapture(index);
+    }
+    ui->statusbar->showMessage(QString("触发 #%1：通道%2  t = %3 s%4")
+                               .arg(capture->sequence).arg(capture->channelId + 1)
+                               .arg(capture->triggerTime, 0, 'f', 6)
+                               .arg(capture->forced ? "（自动模式超时）" : ""));
+    updateTriggerButton();
+}
+
+void MainWindow::updateTriggerButton()
+{
+    ui->btnTrigger->setText(ui->waveformContainer->isTriggerArmed() ? "触发（监测中）" : "触发");
+}
+
+QString MainWindow::triggerStatus() const
+{
+    const WaveformWidget *wave = ui->waveformContainer;
+    const int count = wave->triggerCaptureCount();
+    if (!wave->isTriggerArmed() && count == 0) {
+        return QString();
+    }
+    const int shown = wave->shownTriggerCapture();
+    return QString("  触发%1 %2 段%3").arg(wave->isTriggerArmed() ? "监测中" : "已停止").arg(count)
+        .arg(shown >= 0 ? QString("（查看第 %1 段）").arg(shown + 1) : QString());
+}
+
+/**
+ * @brief 采样率菜单：点击“采样率”按钮选择模拟器的每通道采样率
+ */
+void MainWindow::initSampleRateMenu()
+{
+    static const double rates[] = {1e3, 10e3, 100e3, 500e3, 1e6, 2e6};
+
+    QMenu *menu = new QMenu(ui->btnSampleRate);
+    QActionGroup *group = new QActionGroup(menu);
+    for (double rate : rates) {
+        QAction *action = menu->addAction(formatSampleRate(rate));
+        action->setCheckable(true);
+        action->setChecked(rate == m_testSampleRate);
+        group->addAction(action);
+        connect(action, &QAction::triggered, this, [this, rate]() {
+            startWaveformTest(m_testChannelCount, rate);
+        });
+    }
+    ui->btnSampleRate->setMenu(menu);
+}
+
+QString MainWindow::formatSampleRate(double rate)
+{
+    if (rate >= 1e6) {
+        return QString("%1 MS/s").arg(rate / 1e6);
+    }
+    if (rate >= 1e3) {
+        return QString("%1 kS/s").arg(rate / 1e3);
+    }
+    return QString("%1 S/s").arg(rate);
 }
 
 /**
@@ -252,8 +793,9 @@ void MainWindow::configureChannelDisplay(int channelId, bool showVoltage, bool s
         return;
     }
     
-    if (channelId < 0 || channelId >= 10) {
-        qDebug() << QString("错误：通道ID %1 超出范围（0-9）").arg(channelId);
+    const int maxChannels = ui->waveformContainer->maxChannels();
+    if (channelId < 0 || channelId >= maxChannels) {
+        POWERDAQ_LOGF(LogLevel::Warn, "通道ID %d 超出范围（0-%d）", channelId, maxChannels - 1);
         return;
     }
     
@@ -265,9 +807,8 @@ void MainWindow::configureChannelDisplay(int channelId, bool showVoltage, bool s
     // 应用到波形显示模块
     ui->waveformContainer->setChannelVisible(channelId, showVoltage, showCurrent, showPower);
     
-    qDebug() << QString("配置通道 %1：V=%2, I=%3, P=%4")
-                .arg(channelId)
-                .arg(showVoltage ? "显示" : "隐藏", showCurrent ? "显示" : "隐藏", showPower ? "显示" : "隐藏");
+    POWERDAQ_LOGF(LogLevel::Debug, "配置通道 %d：V=%s, I=%s, P=%s", channelId,
+                  showVoltage ? "显示" : "隐藏", showCurrent ? "显示" : "隐藏", showPower ? "显示" : "隐藏");
 }
 
 /**
@@ -281,7 +822,7 @@ void MainWindow::configureAllChannelsDisplay(int channelCount, bool defaultShowA
         return;
     }
     
-    int count = qBound(1, channelCount, 10);
+    int count = qBound(1, channelCount, ui->waveformContainer->maxChannels());
     
     for (int i = 0; i < count; ++i) {
         if (defaultShowAll) {
@@ -293,59 +834,5 @@ void MainWindow::configureAllChannelsDisplay(int channelCount, bool defaultShowA
         }
     }
     
-    qDebug() << QString("配置 %1 个通道：%2")
-                .arg(count)
-                .arg(defaultShowAll ? "全部显示" : "只显示电压");
-}
-
-/**
- * @brief 生成测试数据（定时器回调函数）
- */
-void MainWindow::generateTestData()
-{
-    if (!ui->waveformContainer || !m_testTimer) {
-        return;
-    }
-    
-    // 模拟生成物理量：20 kHz 的正弦/余弦波
-    const double freqHz = 20000.0;                 // 信号频率：20 kHz
-    const double omega  = 2.0 * M_PI * freqHz;     // 角频率 ω = 2πf
-    
-    // 创建多通道数据包
-    WaveformWidget::MultiChannelData multiData;
-    
-    // 为每个通道生成数据
-    for (int ch = 0; ch < m_testChannelCount; ++ch) {
-        // 每个通道使用不同的频率倍数和幅值，便于区分
-        double freqMultiplier = 0.8 + ch * 0.3;  // 0.8, 1.1, 1.4, 1.7, ...
-        double voltageAmplitude = 2.0 + ch * 0.5; // 2.0, 2.5, 3.0, 3.5, ...
-        double currentAmplitude = 0.5 + ch * 0.2; // 0.5, 0.7, 0.9, 1.1, ...
-        double voltageOffset = 2.0 + ch * 0.3;   // 2.0, 2.3, 2.6, 2.9, ...
-        double currentOffset = 0.5 + ch * 0.15;    // 0.5, 0.65, 0.8, 0.95, ...
-        
-        // 生成电压：正弦波 + 噪声
-        double voltage = voltageAmplitude * qSin(omega * m_testTime * freqMultiplier) + voltageOffset;
-        double voltageNoise = QRandomGenerator::global()->generateDouble() * 0.1;
-        voltage += voltageNoise;
-        
-        // 生成电流：余弦波 + 噪声
-        double current = currentAmplitude * qCos(omega * m_testTime * freqMultiplier * 1.1) + currentOffset;
-        double currentNoise = QRandomGenerator::global()->generateDouble() * 0.15;
-        current += currentNoise;
-        
-        // 添加到数据包（功率自动计算）
-        multiData.channelData[ch] = {
-            m_testTime,  // time
-            voltage,     // voltage
-            current,     // current
-            NAN          // power: 自动计算
-        };
-    }
-    
-    // 使用新的多通道接口添加数据
-    ui->waveformContainer->addChannelData(multiData);
-    
-    // 时间推移（从定时器间隔计算）
-    double timeStep = m_testTimer->interval() / 1000.0;
-    m_testTime += timeStep;
+    POWERDAQ_LOGF(LogLevel::Info, "配置 %d 个通道：%s", count, defaultShowAll ? "全部显示" : "只显示电压");
 }
@@ -3,9 +3,11 @@
 
 #include <QMainWindow>
 #include <QTimer>           // 定时器
-#include <QtMath>           // 用于生成正弦波 qSin
-#include <QRandomGenerator> // 用于生成一点随机噪声，模拟真实信号
 #include <QMap>             // 用于存储通道配置
+#include <QElapsedTimer>
+
+class AcquisitionController;
+class CaptureFileWriter;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -30,21 +32,39 @@ private:
     // 辅助函数：创建一个居中的复选框
     QWidget* createCenteredCheckBox();
     void wireChannelToggles();
+    void updateChannelTotals();     // 刷新通道表中的电荷量 / 能量累计
+    void initSampleRateMenu();      // “采样率”按钮的下拉菜单
+    static QString formatSampleRate(double rate);
+
+    // 采集控制（工具栏 开始 / 暂停 / 停止）
+    void initAcquisitionControls();
+    void startAcquisition();        // 空闲时从头开始，暂停时继续
+    void pauseAcquisition();        // 暂停 / 继续（暂停期间照常缓冲，只停止刷新显示）
+    void stopAcquisition();         // 停止并取完队列中剩余的数据
+    void pollAcquisition();         // 定时检查数据源是否结束、刷新状态栏统计
+    void updateAcquisitionButtons();
+    void setCaptureOnly(bool enabled);  // 纯采集模式：直接写盘，不刷新波形
+    bool openCaptureFile();
+    void initFileMenu();            // “文件”按钮的下拉菜单
+    void viewCaptureFile();         // 打开已保存的采集文件查看
+    void exportTrace();             // 导出时间线（Chrome trace JSON）
+
+    // 触发（工具栏“触发”按钮的下拉菜单）
+    void initTriggerMenu();         // 触发条件、启动 / 停止、翻看采集段
+    void editTriggerThresholds();   // 门限、脉宽、holdoff 与触发前后样点数
+    void onTriggerCaptured(int index);
+    void updateTriggerButton();
+    QString triggerStatus() const;  // 状态栏中的触发状态
     
     // =========================================================
     // 测试函数：波形显示模块测试
     // =========================================================
     /**
-     * @brief 启动波形测试数据生成
-     * @param channelCount 要测试的通道数量（1-10）
-     * @param updateInterval 更新间隔（毫秒），默认33ms（约30Hz）
+     * @brief 使用模拟器作为数据源（正在采集时以新参数重新开始）
+     * @param channelCount 要测试的通道数量（1-256）
+     * @param sampleRate 每通道采样率（1 kS/s - 2 MS/s），默认 100 kS/s
      */
-    void startWaveformTest(int channelCount = 3, int updateInterval = 33);
-    
-    /**
-     * @brief 停止波形测试数据生成
-     */
-    void stopWaveformTest();
+    void startWaveformTest(int channelCount = 4, double sampleRate = 100e3);
     
     /**
      * @brief 配置通道显示状态
@@ -62,15 +82,16 @@ private:
      */
     void configureAllChannelsDisplay(int channelCount, bool defaultShowAll = true);
     
-    /**
-     * @brief 生成测试数据（定时器回调函数）
-     */
-    void generateTestData();
-    
 private:
-    QTimer *m_testTimer = nullptr;      // 测试定时器
-    int m_testChannelCount = 3;         // 当前测试的通道数量
-    double m_testTime = 0.0;            // 测试时间计数器
+    QTimer *m_totalsTimer = nullptr;    // 通道累计值刷新定时器
+    QTimer *m_acquisitionTimer = nullptr;           // 采集状态刷新定时器
+    AcquisitionController *m_acquisition = nullptr; // 数据源与采集线程
+    CaptureFileWriter *m_recorder = nullptr;        // 纯采集模式的落盘接收端
+    bool m_captureOnly = false;                     // 纯采集模式
+    QElapsedTimer m_captureClock;                   // 写盘速率统计
+    quint64 m_captureLastBytes = 0;
+    int m_testChannelCount = 4;         // 当前测试的通道数量
+    double m_testSampleRate = 100e3;    // 当前测试的每通道采样率
     QMap<int, bool> m_channelVoltageVisible;  // 通道电压显示状态
     QMap<int, bool> m_channelCurrentVisible;  // 通道电流显示状态
     QMap<int, bool> m_channelPowerVisible;    // 通道功率显示状态
@@ -0,0 +1,154 @@
+#include "acquisitioncontroller.h"
+#include "samplequeue.h"
+#include "tracer.h"
+
+/**
+ * @brief 采集线程中的接收端：积压时丢弃，否则带 ProducerToken 入队（纯采集模式下转交落盘接收端）
+ */
+class AcquisitionController::QueueSink : public BlockSink
+{
+public:
+    explicit QueueSink(AcquisitionController *owner)
+        : m_owner(owner)
+        , m_capture(owner->m_captureSink)
+        , m_token(owner->m_queue->makeProducerToken())
+    {
+    }
+
+    bool push(SampleBlock &&block) override
+    {
+        POWERDAQ_TRACE_SCOPE("acquisition/push");
+        const std::uint64_t n = block.size();
+        if (congested()) {
+            reject(n);
+            return false;
+        }
+        const bool accepted = m_capture ? m_capture->push(std::move(block))
+                                        : m_owner->m_queue->push(m_token, std::move(block));
+        if (!accepted) {
+            reject(n);
+            return false;
+        }
+        m_owner->m_deliveredSamples.fetch_add(n, std::memory_order_relaxed);
+        m_owner->m_deliveredBlocks.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool congested() const override
+    {
+        if (m_capture) {
+            return m_capture->congested();
+        }
+        const std::size_t limit = m_owner->m_maxQueuedBlocks;
+        return limit > 0 && m_owner->m_queue->sizeApprox() > limit;
+    }
+
+    void noteDropped(std::uint64_t blocks) override
+    {
+        // 样点数已由数据源计入 SourceStats::droppedSamples，这里只计块数
+        m_owner->m_queue->noteDropped(blocks);
+    }
+
+private:
+    void reject(std::uint64_t samples)
+    {
+        m_owner->m_rejectedSamples.fetch_add(samples, std::memory_order_relaxed);
+        m_owner->m_queue->noteDropped();
+    }
+
+    AcquisitionController *m_owner;
+    BlockSink *m_capture;
+    SampleQueue::ProducerToken m_token;
+};
+
+AcquisitionController::AcquisitionController(SampleQueue *queue)
+    : m_queue(queue)
+{
+}
+
+AcquisitionController::~AcquisitionController()
+{
+    stop();
+}
+
+void AcquisitionController::setSource(std::unique_ptr<IDataSource> source)
+{
+    stop();
+    m_source = std::move(source);
+}
+
+void AcquisitionController::setCaptureSink(BlockSink *sink)
+{
+    if (m_state == State::Idle) {
+        m_captureSink = sink;
+    }
+}
+
+bool AcquisitionController::start()
+{
+    if (m_state != State::Idle) {
+        return true;
+    }
+    if (!m_queue || !m_source || !m_source->open()) {
+        return false;
+    }
+
+    m_deliveredSamples.store(0, std::memory_order_relaxed);
+    m_deliveredBlocks.store(0, std::memory_order_relaxed);
+    m_rejectedSamples.store(0, std::memory_order_relaxed);
+    m_finished.store(false, std::memory_order_relaxed);
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&AcquisitionController::run, this);
+    m_state = State::Running;
+    return true;
+}
+
+void AcquisitionController::pause()
+{
+    if (m_state == State::Running) {
+        m_state = State::Paused;
+    }
+}
+
+void AcquisitionController::resume()
+{
+    if (m_state == State::Paused) {
+        m_state = State::Running;
+    }
+}
+
+void AcquisitionController::stop()
+{
+    m_running.store(false, std::memory_order_release);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_state != State::Idle && m_source) {
+        m_source->close();
+    }
+    m_state = State::Idle;
+}
+
+AcquisitionStats AcquisitionController::stats() const
+{
+    AcquisitionStats s;
+    if (m_source) {
+        const DataSourceStats src = m_source->stats();
+        s.producedSamples = src.producedSamples;
+        s.droppedSamples = src.droppedSamples;
+    }
+    s.deliveredSamples = m_deliveredSamples.load(std::memory_order_relaxed);
+    s.deliveredBlocks = m_deliveredBlocks.load(std::memory_order_relaxed);
+    s.droppedSamples += m_rejectedSamples.load(std::memory_order_relaxed);
+    s.queuedBlocks = m_queue ? m_queue->sizeApprox() : 0;
+    return s;
+}
+
+void AcquisitionController::run()
+{
+    Tracer::setThreadName("acquisition");
+    // 令牌只能在创建它的线程中使用，因此接收端在采集线程内构造
+    QueueSink sink(this);
+    m_source->acquire(sink, m_running);
+    m_finished.store(true, std::memory_order_release);
+}
@@ -0,0 +1,107 @@
+#ifndef ACQUISITIONCONTROLLER_H
+#define ACQUISITIONCONTROLLER_H
+
+#include "idatasource.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+class SampleQueue;
+
+/**
+ * @brief 采集统计（数据源统计 + 投递到队列的情况）
+ */
+struct AcquisitionStats {
+    std::uint64_t producedSamples = 0;  // 数据源产生的样点数
+    std::uint64_t deliveredSamples = 0; // 已投递到队列（或落盘接收端）的样点数
+    std::uint64_t deliveredBlocks = 0;  // 已投递到队列（或落盘接收端）的块数
+    std::uint64_t droppedSamples = 0;   // 丢弃的样点数（数据源内部 + 队列积压）
+    std::size_t queuedBlocks = 0;       // 队列中尚未被显示端取走的块数（近似值）
+};
+
+/**
+ * @brief 采集控制器：持有数据源和采集线程，管理 开始 / 暂停 / 停止
+ *
+ * 状态：Idle --start()--> Running <--pause()/resume()--> Paused，任意状态 --stop()--> Idle。
+ * - 数据源产生的块经内部的 BlockSink 投递到 SampleQueue；队列积压超过 maxQueuedBlocks 时丢弃，
+ *   不让内存无限增长；
+ * - 暂停不停止采集线程，数据照常进入队列和缓冲，由显示端决定是否刷新；
+ * - stop() 等待采集线程结束并关闭数据源，此时队列中的剩余数据由显示端一次取完；
+ * - 设置了落盘接收端（纯采集模式）时，数据块不进入队列，直接交给该接收端。
+ *
+ * 除 stats() / finished() 外只在 GUI 线程调用。
+ */
+class AcquisitionController
+{
+public:
+    enum class State { Idle, Running, Paused };
+
+    explicit AcquisitionController(SampleQueue *queue);
+    ~AcquisitionController();
+
+    AcquisitionController(const AcquisitionController &) = delete;
+    AcquisitionController &operator=(const AcquisitionController &) = delete;
+
+    /**
+     * @brief 更换数据源（正在采集时先停止）
+     */
+    void setSource(std::unique_ptr<IDataSource> source);
+    IDataSource *source() const { return m_source.get(); }
+
+    /**
+     * @brief 打开数据源并启动采集线程（已在采集时什么也不做）
+     * @return 没有数据源或打开失败时返回 false
+     */
+    bool start();
+    void pause();
+    void resume();
+
+    /**
+     * @brief 停止采集线程并关闭数据源（已投递的数据仍留在队列中）
+     */
+    void stop();
+
+    State state() const { return m_state; }
+    bool isActive() const { return m_state != State::Idle; }
+    bool isPaused() const { return m_state == State::Paused; }
+
+    /**
+     * @brief 数据源已自行结束（如文件回放到末尾），仍需调用 stop() 回到 Idle
+     */
+    bool finished() const { return m_finished.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 纯采集模式：数据块直接交给 sink（如 CaptureFileWriter），不进入显示队列
+     *
+     * 只能在 Idle 时设置，nullptr 恢复送往队列；sink 由调用方持有，需活到 stop() 之后。
+     */
+    void setCaptureSink(BlockSink *sink);
+    BlockSink *captureSink() const { return m_captureSink; }
+
+    void setMaxQueuedBlocks(std::size_t blocks) { m_maxQueuedBlocks = blocks; }
+    std::size_t maxQueuedBlocks() const { return m_maxQueuedBlocks; }
+
+    AcquisitionStats stats() const;
+
+private:
+    class QueueSink;
+    void run();
+
+    SampleQueue *m_queue = nullptr;
+    std::unique_ptr<IDataSource> m_source;
+    State m_state = State::Idle;
+    std::size_t m_maxQueuedBlocks = 4096;
+    BlockSink *m_captureSink = nullptr;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_finished{false};
+    std::atomic<std::uint64_t> m_deliveredSamples{0};
+    std::atomic<std::uint64_t> m_deliveredBlocks{0};
+    std::atomic<std::uint64_t> m_rejectedSamples{0};
+};
+
+#endif // ACQUISITIONCONTROLLER_H
@@ -0,0 +1,302 @@
+#include "daqsimulator.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+constexpr int SimulatorConfig::kMaxChannels;
+constexpr double SimulatorConfig::kMinSampleRate;
+constexpr double SimulatorConfig::kMaxSampleRate;
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kMaxLagSeconds = 0.5;  // 落后实时超过该值时丢弃数据追上
+
+/**
+ * @brief xoshiro256**：线程独占的快速伪随机数发生器（splitmix64 初始化状态）
+ */
+class Xoshiro256
+{
+public:
+    explicit Xoshiro256(std::uint64_t seed)
+    {
+        for (std::uint64_t &w : m_s) {
+            seed += 0x9E3779B97F4A7C15ull;
+            std::uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            w = z ^ (z >> 31);
+        }
+    }
+
+    std::uint64_t next()
+    {
+        const std::uint64_t result = rotl(m_s[1] * 5, 7) * 9;
+        const std::uint64_t t = m_s[1] << 17;
+        m_s[2] ^= m_s[0];
+        m_s[3] ^= m_s[1];
+        m_s[1] ^= m_s[2];
+        m_s[0] ^= m_s[3];
+        m_s[2] ^= t;
+        m_s[3] = rotl(m_s[3], 45);
+        return result;
+    }
+
+    // [0, 1) 均匀分布
+    double uniform() { return double(next() >> 11) * (1.0 / 9007199254740992.0); }
+    double uniform(double lo, double hi) { return lo + (hi - lo) * uniform(); }
+    // [-1, 1] 三角分布（两个均匀分布之和，近似高斯且无需超越函数）
+    double noise() { return uniform() + uniform() - 1.0; }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    std::uint64_t m_s[4];
+};
+
+/**
+ * @brief 单个通道的波形模型与状态
+ */
+struct ChannelModel {
+    SimulatorConfig::Waveform kind = SimulatorConfig::Waveform::Sine;
+    double vNominal = 3.8;      // 标称电压（V）
+    double rSource = 0.05;      // 电源内阻（Ω），电压随电流跌落
+    double noiseI = 0.0;        // 电流噪声幅度（A）
+    double noiseV = 0.0;        // 电压噪声幅度（V）
+
+    // Sine / Noise：I = offset + amplitude * sin(phase)，相位用旋转递推，不逐点调用 sin()
+    double offset = 0.0;
+    double amplitude = 0.0;
+    double sinValue = 0.0;
+    double cosValue = 1.0;
+    double sinStep = 0.0;
+    double cosStep = 1.0;
+
+    // LoadSteps / SleepBursts：电流按一阶响应趋向目标值，事件按样点序号调度
+    double level = 0.0;
+    double target = 0.0;
+    double alpha = 1.0;
+    std::uint64_t nextEvent = 0;
+    std::uint64_t spikeEnd = 0;
+    bool active = false;
+};
+
+// 默认通道的电源轨参数（与主窗口通道表的 VBAT_SENSE / VPH_PWR / VCORE_LDO / WIFI_3V3 对应）
+const double kRailVoltage[] = {3.8, 3.7, 0.8, 3.3};
+const double kRailResistance[] = {0.05, 0.08, 0.02, 0.1};
+const double kStepLevels[] = {0.05, 0.3, 0.8, 1.5};
+
+void initModel(ChannelModel &m, int channel, const SimulatorConfig &config, Xoshiro256 &rng)
+{
+    const std::size_t waveCount = config.waveforms.size();
+    m.kind = (std::size_t(channel) < waveCount)
+        ? config.waveforms[std::size_t(channel)]
+        : SimulatorConfig::Waveform(channel % 4);
+
+    const int rail = channel % 4;
+    m.vNominal = kRailVoltage[rail] * (1.0 + 0.02 * ((channel / 4) % 5));
+    m.rSource = kRailResistance[rail];
+
+    const double dt = 1.0 / config.sampleRate;
+    double range = 0.5;     // 电流量程（A），噪声按它缩放
+    switch (m.kind) {
+    case SimulatorConfig::Waveform::Sine: {
+        range = 0.5;
+        m.offset = 0.4 + 0.05 * (channel % 8);
+        m.amplitude = 0.3;
+        // 频率不超过采样率的 1/20，保证每个周期有足够的点
+        const double freq = std::min(config.sampleRate / 20.0, 200.0 * (1.0 + 0.3 * (channel % 8)));
+        m.sinStep = std::sin(2.0 * kPi * freq * dt);
+        m.cosStep = std::cos(2.0 * kPi * freq * dt);
+        const double phase = rng.uniform(0.0, 2.0 * kPi);
+        m.sinValue = std::sin(phase);
+        m.cosValue = std::cos(phase);
+        break;
+    }
+    case SimulatorConfig::Waveform::LoadSteps:
+        range = 1.5;
+        break;
+    case SimulatorConfig::Waveform::SleepBursts:
+        range = 0.3;
+        break;
+    case SimulatorConfig::Waveform::Noise:
+        range = 0.2;
+        m.offset = 0.1;
+        break;
+    }
+    m.noiseI = config.noise * range;
+    m.noiseV = config.noise * 0.1;
+    // 负载响应时间常数 20 µs
+    m.alpha = 1.0 - std::exp(-dt / 20e-6);
+}
+
+/**
+ * @brief 生成一个通道的 n 个样点（全局样点序号从 index 开始）
+ */
+void generate(ChannelModel &m, std::uint64_t index, std::size_t n, double rate,
+              Xoshiro256 &rng, double *voltage, double *current)
+{
+    switch (m.kind) {
+    case SimulatorConfig::Waveform::Sine: {
+        double s = m.sinValue;
+        double c = m.cosValue;
+        for (std::size_t k = 0; k < n; ++k) {
+            current[k] = m.offset + m.amplitude * s + m.noiseI * rng.noise();
+            const double s1 = s * m.cosStep + c * m.sinStep;
+            c = c * m.cosStep - s * m.sinStep;
+            s = s1;
+        }
+        // 每块归一化一次，抵消递推的幅度漂移
+        const double r = 1.0 / std::sqrt(s * s + c * c);
+        m.sinValue = s * r;
+        m.cosValue = c * r;
+        break;
+    }
+
+    case SimulatorConfig::Waveform::LoadSteps:
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::uint64_t i = index + k;
+            if (i >= m.nextEvent) {
+                // 每 5~50 ms 随机切换一档负载
+                m.target = kStepLevels[rng.next() % 4];
+                m.nextEvent = i + std::uint64_t(rng.uniform(5e-3, 50e-3) * rate) + 1;
+            }
+            m.level += m.alpha * (m.target - m.level);
+            current[k] = m.level + m.noiseI * rng.noise();
+        }
+        break;
+
+    case SimulatorConfig::Waveform::SleepBursts:
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::uint64_t i = index + k;
+            if (i >= m.nextEvent) {
+                if (m.active) {
+                    // 工作结束，休眠 20~120 ms
+                    m.active = false;
+                    m.target = 0.002;
+                    m.nextEvent = i + std::uint64_t(rng.uniform(20e-3, 120e-3) * rate) + 1;
+                } else {
+                    // 唤醒工作 1~5 ms；10% 的唤醒在开头带一个 200 µs 的尖峰（如射频发射）
+                    m.active = true;
+                    m.target = rng.uniform(0.15, 0.3);
+                    m.nextEvent = i + std::uint64_t(rng.uniform(1e-3, 5e-3) * rate) + 1;
+                    if (rng.uniform() < 0.1) {
+                        m.spikeEnd = i + std::max<std::uint64_t>(1, std::uint64_t(200e-6 * rate));
+                    }
+                }
+            }
+            const double target = (i < m.spikeEnd) ? 1.2 : m.target;
+            m.level += m.alpha * (target - m.level);
+            current[k] = m.level + m.noiseI * rng.noise();
+        }
+        break;
+
+    case SimulatorConfig::Waveform::Noise:
+        for (std::size_t k = 0; k < n; ++k) {
+            current[k] = m.offset + m.noiseI * rng.noise();
+        }
+        break;
+    }
+
+    for (std::size_t k = 0; k < n; ++k) {
+        voltage[k] = m.vNominal - m.rSource * current[k] + m.noiseV * rng.noise();
+    }
+}
+}
+
+DaqSimulator::DaqSimulator(const SimulatorConfig &config)
+{
+    setConfig(config);
+}
+
+void DaqSimulator::setConfig(const SimulatorConfig &config)
+{
+    m_config = config;
+    m_config.sampleRate = std::min(std::max(config.sampleRate, SimulatorConfig::kMinSampleRate),
+                                   SimulatorConfig::kMaxSampleRate);
+    m_config.channelCount = std::min(std::max(config.channelCount, 1), SimulatorConfig::kMaxChannels);
+    if (m_config.blockSamples == 0) {
+        // 约 10 ms 一块
+        m_config.blockSamples = std::min<std::size_t>(65536, std::max<std::size_t>(16, std::size_t(m_config.sampleRate / 100.0)));
+    }
+}
+
+bool DaqSimulator::open()
+{
+    m_generated.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+DataSourceStats DaqSimulator::stats() const
+{
+    DataSourceStats s;
+    s.producedSamples = m_generated.load(std::memory_order_relaxed);
+    s.droppedSamples = m_dropped.load(std::memory_order_relaxed);
+    return s;
+}
+
+void DaqSimulator::acquire(BlockSink &sink, const std::atomic<bool> &running)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const SimulatorConfig config = m_config;
+    const double rate = config.sampleRate;
+    const double dt = 1.0 / rate;
+    const std::size_t block = config.blockSamples;
+    const std::uint64_t channels = std::uint64_t(config.channelCount);
+
+    Xoshiro256 rng(config.seed);
+    std::vector<ChannelModel> models(std::size_t(config.channelCount));
+    for (int c = 0; c < config.channelCount; ++c) {
+        initModel(models[std::size_t(c)], c, config, rng);
+    }
+
+    const Clock::time_point start = Clock::now();
+    std::uint64_t index = 0;    // 下一个样点的序号
+
+    while (running.load(std::memory_order_acquire)) {
+        // 按实时节拍：本块最后一个样点的时刻到了才投递
+        const std::uint64_t end = index + block;
+        const Clock::time_point due = start + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(double(end) * dt));
+        const Clock::time_point now = Clock::now();
+        if (now < due) {
+            std::this_thread::sleep_until(due);
+            continue;
+        }
+
+        // 落后太多：丢弃整块数据追上实时（时间轴照常推进）
+        const double lag = std::chrono::duration<double>(now - due).count();
+        if (lag > kMaxLagSeconds) {
+            const std::uint64_t skip = std::uint64_t(lag * rate) / block * block;
+            index += skip;
+            m_dropped.fetch_add(skip * channels, std::memory_order_relaxed);
+            sink.noteDropped(skip / block * channels);
+            continue;
+        }
+
+        // 显示端消费不过来：整块丢弃（不必生成），不让队列无限增长
+        if (sink.congested()) {
+            index = end;
+            m_dropped.fetch_add(block * channels, std::memory_order_relaxed);
+            sink.noteDropped(channels);
+            continue;
+        }
+
+        POWERDAQ_TRACE_SCOPE("simulator/block");
+        for (int c = 0; c < config.channelCount; ++c) {
+            SampleBlock b;
+            b.channelId = c;
+            b.t0 = double(index) * dt;
+            b.dt = dt;
+            b.voltage.resize(block);
+            b.current.resize(block);
+            generate(models[std::size_t(c)], index, block, rate, rng, b.voltage.data(), b.current.data());
+            sink.push(std::move(b));
+        }
+        m_generated.fetch_add(block * channels, std::memory_order_relaxed);
+        index = end;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef DAQSIMULATOR_H
+#define DAQSIMULATOR_H
+
+#include "idatasource.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 模拟采集的配置
+ */
+struct SimulatorConfig {
+    /**
+     * @brief 波形类型（电流波形；电压 = 标称电压 - 内阻 * 电流 + 噪声）
+     */
+    enum class Waveform {
+        Sine,           // 正弦：直流偏置 + 正弦
+        LoadSteps,      // 负载阶跃：在几档电流之间随机切换，带一阶响应
+        SleepBursts,    // 休眠/唤醒：微安级休眠电流 + 周期性毫秒级工作脉冲（偶尔带 200 µs 尖峰）
+        Noise,          // 纯噪声：直流偏置 + 噪声
+    };
+
+    static constexpr int kMaxChannels = 256;
+    static constexpr double kMinSampleRate = 1e3;
+    static constexpr double kMaxSampleRate = 2e6;
+
+    double sampleRate = 100e3;          // 每通道采样率（S/s），限定在 [1 kS/s, 2 MS/s]
+    int channelCount = 4;               // 通道数，限定在 [1, 256]
+    std::size_t blockSamples = 0;       // 每块样点数，0 = 自动（约 10 ms 一块）
+    std::vector<Waveform> waveforms;    // 各通道波形，为空或不足时按通道号轮流使用全部类型
+    double noise = 0.01;                // 噪声幅度（相对于该通道的电流量程）
+    std::uint64_t seed = 1;             // 随机数种子（相同种子产生相同数据）
+};
+
+/**
+ * @brief 合成高速率采集数据的模拟器（数据源）
+ *
+ * 在采集线程中按实时节拍以整块方式生成各通道的均匀采样数据（t0 + k*dt），
+ * 经 BlockSink 投递，不经过 GUI 事件循环。随机数由采集线程独占的 xoshiro256** 生成，
+ * 不使用全局随机数发生器。
+ *
+ * 与真实采集卡一样，跟不上实时（生成落后超过 0.5 s）或下游积压时丢弃数据，
+ * 时间轴照常推进，丢弃量计入 stats().droppedSamples。
+ */
+class DaqSimulator : public IDataSource
+{
+public:
+    explicit DaqSimulator(const SimulatorConfig &config = SimulatorConfig());
+
+    /**
+     * @brief 修改配置（下次 open() 时生效；采样率、通道数被限定在允许范围内）
+     */
+    void setConfig(const SimulatorConfig &config);
+    const SimulatorConfig &config() const { return m_config; }
+
+    std::string name() const override { return "simulator"; }
+    bool open() override;      // 复位统计，时间轴从 0 开始
+    void acquire(BlockSink &sink, const std::atomic<bool> &running) override;
+    void close() override {}
+    DataSourceStats stats() const override;
+
+private:
+    SimulatorConfig m_config;
+    std::atomic<std::uint64_t> m_generated{0};
+    std::atomic<std::uint64_t> m_dropped{0};
+};
+
+#endif // DAQSIMULATOR_H
@@ -0,0 +1,88 @@
+#ifndef IDATASOURCE_H
+#define IDATASOURCE_H
+
+#include "sampleblock.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 数据源的累计统计（所有通道合计）
+ */
+struct DataSourceStats {
+    std::uint64_t producedSamples = 0;  // 已产生的样点数
+    std::uint64_t droppedSamples = 0;   // 数据源内部丢弃的样点数（跟不上实时、设备溢出等）
+};
+
+/**
+ * @brief 数据块接收端：数据源产生的采样块经由它投递出去
+ *
+ * 由 AcquisitionController 提供，只在采集线程中调用。
+ */
+class BlockSink
+{
+public:
+    virtual ~BlockSink() {}
+
+    /**
+     * @brief 投递一个采样块
+     * @return 下游积压、该块被丢弃时返回 false
+     */
+    virtual bool push(SampleBlock &&block) = 0;
+
+    /**
+     * @brief 下游是否积压（数据源可据此提前丢弃，省去生成/读取的开销）
+     */
+    virtual bool congested() const = 0;
+
+    /**
+     * @brief 数据源未经 push() 自行丢弃了 blocks 个块（积压、跟不上实时），计入丢块统计
+     */
+    virtual void noteDropped(std::uint64_t blocks) { (void)blocks; }
+};
+
+/**
+ * @brief 数据源接口（模拟器、文件回放、网络等）
+ *
+ * 数据源不自建线程：AcquisitionController 持有采集线程，依次调用
+ * open() -> acquire() -> close()。acquire() 在采集线程中循环产生数据块，
+ * 直到 running 变为 false（或数据源自身结束）才返回。
+ *
+ * 暂停不经过数据源：暂停期间数据照常采集进缓冲，只是显示不再刷新。
+ */
+class IDataSource
+{
+public:
+    virtual ~IDataSource() {}
+
+    /**
+     * @brief 数据源名称（用于日志和界面显示）
+     */
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief 打开设备 / 文件并复位统计（GUI 线程）
+     * @return 失败时返回 false，不会启动采集线程
+     */
+    virtual bool open() = 0;
+
+    /**
+     * @brief 采集循环（采集线程）
+     * @param sink 数据块接收端
+     * @param running 停止标志，变为 false 时应尽快返回
+     */
+    virtual void acquire(BlockSink &sink, const std::atomic<bool> &running) = 0;
+
+    /**
+     * @brief 关闭设备 / 文件（GUI 线程，采集线程已结束）
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief 累计统计（任意线程）
+     */
+    virtual DataSourceStats stats() const = 0;
+};
+
+#endif // IDATASOURCE_H
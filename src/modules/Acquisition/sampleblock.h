@@ -0,0 +1,34 @@
+#ifndef SAMPLEBLOCK_H
+#define SAMPLEBLOCK_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief 单通道采样块（采集线程 -> 显示线程的传输单元）
+ *
+ * 一个块内保存同一通道连续的若干个样点，按列存储（时间/电压/电流/功率各一列），
+ * 采集线程整块投递到 SampleQueue，显示端按帧批量取出，避免逐点打包和逐点信号槽投递。
+ *
+ * 时间有两种给法：
+ * - time 非空：逐点时间戳（长度必须与 voltage 一致）；
+ * - time 为空且 dt > 0：均匀采样，第 k 个样点时间 = t0 + k * dt。
+ */
+struct SampleBlock {
+    int channelId = -1;             // 通道ID
+    double t0 = 0.0;                // 均匀采样时第一个样点的时间（秒）
+    double dt = 0.0;                // 均匀采样周期（秒），<= 0 表示使用 time 列
+    std::vector<double> time;       // 时间戳（秒），均匀采样时可为空
+    std::vector<double> voltage;    // 电压（V）
+    std::vector<double> current;    // 电流（A）
+    std::vector<double> power;      // 功率（W），可为空：为空时按 voltage * current 计算
+
+    /**
+     * @brief 块内样点数（以电压列为准）
+     */
+    std::size_t size() const { return voltage.size(); }
+    bool isEmpty() const { return voltage.empty(); }
+    bool isUniform() const { return time.empty() && dt > 0.0; }
+};
+
+#endif // SAMPLEBLOCK_H
@@ -0,0 +1,75 @@
+#ifndef SAMPLEQUEUE_H
+#define SAMPLEQUEUE_H
+
+#include "sampleblock.h"
+#include "concurrentqueue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 采集 -> 显示 的无锁采样块队列
+ *
+ * 基于 moodycamel::ConcurrentQueue（多生产者/多消费者无锁队列）：
+ * - 生产者（采集线程）调用 push()，建议每个线程持有一个 ProducerToken 以获得最佳吞吐；
+ * - 消费者（GUI 线程）每个显示帧调用一次 drain()，批量取出当帧已到达的全部数据块。
+ *
+ * 与 Qt::QueuedConnection 相比，入队不产生 QMetaCallEvent 堆分配，也不会挤占 GUI 事件队列。
+ */
+class SampleQueue
+{
+public:
+    typedef moodycamel::ProducerToken ProducerToken;
+
+    explicit SampleQueue(std::size_t initialCapacity = 1024)
+        : m_queue(initialCapacity) {}
+
+    /**
+     * @brief 为生产者线程创建专用令牌（令牌只能在创建它的线程中使用）
+     */
+    ProducerToken makeProducerToken() { return ProducerToken(m_queue); }
+
+    /**
+     * @brief 投递一个采样块（任意线程）
+     * @return 内存分配失败时返回 false
+     */
+    bool push(SampleBlock &&block) { return m_queue.enqueue(std::move(block)); }
+    bool push(ProducerToken &token, SampleBlock &&block) { return m_queue.enqueue(token, std::move(block)); }
+
+    /**
+     * @brief 批量取出已到达的数据块（消费者线程）
+     * @param out 输出数组（追加到末尾）
+     * @param maxBlocks 本次最多取出的块数
+     * @return 实际取出的块数
+     */
+    std::size_t drain(std::vector<SampleBlock> &out, std::size_t maxBlocks)
+    {
+        const std::size_t base = out.size();
+        out.resize(base + maxBlocks);
+        const std::size_t n = m_queue.try_dequeue_bulk(out.begin() + base, maxBlocks);
+        out.resize(base + n);
+        return n;
+    }
+
+    /**
+     * @brief 队列中待处理块数的近似值（仅用于统计/限流）
+     */
+    std::size_t sizeApprox() const { return m_queue.size_approx(); }
+
+    /**
+     * @brief 记录因积压或分配失败而未能入队的块（生产者线程，无锁计数）
+     */
+    void noteDropped(std::uint64_t blocks = 1) { m_droppedBlocks.fetch_add(blocks, std::memory_order_relaxed); }
+
+    /**
+     * @brief 累计丢弃的块数（仅用于统计）
+     */
+    std::uint64_t droppedBlocks() const { return m_droppedBlocks.load(std::memory_order_relaxed); }
+
+private:
+    moodycamel::ConcurrentQueue<SampleBlock> m_queue;
+    std::atomic<std::uint64_t> m_droppedBlocks{0};
+};
+
+#endif // SAMPLEQUEUE_H
@@ -0,0 +1,399 @@
+#include "capturefile.h"
+#include "reducekernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace CaptureFormat;
+
+namespace {
+/**
+ * @brief 把一段最值并入累计结果（段在时间上晚于已累计部分，相同极值保留更早的位置）
+ */
+void accumulate(CaptureFile::Summary &acc, double mn, std::int64_t mnAt, double mx, std::int64_t mxAt,
+                std::int64_t count)
+{
+    if (!std::isnan(mn) && (acc.minAt < 0 || mn < acc.min)) {
+        acc.min = mn;
+        acc.minAt = mnAt;
+    }
+    if (!std::isnan(mx) && (acc.maxAt < 0 || mx > acc.max)) {
+        acc.max = mx;
+        acc.maxAt = mxAt;
+    }
+    acc.count += count;
+}
+}
+
+CaptureFile::~CaptureFile()
+{
+    close();
+}
+
+bool CaptureFile::open(const QString &path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = quint64(m_file.size());
+    if (m_size < sizeof(FileHeader)) {
+        m_error = QStringLiteral("不是采集文件");
+        close();
+        return false;
+    }
+    m_base = m_file.map(0, qint64(m_size));
+    if (!m_base) {
+        m_error = m_file.errorString();
+        close();
+        return false;
+    }
+
+    std::memcpy(&m_header, m_base, sizeof(m_header));
+    if (std::memcmp(m_header.magic, kFileMagic, sizeof(kFileMagic)) != 0 ||
+        m_header.version != kVersion || m_header.headerSize < sizeof(FileHeader) ||
+        m_header.summaryBlock == 0) {
+        m_error = QStringLiteral("不是采集文件或版本不支持");
+        close();
+        return false;
+    }
+
+    if (!loadIndex()) {
+        // 没有正常关闭：从文件头之后逐块扫描，截断的最后一块丢弃
+        m_channels.clear();
+        m_recovered = true;
+        scanChunks();
+    }
+    m_error.clear();
+    return true;
+}
+
+void CaptureFile::close()
+{
+    if (m_base) {
+        m_file.unmap(const_cast<uchar *>(m_base));
+        m_base = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_size = 0;
+    m_channels.clear();
+    m_recovered = false;
+}
+
+/**
+ * @brief 读取文件尾的块索引（只访问索引所在的页）
+ */
+bool CaptureFile::loadIndex()
+{
+    if (m_size < sizeof(FileHeader) + sizeof(Footer)) {
+        return false;
+    }
+    Footer footer;
+    std::memcpy(&footer, m_base + m_size - sizeof(Footer), sizeof(footer));
+    if (std::memcmp(footer.magic, kFooterMagic, sizeof(kFooterMagic)) != 0) {
+        return false;
+    }
+    const quint64 indexBytes = footer.entryCount * sizeof(IndexEntry);
+    if (footer.indexOffset < m_header.headerSize || footer.entryCount > m_size / sizeof(IndexEntry) ||
+        footer.indexOffset + indexBytes + sizeof(Footer) != m_size) {
+        return false;
+    }
+
+    const IndexEntry *entries = reinterpret_cast<const IndexEntry *>(m_base + footer.indexOffset);
+    for (quint64 k = 0; k < footer.entryCount; ++k) {
+        if (!addChunk(entries[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 顺序扫描块头重建索引（每块只访问块头和摘要所在的页）
+ */
+bool CaptureFile::scanChunks()
+{
+    quint64 offset = m_header.headerSize;
+    while (offset + sizeof(ChunkHeader) <= m_size) {
+        const ChunkHeader *h = reinterpret_cast<const ChunkHeader *>(m_base + offset);
+        if (h->magic != kChunkMagic || h->count == 0 ||
+            h->recordBytes != recordBytes(h->count, h->summaryCount, h->flags) ||
+            offset + h->recordBytes > m_size) {
+            break;
+        }
+
+        IndexEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.channelId = h->channelId;
+        entry.count = h->count;
+        entry.flags = h->flags;
+        entry.summaryCount = h->summaryCount;
+        entry.offset = offset;
+        entry.firstSample = h->firstSample;
+        entry.tFirst = h->t0;
+        entry.tLast = h->tLast;
+        entry.dt = h->dt;
+
+        // 整块摘要由各段摘要合并
+        const SummaryEntry *summaries = reinterpret_cast<const SummaryEntry *>(m_base + offset + sizeof(ChunkHeader));
+        for (int c = 0; c < kValueColumns; ++c) {
+            Summary acc;
+            for (std::uint32_t b = 0; b < h->summaryCount; ++b) {
+                const SummaryEntry &e = summaries[std::size_t(c) * h->summaryCount + b];
+                accumulate(acc, e.min, e.minAt, e.max, e.maxAt, 0);
+            }
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            entry.summary[c].min = acc.minAt < 0 ? nan : acc.min;
+            entry.summary[c].max = acc.maxAt < 0 ? nan : acc.max;
+            entry.summary[c].minAt = std::uint32_t(std::max<std::int64_t>(0, acc.minAt));
+            entry.summary[c].maxAt = std::uint32_t(std::max<std::int64_t>(0, acc.maxAt));
+        }
+
+        if (!addChunk(entry)) {
+            break;
+        }
+        offset += h->recordBytes;
+    }
+    return !m_channels.empty();
+}
+
+bool CaptureFile::addChunk(const IndexEntry &entry)
+{
+    if (entry.channelId < 0 || entry.count == 0 ||
+        entry.summaryCount != (entry.count + m_header.summaryBlock - 1) / m_header.summaryBlock) {
+        return false;
+    }
+    const quint64 bytes = recordBytes(entry.count, entry.summaryCount, entry.flags);
+    if (entry.offset < m_header.headerSize || entry.offset + bytes > m_size) {
+        return false;
+    }
+
+    if (std::size_t(entry.channelId) >= m_channels.size()) {
+        m_channels.resize(std::size_t(entry.channelId) + 1);
+    }
+    Channel &ch = m_channels[std::size_t(entry.channelId)];
+    if (entry.firstSample != ch.samples) {
+        return false;   // 同一通道的块必须首尾相接
+    }
+
+    Chunk chunk;
+    chunk.firstSample = entry.firstSample;
+    chunk.count = entry.count;
+    chunk.summaryCount = entry.summaryCount;
+    chunk.explicitTime = (entry.flags & kExplicitTime) != 0;
+    chunk.tFirst = entry.tFirst;
+    chunk.tLast = entry.tLast;
+    chunk.dt = entry.dt;
+    for (int c = 0; c < kValueColumns; ++c) {
+        chunk.whole[c] = entry.summary[c];
+    }
+
+    // 只计算指针，不读取数据
+    const uchar *p = m_base + entry.offset + sizeof(ChunkHeader);
+    chunk.summaries = reinterpret_cast<const SummaryEntry *>(p);
+    p += std::size_t(kValueColumns) * entry.summaryCount * sizeof(SummaryEntry);
+    if (chunk.explicitTime) {
+        chunk.time = reinterpret_cast<const double *>(p);
+        p += std::size_t(entry.count) * sizeof(double);
+    }
+    for (int c = 0; c < kValueColumns; ++c) {
+        chunk.values[c] = reinterpret_cast<const double *>(p);
+        p += std::size_t(entry.count) * sizeof(double);
+    }
+
+    ch.chunks.push_back(chunk);
+    ch.samples += entry.count;
+    return true;
+}
+
+std::vector<int> CaptureFile::channelIds() const
+{
+    std::vector<int> ids;
+    for (std::size_t c = 0; c < m_channels.size(); ++c) {
+        if (m_channels[c].samples > 0) {
+            ids.push_back(int(c));
+        }
+    }
+    return ids;
+}
+
+const CaptureFile::Channel *CaptureFile::channel(int channelId) const
+{
+    if (channelId < 0 || std::size_t(channelId) >= m_channels.size() ||
+        m_channels[std::size_t(channelId)].samples == 0) {
+        return nullptr;
+    }
+    return &m_channels[std::size_t(channelId)];
+}
+
+bool CaptureFile::hasChannel(int channelId) const
+{
+    return channel(channelId) != nullptr;
+}
+
+std::int64_t CaptureFile::sampleCount(int channelId) const
+{
+    const Channel *ch = channel(channelId);
+    return ch ? ch->samples : 0;
+}
+
+double CaptureFile::firstTime(int channelId) const
+{
+    const Channel *ch = channel(channelId);
+    return ch ? ch->chunks.front().tFirst : 0.0;
+}
+
+double CaptureFile::lastTime(int channelId) const
+{
+    const Channel *ch = channel(channelId);
+    return ch ? ch->chunks.back().tLast : 0.0;
+}
+
+const CaptureFile::Chunk *CaptureFile::chunkFor(int channelId, std::int64_t i) const
+{
+    const Channel *ch = channel(channelId);
+    if (!ch || i < 0 || i >= ch->samples) {
+        return nullptr;
+    }
+    auto it = std::upper_bound(ch->chunks.begin(), ch->chunks.end(), i,
+                               [](std::int64_t v, const Chunk &c) { return v < c.firstSample; });
+    return &*(it - 1);
+}
+
+double CaptureFile::timeAt(int channelId, std::int64_t i) const
+{
+    const Chunk *c = chunkFor(channelId, i);
+    return c ? c->timeAt(std::uint32_t(i - c->firstSample)) : 0.0;
+}
+
+double CaptureFile::valueAt(int channelId, Column column, std::int64_t i) const
+{
+    const Chunk *c = chunkFor(channelId, i);
+    return c ? c->values[int(column)][i - c->firstSample] : 0.0;
+}
+
+/**
+ * @brief 块内第一个时间 >= t（upper 为 true 时 > t）的位置，不存在时返回 count
+ */
+std::uint32_t CaptureFile::Chunk::lowerBound(double t, bool upper) const
+{
+    if (explicitTime) {
+        const double *p = upper ? std::upper_bound(time, time + count, t)
+                                : std::lower_bound(time, time + count, t);
+        return std::uint32_t(p - time);
+    }
+    // 均匀时基：先估算再按 timeAt() 的实际取值校正，与逐点比较的结果一致
+    double k = std::ceil((t - tFirst) / dt);
+    k = std::max(0.0, std::min(double(count), k));
+    std::uint32_t i = std::uint32_t(k);
+    auto before = [&](std::uint32_t j) { return upper ? timeAt(j) <= t : timeAt(j) < t; };
+    while (i > 0 && !before(i - 1)) {
+        --i;
+    }
+    while (i < count && before(i)) {
+        ++i;
+    }
+    return i;
+}
+
+std::int64_t CaptureFile::search(int channelId, double t, bool upper) const
+{
+    const Channel *ch = channel(channelId);
+    if (!ch) {
+        return 0;
+    }
+    // 第一个最后时间 >= t（upper：> t）的块
+    auto it = std::partition_point(ch->chunks.begin(), ch->chunks.end(), [&](const Chunk &c) {
+        return upper ? c.tLast <= t : c.tLast < t;
+    });
+    if (it == ch->chunks.end()) {
+        return ch->samples;
+    }
+    return it->firstSample + it->lowerBound(t, upper);
+}
+
+std::int64_t CaptureFile::lowerBound(int channelId, double t) const
+{
+    return search(channelId, t, false);
+}
+
+std::int64_t CaptureFile::upperBound(int channelId, double t) const
+{
+    return search(channelId, t, true);
+}
+
+std::int64_t CaptureFile::nearest(int channelId, double t) const
+{
+    const std::int64_t n = sampleCount(channelId);
+    if (n == 0) {
+        return -1;
+    }
+    const std::int64_t i = lowerBound(channelId, t);
+    if (i >= n) {
+        return n - 1;
+    }
+    if (i == 0) {
+        return 0;
+    }
+    return (t - timeAt(channelId, i - 1) <= timeAt(channelId, i) - t) ? i - 1 : i;
+}
+
+CaptureFile::Summary CaptureFile::summarize(int channelId, Column column,
+                                            std::int64_t begin, std::int64_t end) const
+{
+    Summary acc;
+    const Channel *ch = channel(channelId);
+    if (!ch) {
+        return acc;
+    }
+    begin = std::max<std::int64_t>(0, begin);
+    end = std::min(end, ch->samples);
+    if (begin >= end) {
+        return acc;
+    }
+
+    const int col = int(column);
+    const std::int64_t block = m_header.summaryBlock;
+    auto it = std::upper_bound(ch->chunks.begin(), ch->chunks.end(), begin,
+                               [](std::int64_t v, const Chunk &c) { return v < c.firstSample; }) - 1;
+    for (; it != ch->chunks.end() && it->firstSample < end; ++it) {
+        const Chunk &c = *it;
+        const std::int64_t lo = std::max(begin, c.firstSample) - c.firstSample;
+        const std::int64_t hi = std::min(end, c.end()) - c.firstSample;
+
+        // 整块：索引中的摘要，不访问块内的页
+        if (lo == 0 && hi == c.count) {
+            const SummaryEntry &w = c.whole[col];
+            accumulate(acc, w.min, c.firstSample + w.minAt, w.max, c.firstSample + w.maxAt, hi);
+            continue;
+        }
+
+        // 部分块：完整的摘要段用摘要，两端不足一段的部分读取原始样点
+        const SummaryEntry *summaries = c.summaries + std::size_t(col) * c.summaryCount;
+        const double *values = c.values[col];
+        std::int64_t k = lo;
+        while (k < hi) {
+            const std::int64_t b = k / block;
+            const std::int64_t segEnd = std::min<std::int64_t>((b + 1) * block, c.count);
+            if (k == b * block && segEnd <= hi) {
+                const SummaryEntry &e = summaries[b];
+                accumulate(acc, e.min, c.firstSample + e.minAt, e.max, c.firstSample + e.maxAt, segEnd - k);
+                k = segEnd;
+            } else {
+                const std::int64_t stop = std::min(segEnd, hi);
+                SpanReduction r;
+                reduceSpan(values + k, std::size_t(stop - k), r);
+                accumulate(acc, r.min, c.firstSample + k + std::int64_t(r.minAt),
+                           r.max, c.firstSample + k + std::int64_t(r.maxAt), stop - k);
+                k = stop;
+            }
+        }
+    }
+    return acc;
+}
@@ -0,0 +1,119 @@
+#ifndef CAPTUREFILE_H
+#define CAPTUREFILE_H
+
+#include "capturefileformat.h"
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 采集文件（.pdaq）的只读访问，整个文件内存映射
+ *
+ * 打开时只读取文件头和尾部的块索引（索引缺失时顺序扫描各块的块头重建），
+ * 不读取样点数据，因此几十 GB 的文件也在毫秒级打开；之后按视口访问的区域由操作系统按页换入。
+ *
+ * 每个通道的样点按通道内序号 [0, sampleCount) 访问，接口与 TimeAxis / MinMaxPyramid 对应：
+ * 时间查找在块索引上二分、块内按均匀时基计算或二分；区间最值优先使用块摘要，
+ * 只有区间两端不足一个摘要段的部分才读取原始样点。
+ *
+ * 打开后只读，可在多个线程中同时访问。
+ */
+class CaptureFile
+{
+public:
+    enum class Column { Voltage, Current, Power };
+
+    /**
+     * @brief 区间最值（字段含义同 MinMaxPyramid::Summary，位置为通道内序号）
+     */
+    struct Summary {
+        double min = 0.0;
+        double max = 0.0;
+        std::int64_t count = 0;
+        std::int64_t minAt = -1;
+        std::int64_t maxAt = -1;
+    };
+
+    CaptureFile() = default;
+    ~CaptureFile();
+
+    CaptureFile(const CaptureFile &) = delete;
+    CaptureFile &operator=(const CaptureFile &) = delete;
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_base != nullptr; }
+    QString path() const { return m_file.fileName(); }
+    QString errorString() const { return m_error; }
+    quint64 fileSize() const { return m_size; }
+
+    /**
+     * @brief 文件尾部没有索引（采集中断），索引由扫描块头重建
+     */
+    bool isRecovered() const { return m_recovered; }
+
+    // --- 通道 ---
+    std::vector<int> channelIds() const;
+    bool hasChannel(int channelId) const;
+    std::int64_t sampleCount(int channelId) const;
+    double firstTime(int channelId) const;
+    double lastTime(int channelId) const;
+
+    // --- 样点（0 <= i < sampleCount） ---
+    double timeAt(int channelId, std::int64_t i) const;
+    double valueAt(int channelId, Column column, std::int64_t i) const;
+
+    // --- 时间查找（语义同 TimeAxis） ---
+    std::int64_t lowerBound(int channelId, double t) const;    // 第一个时间 >= t 的样点
+    std::int64_t upperBound(int channelId, double t) const;    // 第一个时间 > t 的样点
+    std::int64_t nearest(int channelId, double t) const;       // 最接近 t 的样点（无数据时 -1）
+
+    /**
+     * @brief 样点 [begin, end) 的最值；NaN 不参与比较
+     */
+    Summary summarize(int channelId, Column column, std::int64_t begin, std::int64_t end) const;
+
+private:
+    struct Chunk {
+        std::int64_t firstSample = 0;
+        std::uint32_t count = 0;
+        std::uint32_t summaryCount = 0;
+        bool explicitTime = false;
+        double tFirst = 0.0;
+        double tLast = 0.0;
+        double dt = 0.0;
+        const CaptureFormat::SummaryEntry *summaries = nullptr;  // [列][summaryCount]
+        const double *time = nullptr;                            // 仅 explicitTime
+        const double *values[CaptureFormat::kValueColumns] = {nullptr, nullptr, nullptr};
+        CaptureFormat::SummaryEntry whole[CaptureFormat::kValueColumns];
+
+        std::int64_t end() const { return firstSample + count; }
+        double timeAt(std::uint32_t k) const { return explicitTime ? time[k] : tFirst + double(k) * dt; }
+        std::uint32_t lowerBound(double t, bool upper) const;
+    };
+    struct Channel {
+        std::vector<Chunk> chunks;
+        std::int64_t samples = 0;
+    };
+
+    bool loadIndex();
+    bool scanChunks();
+    bool addChunk(const CaptureFormat::IndexEntry &entry);
+    const Chunk *chunkFor(int channelId, std::int64_t i) const;
+    const Channel *channel(int channelId) const;
+    std::int64_t search(int channelId, double t, bool upper) const;
+
+    QFile m_file;
+    const uchar *m_base = nullptr;
+    quint64 m_size = 0;
+    CaptureFormat::FileHeader m_header;
+    std::vector<Channel> m_channels;    // 按通道号索引
+    bool m_recovered = false;
+    QString m_error;
+};
+using CaptureFilePtr = std::shared_ptr<const CaptureFile>;
+
+#endif // CAPTUREFILE_H
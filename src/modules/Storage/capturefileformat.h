@@ -0,0 +1,112 @@
+#ifndef CAPTUREFILEFORMAT_H
+#define CAPTUREFILEFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 采集文件（.pdaq）的磁盘布局
+ *
+ * 分块列式存储，采集时只追加写入，读取时整体内存映射、按需换页：
+ *
+ *   FileHeader
+ *   ChunkRecord ...（各通道的数据块按写满的先后交错排列）
+ *   IndexEntry[entryCount]（关闭文件时写入）
+ *   Footer
+ *
+ * 每个 ChunkRecord 保存一个通道连续的至多 chunkSamples 个样点：
+ *   ChunkHeader
+ *   SummaryEntry[3][summaryCount]（电压/电流/功率，每 summaryBlock 个样点一个 Min/Max）
+ *   [时间列]（仅 kExplicitTime）、电压列、电流列、功率列（各 count 个 double）
+ * 均匀采样的块不保存时间列，样点时间 = t0 + k*dt。
+ *
+ * 所有字段为本机字节序（x86 / ARM 小端），结构和列都按 8 字节对齐，映射后可直接按 double 读取。
+ * 文件尾部的索引缺失（采集中断电、崩溃）时，读取端顺序扫描 ChunkHeader 重建索引，
+ * 已完整写出的块全部可用。
+ */
+namespace CaptureFormat {
+
+static const char kFileMagic[8] = {'P', 'D', 'A', 'Q', 'C', 'A', 'P', '1'};
+static const char kFooterMagic[8] = {'P', 'D', 'A', 'Q', 'E', 'N', 'D', '1'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kChunkMagic = 0x304B4843;     // "CHK0"
+
+constexpr std::uint32_t kDefaultChunkSamples = 65536;
+constexpr std::uint32_t kDefaultSummaryBlock = 1024;
+constexpr int kValueColumns = 3;                      // 电压、电流、功率
+
+enum ChunkFlag : std::uint32_t {
+    kExplicitTime = 1u << 0,
+};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint32_t chunkSamples;     // 每块最多样点数
+    std::uint32_t summaryBlock;     // 块内 Min/Max 摘要的粒度（样点）
+    std::uint64_t reserved[5];
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout");
+
+struct ChunkHeader {
+    std::uint32_t magic;
+    std::int32_t channelId;
+    std::uint32_t count;            // 本块样点数
+    std::uint32_t flags;
+    std::int64_t firstSample;       // 本块第一个样点在该通道内的序号
+    double t0;                      // 第一个样点的时间
+    double dt;                      // 均匀采样周期（kExplicitTime 时无意义）
+    double tLast;                   // 最后一个样点的时间
+    std::uint32_t summaryCount;     // 每列的摘要个数 = ceil(count / summaryBlock)
+    std::uint32_t reserved;
+    std::uint64_t recordBytes;      // 整个记录（含本结构）的字节数，用于顺序扫描
+};
+static_assert(sizeof(ChunkHeader) == 64, "ChunkHeader layout");
+
+/**
+ * @brief 一段样点的 Min/Max 摘要（位置相对于本块起点，多个相同极值时取最早）
+ */
+struct SummaryEntry {
+    double min;
+    double max;
+    std::uint32_t minAt;
+    std::uint32_t maxAt;
+};
+static_assert(sizeof(SummaryEntry) == 24, "SummaryEntry layout");
+
+/**
+ * @brief 块索引：打开文件时只读索引，不触碰各块所在的页
+ */
+struct IndexEntry {
+    std::int32_t channelId;
+    std::uint32_t count;
+    std::uint32_t flags;
+    std::uint32_t summaryCount;
+    std::uint64_t offset;           // ChunkHeader 的文件偏移
+    std::int64_t firstSample;
+    double tFirst;
+    double tLast;
+    double dt;
+    SummaryEntry summary[kValueColumns];    // 整块的 Min/Max
+};
+static_assert(sizeof(IndexEntry) == 128, "IndexEntry layout");
+
+struct Footer {
+    char magic[8];
+    std::uint64_t indexOffset;
+    std::uint64_t entryCount;
+    std::uint64_t reserved;
+};
+static_assert(sizeof(Footer) == 32, "Footer layout");
+
+inline std::uint64_t recordBytes(std::uint32_t count, std::uint32_t summaryCount, std::uint32_t flags)
+{
+    const std::uint64_t columns = kValueColumns + ((flags & kExplicitTime) ? 1 : 0);
+    return sizeof(ChunkHeader) + std::uint64_t(kValueColumns) * summaryCount * sizeof(SummaryEntry)
+         + columns * count * sizeof(double);
+}
+
+} // namespace CaptureFormat
+
+#endif // CAPTUREFILEFORMAT_H
@@ -0,0 +1,285 @@
+#include "capturefilewriter.h"
+#include "reducekernels.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace CaptureFormat;
+
+namespace {
+constexpr int kMaxChannelId = 4095;
+
+/**
+ * @brief 合并两段摘要（b 在 a 之后，相对位置已换算到同一起点）；NaN 不参与比较
+ */
+void mergeSummary(SummaryEntry &a, const SummaryEntry &b)
+{
+    if (std::isnan(a.min) || b.min < a.min) {
+        a.min = b.min;
+        a.minAt = b.minAt;
+    }
+    if (std::isnan(a.max) || b.max > a.max) {
+        a.max = b.max;
+        a.maxAt = b.maxAt;
+    }
+}
+}
+
+CaptureFileWriter::CaptureFileWriter(std::uint32_t chunkSamples, std::uint32_t summaryBlock)
+    : m_chunkSamples(std::max<std::uint32_t>(1, chunkSamples))
+    , m_summaryBlock(std::max<std::uint32_t>(1, summaryBlock))
+{
+}
+
+bool CaptureFileWriter::open(const std::string &path)
+{
+    close();
+    if (!m_writer.open(path)) {
+        return false;
+    }
+    m_path = path;
+    m_channels.clear();
+    m_index.clear();
+    m_samples.store(0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_integratorMutex);
+        m_integrators.clear();
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kFileMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.headerSize = sizeof(FileHeader);
+    header.chunkSamples = m_chunkSamples;
+    header.summaryBlock = m_summaryBlock;
+    m_writer.write(&header, sizeof(header));
+    m_bytes.store(m_writer.position(), std::memory_order_relaxed);
+    return true;
+}
+
+bool CaptureFileWriter::close()
+{
+    if (!m_writer.isOpen()) {
+        return true;
+    }
+
+    // 未写满的块
+    for (std::size_t c = 0; c < m_channels.size(); ++c) {
+        if (m_channels[c].size() > 0) {
+            flushChunk(int(c), m_channels[c]);
+        }
+    }
+
+    // 索引 + 文件尾
+    Footer footer;
+    std::memset(&footer, 0, sizeof(footer));
+    std::memcpy(footer.magic, kFooterMagic, sizeof(footer.magic));
+    footer.indexOffset = m_writer.position();
+    footer.entryCount = m_index.size();
+    if (!m_index.empty()) {
+        m_writer.write(m_index.data(), m_index.size() * sizeof(IndexEntry));
+    }
+    m_writer.write(&footer, sizeof(footer));
+    m_bytes.store(m_writer.position(), std::memory_order_relaxed);
+
+    m_channels.clear();
+    m_index.clear();
+    return m_writer.close();
+}
+
+CaptureFileWriter::Staging &CaptureFileWriter::staging(int channelId)
+{
+    if (std::size_t(channelId) >= m_channels.size()) {
+        m_channels.resize(std::size_t(channelId) + 1);
+    }
+    return m_channels[std::size_t(channelId)];
+}
+
+/**
+ * @brief 块能否接在当前未写满的块后面（采样方式相同且时间连续）
+ */
+bool CaptureFileWriter::continues(const Staging &s, const SampleBlock &block) const
+{
+    if (s.explicitTime) {
+        return !block.isUniform() && block.time.front() >= s.time.back();
+    }
+    if (!block.isUniform()) {
+        return false;
+    }
+    const double expected = s.t0 + double(s.size()) * s.dt;
+    return std::fabs(block.dt - s.dt) <= 1e-9 * s.dt
+        && std::fabs(block.t0 - expected) <= 0.5 * s.dt;
+}
+
+bool CaptureFileWriter::push(SampleBlock &&block)
+{
+    const std::size_t n = block.size();
+    if (!m_writer.isOpen() || n == 0 || block.current.size() != n) {
+        return false;
+    }
+    if (block.channelId < 0 || block.channelId > kMaxChannelId) {
+        return false;
+    }
+    const bool explicitTime = !block.isUniform();
+    if (explicitTime && block.time.size() != n) {
+        return false;
+    }
+    const bool hasPower = (block.power.size() == n);
+    integrate(block, hasPower);
+
+    Staging &s = staging(block.channelId);
+    if (s.size() > 0 && !continues(s, block)) {
+        flushChunk(block.channelId, s);
+    }
+
+    std::size_t off = 0;
+    while (off < n) {
+        if (s.size() == 0) {
+            s.explicitTime = explicitTime;
+            s.t0 = explicitTime ? block.time[off] : block.t0 + double(off) * block.dt;
+            s.dt = explicitTime ? 0.0 : block.dt;
+        }
+        const std::size_t take = std::min<std::size_t>(n - off, m_chunkSamples - s.size());
+        const double *v = block.voltage.data() + off;
+        const double *i = block.current.data() + off;
+        if (explicitTime) {
+            s.time.insert(s.time.end(), block.time.begin() + std::ptrdiff_t(off),
+                          block.time.begin() + std::ptrdiff_t(off + take));
+        }
+        s.columns[0].insert(s.columns[0].end(), v, v + take);
+        s.columns[1].insert(s.columns[1].end(), i, i + take);
+        std::vector<double> &power = s.columns[2];
+        if (hasPower) {
+            power.insert(power.end(), block.power.begin() + std::ptrdiff_t(off),
+                         block.power.begin() + std::ptrdiff_t(off + take));
+        } else {
+            const std::size_t base = power.size();
+            power.resize(base + take);
+            for (std::size_t k = 0; k < take; ++k) {
+                power[base + k] = v[k] * i[k];
+            }
+        }
+        off += take;
+        if (s.size() == m_chunkSamples) {
+            flushChunk(block.channelId, s);
+        }
+    }
+
+    m_samples.fetch_add(n, std::memory_order_relaxed);
+    m_bytes.store(m_writer.position(), std::memory_order_relaxed);
+    return !m_writer.failed();
+}
+
+/**
+ * @brief 按块累加通道的电荷量 / 能量（功率未提供或无效（NaN/Inf/0）时按 V*I 计算）
+ */
+void CaptureFileWriter::integrate(const SampleBlock &block, bool hasPower)
+{
+    const std::size_t n = block.size();
+    m_powerScratch.resize(n);
+    double *power = m_powerScratch.data();
+    const double *v = block.voltage.data();
+    const double *i = block.current.data();
+    for (std::size_t k = 0; k < n; ++k) {
+        const double p = hasPower ? block.power[k] : 0.0;
+        power[k] = (std::isnan(p) || std::isinf(p) || p == 0.0) ? v[k] * i[k] : p;
+    }
+
+    std::lock_guard<std::mutex> lock(m_integratorMutex);
+    if (std::size_t(block.channelId) >= m_integrators.size()) {
+        m_integrators.resize(std::size_t(block.channelId) + 1);
+    }
+    m_integrators[std::size_t(block.channelId)].append(
+        block.isUniform() ? nullptr : block.time.data(), block.t0, block.dt, i, power, n);
+}
+
+bool CaptureFileWriter::integrator(int channelId, ChannelIntegrator &out) const
+{
+    std::lock_guard<std::mutex> lock(m_integratorMutex);
+    if (channelId < 0 || std::size_t(channelId) >= m_integrators.size()) {
+        return false;
+    }
+    out = m_integrators[std::size_t(channelId)];
+    return true;
+}
+
+/**
+ * @brief 计算摘要并把通道当前的块写入文件
+ */
+void CaptureFileWriter::flushChunk(int channelId, Staging &s)
+{
+    const std::uint32_t count = std::uint32_t(s.size());
+    if (count == 0) {
+        return;
+    }
+    POWERDAQ_TRACE_SCOPE("capture/flushChunk");
+    const std::uint32_t summaryCount = (count + m_summaryBlock - 1) / m_summaryBlock;
+
+    IndexEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.channelId = channelId;
+    entry.count = count;
+    entry.flags = s.explicitTime ? kExplicitTime : 0u;
+    entry.summaryCount = summaryCount;
+    entry.dt = s.dt;
+    entry.offset = m_writer.position();
+    entry.firstSample = s.nextSample;
+    entry.tFirst = s.explicitTime ? s.time.front() : s.t0;
+    entry.tLast = s.explicitTime ? s.time.back() : s.t0 + double(count - 1) * s.dt;
+
+    // 每列按 summaryBlock 分段求 Min/Max，再合并出整块的摘要
+    m_summaryScratch.resize(std::size_t(kValueColumns) * summaryCount);
+    for (int c = 0; c < kValueColumns; ++c) {
+        const double *values = s.columns[c].data();
+        SummaryEntry &whole = entry.summary[c];
+        for (std::uint32_t b = 0; b < summaryCount; ++b) {
+            const std::uint32_t begin = b * m_summaryBlock;
+            const std::uint32_t len = std::min(m_summaryBlock, count - begin);
+            SpanReduction r;
+            reduceSpan(values + begin, len, r);
+            SummaryEntry &e = m_summaryScratch[std::size_t(c) * summaryCount + b];
+            e.min = r.min;
+            e.max = r.max;
+            e.minAt = begin + std::uint32_t(r.minAt);
+            e.maxAt = begin + std::uint32_t(r.maxAt);
+            if (b == 0) {
+                whole = e;
+            } else {
+                mergeSummary(whole, e);
+            }
+        }
+    }
+
+    ChunkHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = kChunkMagic;
+    header.channelId = channelId;
+    header.count = count;
+    header.flags = entry.flags;
+    header.firstSample = s.nextSample;
+    header.t0 = entry.tFirst;
+    header.dt = s.dt;
+    header.tLast = entry.tLast;
+    header.summaryCount = summaryCount;
+    header.recordBytes = recordBytes(count, summaryCount, header.flags);
+
+    m_writer.write(&header, sizeof(header));
+    m_writer.write(m_summaryScratch.data(), m_summaryScratch.size() * sizeof(SummaryEntry));
+    if (s.explicitTime) {
+        m_writer.write(s.time.data(), count * sizeof(double));
+    }
+    for (int c = 0; c < kValueColumns; ++c) {
+        m_writer.write(s.columns[c].data(), count * sizeof(double));
+    }
+    m_index.push_back(entry);
+
+    // 复用各列容量
+    s.nextSample += count;
+    s.time.clear();
+    for (std::vector<double> &column : s.columns) {
+        column.clear();
+    }
+}
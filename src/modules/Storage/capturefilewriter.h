@@ -0,0 +1,89 @@
+#ifndef CAPTUREFILEWRITER_H
+#define CAPTUREFILEWRITER_H
+
+#include "capturefileformat.h"
+#include "channelintegrator.h"
+#include "idatasource.h"
+#include "sequentialwriter.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 采集文件写入端（格式见 CaptureFormat），可直接作为纯采集模式的 BlockSink
+ *
+ * 每个通道在内存中攒满 chunkSamples 个样点后，计算块摘要并整块追加到文件；
+ * 时间不连续（丢数据、时间跳变）或采样方式改变时提前结束当前块。
+ * close() 写出各通道未满的块，再写入块索引和文件尾。
+ *
+ * push() 在采集线程中调用；写盘由 SequentialWriter 的写盘线程完成，磁盘跟不上时 push() 阻塞，
+ * 数据源因此落后实时，按自身策略丢弃数据。
+ *
+ * 纯采集模式下数据不经过 ChannelStore，电荷量 / 能量累计也在 push() 中按通道积分，
+ * 功率列的取值规则与 ChannelBuffer 相同；open() 时清零，close() 后保留到下一次 open()。
+ */
+class CaptureFileWriter : public BlockSink
+{
+public:
+    explicit CaptureFileWriter(std::uint32_t chunkSamples = CaptureFormat::kDefaultChunkSamples,
+                               std::uint32_t summaryBlock = CaptureFormat::kDefaultSummaryBlock);
+
+    bool open(const std::string &path);
+    bool close();
+    bool isOpen() const { return m_writer.isOpen(); }
+    const std::string &path() const { return m_path; }
+
+    bool push(SampleBlock &&block) override;
+    bool congested() const override { return false; }
+
+    std::uint64_t recordedSamples() const { return m_samples.load(std::memory_order_relaxed); }
+    std::uint64_t bytesWritten() const { return m_bytes.load(std::memory_order_relaxed); }
+    std::uint64_t bytesFlushed() const { return m_writer.bytesFlushed(); }
+    std::uint64_t stalls() const { return m_writer.stalls(); }
+    bool failed() const { return m_writer.failed(); }
+
+    /**
+     * @brief 指定通道电荷量 / 能量累计的快照（可在任意线程调用）
+     * @return 该通道尚无数据时返回 false
+     */
+    bool integrator(int channelId, ChannelIntegrator &out) const;
+
+private:
+    /**
+     * @brief 一个通道正在攒的块
+     */
+    struct Staging {
+        std::int64_t nextSample = 0;    // 下一个样点在通道内的序号
+        bool explicitTime = false;
+        double t0 = 0.0;
+        double dt = 0.0;
+        std::vector<double> time;       // 仅 explicitTime
+        std::vector<double> columns[CaptureFormat::kValueColumns];
+        std::size_t size() const { return columns[0].size(); }
+    };
+
+    Staging &staging(int channelId);
+    bool continues(const Staging &s, const SampleBlock &block) const;
+    void flushChunk(int channelId, Staging &s);
+    void integrate(const SampleBlock &block, bool hasPower);
+
+    std::uint32_t m_chunkSamples;
+    std::uint32_t m_summaryBlock;
+    SequentialWriter m_writer;
+    std::string m_path;
+    std::vector<Staging> m_channels;                // 按通道号索引
+    std::vector<CaptureFormat::IndexEntry> m_index;
+    std::vector<CaptureFormat::SummaryEntry> m_summaryScratch;
+    std::vector<double> m_powerScratch;             // 积分用的功率列（无效值按 V*I 补齐）
+
+    mutable std::mutex m_integratorMutex;           // 保护 m_integrators（GUI 线程读取快照）
+    std::vector<ChannelIntegrator> m_integrators;   // 按通道号索引
+
+    std::atomic<std::uint64_t> m_samples{0};
+    std::atomic<std::uint64_t> m_bytes{0};
+};
+
+#endif // CAPTUREFILEWRITER_H
@@ -0,0 +1,150 @@
+#include "sequentialwriter.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <cstring>
+
+constexpr std::size_t SequentialWriter::kAlignment;
+
+SequentialWriter::SequentialWriter(std::size_t bufferBytes, std::size_t bufferCount)
+{
+    m_bufferBytes = std::max(kAlignment, (bufferBytes + kAlignment - 1) / kAlignment * kAlignment);
+    m_buffers.resize(std::max<std::size_t>(2, bufferCount));
+}
+
+SequentialWriter::~SequentialWriter()
+{
+    close();
+}
+
+bool SequentialWriter::open(const std::string &path)
+{
+    close();
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        return false;
+    }
+    // 数据已在本类中按大块缓冲，关闭 stdio 缓冲，避免再拷贝一次
+    std::setvbuf(m_file, nullptr, _IONBF, 0);
+
+    // 缓冲在第一次打开时分配，之后复用
+    m_free.clear();
+    m_full.clear();
+    for (Buffer &b : m_buffers) {
+        if (!b.storage) {
+            b.storage.reset(new unsigned char[m_bufferBytes + kAlignment]);
+            const std::uintptr_t p = reinterpret_cast<std::uintptr_t>(b.storage.get());
+            b.data = b.storage.get() + ((kAlignment - p % kAlignment) % kAlignment);
+        }
+        b.used = 0;
+        m_free.push_back(&b);
+    }
+    m_current = m_free.front();
+    m_free.pop_front();
+
+    m_position = 0;
+    m_stop = false;
+    m_failed.store(false, std::memory_order_relaxed);
+    m_flushed.store(0, std::memory_order_relaxed);
+    m_stalls.store(0, std::memory_order_relaxed);
+    m_thread = std::thread(&SequentialWriter::run, this);
+    return true;
+}
+
+bool SequentialWriter::write(const void *data, std::size_t bytes)
+{
+    if (!m_file) {
+        return false;
+    }
+    const unsigned char *src = static_cast<const unsigned char *>(data);
+    while (bytes > 0) {
+        const std::size_t n = std::min(bytes, m_bufferBytes - m_current->used);
+        std::memcpy(m_current->data + m_current->used, src, n);
+        m_current->used += n;
+        m_position += n;
+        src += n;
+        bytes -= n;
+        if (m_current->used == m_bufferBytes) {
+            submitCurrent();
+        }
+    }
+    return !failed();
+}
+
+void SequentialWriter::submitCurrent()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_full.push_back(m_current);
+    m_current = nullptr;
+    m_fullReady.notify_one();
+
+    if (m_free.empty()) {
+        m_stalls.fetch_add(1, std::memory_order_relaxed);
+        m_freeReady.wait(lock, [this]() { return !m_free.empty(); });
+    }
+    m_current = m_free.front();
+    m_free.pop_front();
+    m_current->used = 0;
+}
+
+bool SequentialWriter::close()
+{
+    if (!m_file) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_current && m_current->used > 0) {
+            m_full.push_back(m_current);
+            m_current = nullptr;
+        }
+        m_stop = true;
+    }
+    m_fullReady.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    if (std::fclose(m_file) != 0) {
+        m_failed.store(true, std::memory_order_relaxed);
+    }
+    m_file = nullptr;
+    m_current = nullptr;
+    return !failed();
+}
+
+void SequentialWriter::run()
+{
+    Tracer::setThreadName("writer");
+    for (;;) {
+        Buffer *buffer = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_fullReady.wait(lock, [this]() { return m_stop || !m_full.empty(); });
+            if (m_full.empty()) {
+                return;     // m_stop 且已写完
+            }
+            buffer = m_full.front();
+            m_full.pop_front();
+        }
+
+        // 出错后不再写盘，但照常归还缓冲，避免调用方永久阻塞
+        if (!failed()) {
+            POWERDAQ_TRACE_SCOPE("writer/fwrite");
+            if (std::fwrite(buffer->data, 1, buffer->used, m_file) == buffer->used) {
+                m_flushed.fetch_add(buffer->used, std::memory_order_relaxed);
+            } else {
+                m_failed.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            buffer->used = 0;
+            m_free.push_back(buffer);
+        }
+        m_freeReady.notify_one();
+    }
+}
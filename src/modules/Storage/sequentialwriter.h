@@ -0,0 +1,93 @@
+#ifndef SEQUENTIALWRITER_H
+#define SEQUENTIALWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 顺序写文件：大块对齐缓冲 + 独立写盘线程
+ *
+ * 调用方 write() 只把数据拷进当前缓冲（按 4 KiB 对齐分配，大小为 4 KiB 的整数倍），
+ * 缓冲写满后交给写盘线程整块写出，调用方换下一个空闲缓冲继续。
+ * 所有缓冲都在等待写盘时 write() 阻塞（计入 stalls()），生产速度因此被限制在磁盘带宽。
+ *
+ * 文件只追加、不回写；write() / close() 只在一个线程中调用。
+ */
+class SequentialWriter
+{
+public:
+    static constexpr std::size_t kAlignment = 4096;
+
+    /**
+     * @param bufferBytes 每个缓冲的大小（向上取整到 4 KiB）
+     * @param bufferCount 缓冲个数（至少 2：一个填充、一个写盘）
+     */
+    explicit SequentialWriter(std::size_t bufferBytes = std::size_t(8) << 20, std::size_t bufferCount = 4);
+    ~SequentialWriter();
+
+    SequentialWriter(const SequentialWriter &) = delete;
+    SequentialWriter &operator=(const SequentialWriter &) = delete;
+
+    /**
+     * @brief 创建（覆盖）文件并启动写盘线程
+     */
+    bool open(const std::string &path);
+
+    /**
+     * @brief 追加数据
+     * @return 之前发生过写盘错误时返回 false
+     */
+    bool write(const void *data, std::size_t bytes);
+
+    /**
+     * @brief 写出剩余数据并关闭文件
+     * @return 整个过程中没有发生写盘错误
+     */
+    bool close();
+
+    bool isOpen() const { return m_file != nullptr; }
+    bool failed() const { return m_failed.load(std::memory_order_relaxed); }
+
+    std::uint64_t position() const { return m_position; }      // 已追加的字节数（即下一次写入的文件偏移）
+    std::uint64_t bytesFlushed() const { return m_flushed.load(std::memory_order_relaxed); }   // 已写到磁盘的字节数
+    std::uint64_t stalls() const { return m_stalls.load(std::memory_order_relaxed); }         // 等待空闲缓冲的次数
+
+private:
+    struct Buffer {
+        std::unique_ptr<unsigned char[]> storage;
+        unsigned char *data = nullptr;  // storage 内按 kAlignment 对齐的起点
+        std::size_t used = 0;
+    };
+
+    void run();
+    void submitCurrent();   // 当前缓冲交给写盘线程，并取得一个空闲缓冲（可能等待）
+
+    std::size_t m_bufferBytes = 0;
+    std::vector<Buffer> m_buffers;
+    Buffer *m_current = nullptr;
+    std::uint64_t m_position = 0;
+
+    std::FILE *m_file = nullptr;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_fullReady;    // 有待写缓冲 / 需要退出
+    std::condition_variable m_freeReady;    // 有空闲缓冲
+    std::deque<Buffer *> m_full;
+    std::deque<Buffer *> m_free;
+    bool m_stop = false;
+
+    std::atomic<bool> m_failed{false};
+    std::atomic<std::uint64_t> m_flushed{0};
+    std::atomic<std::uint64_t> m_stalls{0};
+};
+
+#endif // SEQUENTIALWRITER_H
@@ -0,0 +1,406 @@
+#include "channelplottable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// 按符号域裁剪范围：跨越 0 时不做精确裁剪，视为该符号域内没有范围
+QCPRange restrictToSign(const QCPRange &range, QCP::SignDomain domain, bool &foundRange)
+{
+    if ((domain == QCP::sdPositive && range.lower <= 0.0) ||
+        (domain == QCP::sdNegative && range.upper >= 0.0)) {
+        foundRange = false;
+    }
+    return range;
+}
+}
+
+ChannelPlottable::ChannelPlottable(QCPAxis *keyAxis, QCPAxis *valueAxis)
+    : QCPAbstractPlottable(keyAxis, valueAxis)
+{
+}
+
+void ChannelPlottable::setSource(const ChannelSlotPtr &slot, Column column)
+{
+    m_slot = slot;
+    m_column = column;
+    m_columns.reset();
+}
+
+void ChannelPlottable::clearColumns()
+{
+    m_columns.reset();
+    m_lines.clear();
+}
+
+const ChannelBuffer *ChannelPlottable::data() const
+{
+    return m_slot ? &m_slot->data : nullptr;
+}
+
+// --- 数据访问：通道数据池（冷数据在前，热窗口在后）或采集文件（ChannelSlot::file） ---
+
+std::int64_t ChannelPlottable::sampleCount() const
+{
+    if (!m_slot) {
+        return 0;
+    }
+    if (m_slot->file) {
+        return m_slot->file->sampleCount(m_slot->fileChannel);
+    }
+    const ChannelBuffer &d = m_slot->data;
+    return d.cold().size()
+        + std::min<std::int64_t>(d.time().size(),
+                                 std::int64_t(ViewportDownsampler::columnValues(d, m_column).size()));
+}
+
+double ChannelPlottable::timeAt(std::int64_t i) const
+{
+    if (m_slot->file) {
+        return m_slot->file->timeAt(m_slot->fileChannel, i);
+    }
+    const ColdStore &cold = m_slot->data.cold();
+    if (i < cold.size()) {
+        return cold.timeAt(i);
+    }
+    return m_slot->data.time().at(i - cold.size());
+}
+
+double ChannelPlottable::valueAt(std::int64_t i) const
+{
+    if (m_slot->file) {
+        return m_slot->file->valueAt(m_slot->fileChannel, ViewportDownsampler::fileColumn(m_column), i);
+    }
+    const ColdStore &cold = m_slot->data.cold();
+    if (i < cold.size()) {
+        return cold.valueAt(ViewportDownsampler::coldColumn(m_column), i);
+    }
+    return ViewportDownsampler::columnValues(m_slot->data, m_column)[std::size_t(i - cold.size())];
+}
+
+std::int64_t ChannelPlottable::lowerBound(double t) const
+{
+    if (m_slot->file) {
+        return m_slot->file->lowerBound(m_slot->fileChannel, t);
+    }
+    const ColdStore &cold = m_slot->data.cold();
+    const std::int64_t c = cold.lowerBound(t);
+    if (c < cold.size()) {
+        return c;
+    }
+    return cold.size() + m_slot->data.time().lowerBound(t);
+}
+
+std::int64_t ChannelPlottable::upperBound(double t) const
+{
+    if (m_slot->file) {
+        return m_slot->file->upperBound(m_slot->fileChannel, t);
+    }
+    const ColdStore &cold = m_slot->data.cold();
+    const std::int64_t c = cold.upperBound(t);
+    if (c < cold.size()) {
+        return c;
+    }
+    return cold.size() + m_slot->data.time().upperBound(t);
+}
+
+std::int64_t ChannelPlottable::nearest(double t) const
+{
+    if (m_slot->file) {
+        return m_slot->file->nearest(m_slot->fileChannel, t);
+    }
+    if (m_slot->data.cold().isEmpty()) {
+        return m_slot->data.time().nearest(t);
+    }
+    // 冷热数据衔接处：取 t 两侧样点中较近的一个
+    const std::int64_t n = sampleCount();
+    const std::int64_t i = std::min(lowerBound(t), n - 1);
+    if (i > 0 && t - timeAt(i - 1) <= timeAt(i) - t) {
+        return i - 1;
+    }
+    return i;
+}
+
+bool ChannelPlottable::valueRange(std::int64_t begin, std::int64_t end, double &min, double &max) const
+{
+    if (m_slot->file) {
+        const CaptureFile::Summary sum = m_slot->file->summarize(
+            m_slot->fileChannel, ViewportDownsampler::fileColumn(m_column), begin, end);
+        min = sum.min;
+        max = sum.max;
+        return sum.minAt >= 0;
+    }
+    const ChannelBuffer &d = m_slot->data;
+    const ColdStore &cold = d.cold();
+    const std::int64_t coldN = cold.size();
+    bool found = false;
+    if (begin < coldN) {
+        const ColdStore::Summary sum = cold.summarize(ViewportDownsampler::coldColumn(m_column),
+                                                      begin, std::min(end, coldN));
+        if (sum.minAt >= 0) {
+            min = sum.min;
+            max = sum.max;
+            found = true;
+        }
+    }
+    if (end > coldN) {
+        const MinMaxPyramid::Summary sum = ViewportDownsampler::columnPyramid(d, m_column)
+            .summarize(ViewportDownsampler::columnValues(d, m_column), d.time().firstIndex(),
+                       std::max(begin, coldN) - coldN, end - coldN);
+        if (sum.count > 0) {
+            min = found ? std::min(min, sum.min) : sum.min;
+            max = found ? std::max(max, sum.max) : sum.max;
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool ChannelPlottable::sampleNear(double key, double &time, double &value) const
+{
+    const std::int64_t n = sampleCount();
+    if (n == 0) {
+        return false;
+    }
+    const std::int64_t idx = nearest(key);
+    if (idx < 0 || idx >= n) {
+        return false;
+    }
+    time = timeAt(idx);
+    value = valueAt(idx);
+    return true;
+}
+
+/**
+ * @brief 点选测试：计算到最近一次绘制的折线的像素距离
+ */
+double ChannelPlottable::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+{
+    if ((onlySelectable && mSelectable == QCP::stNone) || (!m_stripMode && m_lines.size() < 2)) {
+        return -1;
+    }
+    if (!mKeyAxis || !mValueAxis) {
+        return -1;
+    }
+    if (!mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()) &&
+        !mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect)) {
+        return -1;
+    }
+
+    const double tolerance = mParentPlot->selectionTolerance();
+    const QCPVector2D p(pos);
+    double best = std::numeric_limits<double>::max();
+    if (m_stripMode) {
+        // 条带图模式下 m_lines 只有最新几列：改用容差窗口内样点的最值区间计算竖向距离
+        const std::int64_t n = sampleCount();
+        const double k0 = mKeyAxis->pixelToCoord(pos.x() - tolerance);
+        const double k1 = mKeyAxis->pixelToCoord(pos.x() + tolerance);
+        double min = 0.0, max = 0.0;
+        if (n > 0 && valueRange(lowerBound(std::min(k0, k1)), upperBound(std::max(k0, k1)), min, max)) {
+            const double y0 = mValueAxis->coordToPixel(min);
+            const double y1 = mValueAxis->coordToPixel(max);
+            const double dy = std::max(0.0, std::max(std::min(y0, y1) - pos.y(), pos.y() - std::max(y0, y1)));
+            best = dy * dy;
+        }
+    }
+    // 只检查横向落在容差窗口内的线段
+    for (int i = 1; i < m_lines.size() && !m_stripMode; ++i) {
+        const QPointF &a = m_lines.at(i - 1);
+        const QPointF &b = m_lines.at(i);
+        if (qIsNaN(a.y()) || qIsNaN(b.y())) {
+            continue;
+        }
+        if (std::max(a.x(), b.x()) < pos.x() - tolerance || std::min(a.x(), b.x()) > pos.x() + tolerance) {
+            continue;
+        }
+        best = std::min(best, p.distanceSquaredToLine(QCPVector2D(a), QCPVector2D(b)));
+    }
+    if (best == std::numeric_limits<double>::max()) {
+        return -1;
+    }
+
+    if (details) {
+        // 选中信息记录离点击位置最近的原始样点序号（plottableClick 的 dataIndex）
+        const int index = (sampleCount() > 0)
+            ? int(std::max<std::int64_t>(0, nearest(mKeyAxis->pixelToCoord(pos.x())))) : 0;
+        details->setValue(QCPDataSelection(QCPDataRange(index, index + 1)));
+    }
+    return std::sqrt(best);
+}
+
+QCPRange ChannelPlottable::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
+{
+    const std::int64_t n = sampleCount();
+    foundRange = n > 0;
+    if (!foundRange) {
+        return QCPRange();
+    }
+    return restrictToSign(QCPRange(timeAt(0), timeAt(n - 1)), inSignDomain, foundRange);
+}
+
+QCPRange ChannelPlottable::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain,
+                                         const QCPRange &inKeyRange) const
+{
+    foundRange = false;
+    const std::int64_t n = sampleCount();
+    if (n == 0) {
+        return QCPRange();
+    }
+
+    // 未指定 key 范围时统计全部数据；区间最值由 Min/Max 金字塔（或文件块摘要）汇总
+    const bool allKeys = (inKeyRange.lower == 0.0 && inKeyRange.upper == 0.0);
+    const std::int64_t begin = allKeys ? 0 : lowerBound(inKeyRange.lower);
+    const std::int64_t end = allKeys ? n : upperBound(inKeyRange.upper);
+    double min = 0.0, max = 0.0;
+    if (!valueRange(begin, end, min, max)) {
+        return QCPRange();
+    }
+    foundRange = true;
+    return restrictToSign(QCPRange(min, max), inSignDomain, foundRange);
+}
+
+void ChannelPlottable::draw(QCPPainter *painter)
+{
+    if (m_stripMode) {
+        return;     // 由 StripChart 增量绘制（m_lines 保留 drawSpan() 的结果）
+    }
+    m_lines.clear();
+    const std::int64_t n = sampleCount();
+    if (n == 0 || !mKeyAxis || !mValueAxis) {
+        return;
+    }
+
+    const QCPRange xr = mKeyAxis->range();
+    const std::int64_t i0 = std::min(n, lowerBound(xr.lower));
+    const std::int64_t i1 = std::min(n, upperBound(xr.upper));
+
+    if (ViewportDownsampler::drawsRaw(i1 - i0, mKeyAxis->axisRect()->width())) {
+        // 两侧各多取一个点，保证连线延伸到视图边缘
+        buildRawLines(std::max<std::int64_t>(0, i0 - 1), std::min(n, i1 + 1));
+    } else if (m_columns) {
+        buildColumnLines(*m_columns);
+    }
+    paintLines(painter);
+}
+
+/**
+ * @brief 条带图增量绘制：GUI 线程同步降采样 [lower, upper]（只有新到达的几列，开销很小）
+ */
+void ChannelPlottable::drawSpan(QCPPainter *painter, double lower, double upper, int columns)
+{
+    m_lines.clear();
+    const std::int64_t n = sampleCount();
+    if (n == 0 || columns <= 0 || !mKeyAxis || !mValueAxis) {
+        return;
+    }
+
+    // 原始点 / Min-Max 按整个视口的密度选择，与 draw() 一致
+    const QCPRange xr = mKeyAxis->range();
+    const bool raw = ViewportDownsampler::drawsRaw(
+        std::min(n, upperBound(xr.upper)) - std::min(n, lowerBound(xr.lower)), mKeyAxis->axisRect()->width());
+    if (!raw) {
+        const TimeRange span(lower, upper);
+        if (m_slot->file) {
+            ViewportDownsampler::downsample(*m_slot->file, m_slot->fileChannel, m_column, span, columns,
+                                            m_spanColumns);
+        } else {
+            ViewportDownsampler::downsample(m_slot->data, m_column, span, columns, m_spanColumns);
+        }
+        buildColumnLines(m_spanColumns);
+    }
+    if (raw || m_spanColumns.width() == 0) {
+        const std::int64_t i0 = std::min(n, lowerBound(lower));
+        const std::int64_t i1 = std::min(n, upperBound(upper));
+        buildRawLines(std::max<std::int64_t>(0, i0 - 1), std::min(n, i1 + 1));
+    }
+    paintLines(painter);
+}
+
+void ChannelPlottable::paintLines(QCPPainter *painter)
+{
+    if (m_lines.size() < 2) {
+        return;
+    }
+    applyDefaultAntialiasingHint(painter);
+    if (selected() && mSelectionDecorator) {
+        mSelectionDecorator->applyPen(painter);
+    } else {
+        painter->setPen(mPen);
+    }
+    painter->setBrush(Qt::NoBrush);
+    drawLines(painter);
+}
+
+/**
+ * @brief 放大时：直接读取原始样点 [begin, end)
+ */
+void ChannelPlottable::buildRawLines(std::int64_t begin, std::int64_t end)
+{
+    m_lines.reserve(int(end - begin));
+    for (std::int64_t i = begin; i < end; ++i) {
+        m_lines.push_back(coordsToPixels(timeAt(i), valueAt(i)));
+    }
+}
+
+/**
+ * @brief 缩小时：每个像素列画最值两个点（列内无样点时跳过，前后两列直接相连）
+ */
+void ChannelPlottable::buildColumnLines(const MinMaxColumns &cols)
+{
+    m_lines.reserve(cols.width() * 2);
+    for (int c = 0; c < cols.width(); ++c) {
+        if (qIsNaN(cols.first[std::size_t(c)])) {
+            continue;
+        }
+        const double key = cols.columnCenter(c);
+        m_lines.push_back(coordsToPixels(key, cols.first[std::size_t(c)]));
+        m_lines.push_back(coordsToPixels(key, cols.second[std::size_t(c)]));
+    }
+}
+
+/**
+ * @brief 绘制折线（与 QCPGraph 相同的快速路径：1px 画笔转为 cosmetic，实线逐段画）
+ */
+void ChannelPlottable::drawLines(QCPPainter *painter) const
+{
+    if (!painter->modes().testFlag(QCPPainter::pmVectorized) &&
+        qFuzzyCompare(painter->pen().widthF(), 1.0)) {
+        QPen pen = painter->pen();
+        pen.setWidth(0);
+        painter->setPen(pen);
+    }
+
+    const int size = m_lines.size();
+    if (mParentPlot->plottingHints().testFlag(QCP::phFastPolylines) &&
+        painter->pen().style() == Qt::SolidLine &&
+        !painter->modes().testFlag(QCPPainter::pmVectorized) &&
+        !painter->modes().testFlag(QCPPainter::pmNoCaching)) {
+        for (int i = 1; i < size; ++i) {
+            const QPointF &a = m_lines.at(i - 1);
+            const QPointF &b = m_lines.at(i);
+            if (!qIsNaN(a.y()) && !qIsNaN(b.y())) {    // NaN 处断开
+                painter->drawLine(a, b);
+            }
+        }
+        return;
+    }
+
+    int segmentStart = 0;
+    for (int i = 0; i < size; ++i) {
+        const double y = m_lines.at(i).y();
+        if (qIsNaN(y) || qIsInf(y)) {
+            painter->drawPolyline(m_lines.constData() + segmentStart, i - segmentStart);
+            segmentStart = i + 1;
+        }
+    }
+    painter->drawPolyline(m_lines.constData() + segmentStart, size - segmentStart);
+}
+
+void ChannelPlottable::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
+{
+    applyDefaultAntialiasingHint(painter);
+    painter->setPen(mPen);
+    painter->drawLine(QLineF(rect.left(), rect.top() + rect.height() / 2.0,
+                             rect.right() + 5, rect.top() + rect.height() / 2.0));
+}
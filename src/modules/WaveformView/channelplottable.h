@@ -0,0 +1,104 @@
+#ifndef CHANNELPLOTTABLE_H
+#define CHANNELPLOTTABLE_H
+
+#include "qcustomplot.h"
+#include "viewportdownsampler.h"
+
+/**
+ * @brief 直接从通道数据池绘制的曲线（零拷贝）
+ *
+ * 取代 QCPGraph：不再维护自己的 QCPGraphDataContainer，绘制时按当前视口直接读取数据：
+ * - 可见样点较少（放大）时，直接读取通道数据池中的原始样点；
+ * - 否则绘制降采样线程算出的逐像素列 Min-Max（MinMaxColumns），每列两个值，按列中心时间定位。
+ * 因此每帧既不重建数据容器，也不再为每个可见点复制一份 16 字节的 QCPGraphData。
+ *
+ * 通道数据只由 GUI 线程写入，绘制同样在 GUI 线程，读取时无需加锁。
+ * 条带图模式（setStripMode）下曲线不自行绘制，由 StripChart 调用 drawSpan() 只绘制新到达的像素列。
+ * 数据槽以采集文件为后备存储（ChannelSlot::file）时，同样的绘制路径直接读取内存映射的文件。
+ */
+class ChannelPlottable : public QCPAbstractPlottable
+{
+    Q_OBJECT
+
+public:
+    using Column = ViewportDownsampler::Column;
+
+    ChannelPlottable(QCPAxis *keyAxis, QCPAxis *valueAxis);
+
+    /**
+     * @brief 绑定通道数据及要绘制的列
+     */
+    void setSource(const ChannelSlotPtr &slot, Column column);
+    const ChannelSlotPtr &source() const { return m_slot; }
+    Column column() const { return m_column; }
+
+    /**
+     * @brief 设置降采样线程算出的最新 Min-Max 列（共享指针交换，无拷贝）
+     */
+    void setColumns(const MinMaxColumnsPtr &columns) { m_columns = columns; }
+
+    /**
+     * @brief 丢弃已算出的 Min-Max 列（清空数据时调用）
+     */
+    void clearColumns();
+
+    /**
+     * @brief 条带图模式：draw() 不再绘制，改由 StripChart 调用 drawSpan() 增量绘制
+     */
+    void setStripMode(bool enabled) { m_stripMode = enabled; }
+    bool stripMode() const { return m_stripMode; }
+
+    /**
+     * @brief 同步绘制时间段 [lower, upper]（按 columns 个像素列降采样，坐标映射沿用当前坐标轴）
+     *
+     * 原始点 / Min-Max 列的选择与 draw() 相同，按整个视口的样点密度决定，
+     * 保证增量绘制的列与整体重绘的结果一致。
+     */
+    void drawSpan(QCPPainter *painter, double lower, double upper, int columns);
+
+    /**
+     * @brief 最近一次绘制交给 QCustomPlot 的折线点数（性能统计）
+     */
+    int drawnPoints() const { return m_lines.size(); }
+
+    /**
+     * @brief 通道中最近 key 的样点：成功时写入时间和数值并返回 true
+     */
+    bool sampleNear(double key, double &time, double &value) const;
+
+    // reimplemented virtual methods:
+    double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details = nullptr) const override;
+    QCPRange getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain = QCP::sdBoth) const override;
+    QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain = QCP::sdBoth,
+                           const QCPRange &inKeyRange = QCPRange()) const override;
+
+protected:
+    void draw(QCPPainter *painter) override;
+    void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const override;
+
+private:
+    const ChannelBuffer *data() const;
+
+    // 数据访问（通道数据池或采集文件，调用前 sampleCount() 必须大于 0）
+    std::int64_t sampleCount() const;
+    double timeAt(std::int64_t i) const;
+    double valueAt(std::int64_t i) const;
+    std::int64_t lowerBound(double t) const;
+    std::int64_t upperBound(double t) const;
+    std::int64_t nearest(double t) const;
+    bool valueRange(std::int64_t begin, std::int64_t end, double &min, double &max) const;
+
+    void buildRawLines(std::int64_t begin, std::int64_t end);
+    void buildColumnLines(const MinMaxColumns &cols);
+    void paintLines(QCPPainter *painter);
+    void drawLines(QCPPainter *painter) const;
+
+    ChannelSlotPtr m_slot;
+    Column m_column = Column::Voltage;
+    MinMaxColumnsPtr m_columns;
+    QVector<QPointF> m_lines;       // 最近一次绘制的像素折线（复用缓冲，也用于点选测试）
+    bool m_stripMode = false;
+    MinMaxColumns m_spanColumns;    // drawSpan() 的复用缓冲
+};
+
+#endif // CHANNELPLOTTABLE_H
@@ -0,0 +1,79 @@
+#include "perfhud.h"
+
+#include <QFont>
+#include <QFontDatabase>
+#include <algorithm>
+
+namespace {
+QString formatRate(double perSecond)
+{
+    if (perSecond >= 1e6) {
+        return QString("%1 M").arg(perSecond / 1e6, 0, 'f', 2);
+    }
+    if (perSecond >= 1e3) {
+        return QString("%1 k").arg(perSecond / 1e3, 0, 'f', 1);
+    }
+    return QString("%1 ").arg(perSecond, 0, 'f', 0);
+}
+}
+
+PerfHud::PerfHud(QWidget *parent)
+    : QLabel(parent)
+{
+    // 不透明背景：浮层刷新时不需要重绘下面的图表
+    setAutoFillBackground(true);
+    setStyleSheet("QLabel { background-color: rgb(20, 20, 20); color: rgb(120, 255, 120);"
+                  " border: 1px solid rgb(80, 80, 80); padding: 4px; }");
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setAttribute(Qt::WA_TransparentForMouseEvents);    // 不影响图表的鼠标交互
+    setTextFormat(Qt::PlainText);
+    setText("FPS      --");
+    adjustSize();
+    hide();
+}
+
+void PerfHud::restart()
+{
+    m_clock.invalidate();
+}
+
+void PerfHud::present(const Counters &c)
+{
+    if (!m_clock.isValid()) {
+        // 第一次采样只建立基准
+        m_clock.start();
+        m_last = c;
+        return;
+    }
+    const double seconds = std::max<qint64>(1, m_clock.restart()) / 1000.0;
+
+    const quint64 frames = c.renderedFrames - m_last.renderedFrames;
+    const quint64 passes = c.downsamplePasses - m_last.downsamplePasses;
+    const double fps = frames / seconds;
+    const double ingestRate = (c.ingestedSamples - m_last.ingestedSamples) / seconds;
+    const double downsampleMs = passes > 0
+        ? (c.downsampleNs - m_last.downsampleNs) / 1.0e6 / passes : 0.0;
+    const double storeMiB = c.storeBytes / 1048576.0;
+
+    setText(QString("FPS      %1\n"
+                    "replot   p50 %2 ms  p99 %3 ms\n"
+                    "points   %4 / frame\n"
+                    "ingest   %5S/s  queue %6 blocks\n"
+                    "dropped  %7 blocks\n"
+                    "downsamp %8 ms x %9/s\n"
+                    "store    %10 MiB  (%11 ch, %12 MiB/ch)")
+                .arg(fps, 0, 'f', 1)
+                .arg(c.replotP50Ms, 0, 'f', 2)
+                .arg(c.replotP99Ms, 0, 'f', 2)
+                .arg(c.drawnPoints)
+                .arg(formatRate(ingestRate))
+                .arg(c.queuedBlocks)
+                .arg(c.droppedBlocks)
+                .arg(downsampleMs, 0, 'f', 2)
+                .arg(passes / seconds, 0, 'f', 0)
+                .arg(storeMiB, 0, 'f', 1)
+                .arg(c.channels)
+                .arg(c.channels > 0 ? storeMiB / c.channels : 0.0, 0, 'f', 1));
+    adjustSize();
+    m_last = c;
+}
@@ -0,0 +1,61 @@
+#ifndef PERFHUD_H
+#define PERFHUD_H
+
+#include <QLabel>
+#include <QElapsedTimer>
+#include <cstddef>
+
+/**
+ * @brief 性能统计浮层（叠加在波形图左上角，可随时开关）
+ *
+ * 各项计数器在各自的热路径上累加（渲染调度器、降采样线程、采集队列、数据写入），
+ * 跨线程的计数器均为无锁原子计数。浮层显示时每个显示帧检查一次，
+ * 每 kRefreshMs 采样一次计数器，换算成速率和分位数后更新文字；隐藏时不做任何采样。
+ */
+class PerfHud : public QLabel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kRefreshMs = 250;  // 文字刷新间隔（速率按该窗口计算）
+
+    /**
+     * @brief 一次采样的计数器（累计值；速率由相邻两次采样之差得到）
+     */
+    struct Counters {
+        quint64 renderedFrames = 0;     // 执行了重绘的帧数
+        double replotP50Ms = 0.0;       // 重绘耗时分位数
+        double replotP99Ms = 0.0;
+        qint64 drawnPoints = 0;         // 最近一帧交给 QCustomPlot 的折线点数（所有可见曲线）
+        quint64 ingestedSamples = 0;    // 写入数据池的样点数
+        std::size_t queuedBlocks = 0;   // 采集队列积压的块数
+        quint64 droppedBlocks = 0;      // 采集端丢弃的块数（队列积压，含数据源提前丢弃的块）
+        quint64 downsamplePasses = 0;   // 完成的降采样轮次
+        quint64 downsampleNs = 0;       // 降采样累计耗时
+        std::size_t storeBytes = 0;     // 数据池占用的内存
+        int channels = 0;               // 数据池中的通道数
+    };
+
+    explicit PerfHud(QWidget *parent = nullptr);
+
+    /**
+     * @brief 是否到了下一次采样时间（每帧调用，只读一次时钟）
+     */
+    bool refreshDue() const { return !m_clock.isValid() || m_clock.elapsed() >= kRefreshMs; }
+
+    /**
+     * @brief 用本次采样更新显示
+     */
+    void present(const Counters &counters);
+
+    /**
+     * @brief 重新开始统计窗口（显示浮层时调用，避免把隐藏期间的累计量算进速率）
+     */
+    void restart();
+
+private:
+    QElapsedTimer m_clock;
+    Counters m_last;
+};
+
+#endif // PERFHUD_H
@@ -0,0 +1,142 @@
+#include "renderscheduler.h"
+#include "qcustomplot.h"
+#include "tracer.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr int RenderScheduler::kMinFps;
+
+namespace {
+constexpr int kMaxFps = 240;
+constexpr double kLoadHigh = 0.75;      // 帧耗时超过帧间隔的该比例时降帧
+constexpr double kLoadLow = 0.40;       // 帧耗时低于该比例时回升
+constexpr double kSmoothing = 0.2;      // 帧耗时指数平均的权重
+}
+
+RenderScheduler::RenderScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(int(std::lround(m_intervalMs)));
+    connect(&m_timer, &QTimer::timeout, this, &RenderScheduler::onFrame);
+}
+
+void RenderScheduler::setTargetFps(int fps)
+{
+    m_targetFps = std::max(kMinFps, std::min(kMaxFps, fps));
+    m_intervalMs = 1000.0 / m_targetFps;
+    m_timer.setInterval(int(std::lround(m_intervalMs)));
+}
+
+void RenderScheduler::start()
+{
+    m_timer.start();
+}
+
+void RenderScheduler::stop()
+{
+    m_timer.stop();
+}
+
+void RenderScheduler::markChannelDirty(int channelId)
+{
+    if (!m_allChannelsDirty) {
+        m_dirtyChannels.insert(channelId);
+    }
+}
+
+void RenderScheduler::markAllChannelsDirty()
+{
+    m_allChannelsDirty = true;
+    m_dirtyChannels.clear();
+}
+
+void RenderScheduler::markPlotDirty(QCustomPlot *plot)
+{
+    if (!plot) {
+        return;
+    }
+    for (const QPointer<QCustomPlot> &p : m_dirtyPlots) {
+        if (p == plot) {
+            return;
+        }
+    }
+    m_dirtyPlots.push_back(plot);
+}
+
+/**
+ * @brief 帧回调：消费数据 -> 合并降采样 -> 合并重绘
+ */
+void RenderScheduler::onFrame()
+{
+    POWERDAQ_TRACE_SCOPE("frame");
+    QElapsedTimer clock;
+    clock.start();
+
+    emit frameStarted();
+
+    if (m_allChannelsDirty || !m_dirtyChannels.isEmpty()) {
+        const bool all = m_allChannelsDirty;
+        m_channelScratch.clear();
+        if (!all) {
+            for (int ch : m_dirtyChannels) {
+                m_channelScratch.push_back(ch);
+            }
+        }
+        m_allChannelsDirty = false;
+        m_dirtyChannels.clear();
+        emit channelsDirty(all, m_channelScratch);
+    }
+
+    if (m_dirtyPlots.isEmpty()) {
+        return;     // 空闲帧不计入负载统计
+    }
+    // 先取走列表：replot 过程中新产生的脏标记留到下一帧
+    QVector<QPointer<QCustomPlot>> plots;
+    plots.swap(m_dirtyPlots);
+    const qint64 replotStart = clock.nsecsElapsed();
+    for (const QPointer<QCustomPlot> &plot : plots) {
+        if (plot) {
+            POWERDAQ_TRACE_SCOPE("replot");
+            plot->replot(QCustomPlot::rpRefreshHint);
+        }
+    }
+    m_replotMs[std::size_t(m_renderedFrames % kReplotHistory)] =
+        float((clock.nsecsElapsed() - replotStart) / 1.0e6);
+    ++m_renderedFrames;
+
+    adaptInterval(clock.nsecsElapsed() / 1.0e6);
+}
+
+void RenderScheduler::replotPercentiles(double &p50Ms, double &p99Ms) const
+{
+    const std::size_t n = std::size_t(std::min(m_renderedFrames, quint64(kReplotHistory)));
+    if (n == 0) {
+        p50Ms = p99Ms = 0.0;
+        return;
+    }
+    std::array<float, kReplotHistory> sorted = m_replotMs;
+    std::sort(sorted.begin(), sorted.begin() + std::ptrdiff_t(n));
+    p50Ms = sorted[(n - 1) / 2];
+    p99Ms = sorted[std::min(n - 1, std::size_t(std::ceil(0.99 * double(n))) - 1)];
+}
+
+void RenderScheduler::adaptInterval(double frameMs)
+{
+    m_avgFrameMs = (m_avgFrameMs <= 0.0) ? frameMs
+                 : m_avgFrameMs + kSmoothing * (frameMs - m_avgFrameMs);
+
+    const double targetMs = 1000.0 / m_targetFps;
+    const double slowestMs = 1000.0 / kMinFps;
+    double interval = m_intervalMs;
+    if (m_avgFrameMs > interval * kLoadHigh) {
+        interval = std::min(slowestMs, interval * 1.25);       // 过载：降帧
+    } else if (m_avgFrameMs < interval * kLoadLow && interval > targetMs) {
+        interval = std::max(targetMs, interval * 0.9);         // 负载下降：回升
+    }
+    if (interval != m_intervalMs) {
+        m_intervalMs = interval;
+        m_timer.setInterval(int(std::lround(m_intervalMs)));
+    }
+}
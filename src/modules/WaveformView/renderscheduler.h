@@ -0,0 +1,106 @@
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <QSet>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <array>
+
+class QCustomPlot;
+
+/**
+ * @brief 渲染调度器：按显示帧合并降采样与重绘
+ *
+ * 数据写入、可见性切换、清空、测量工具拖动等操作不再直接重绘，而是把对应的
+ * 通道 / 图表标记为“脏”。调度器以目标帧率运行帧定时器，每帧依次：
+ * 1. 发出 frameStarted()：消费采集队列（可能标记新的脏通道）；
+ * 2. 发出 channelsDirty()：对本帧的脏通道提交一次降采样；
+ * 3. 对脏图表各调用一次 replot()。
+ * 因此无论数据包到达多快，每帧最多一次降采样和一次重绘。
+ *
+ * 自适应降帧：统计每帧实际耗时（指数平均），超过帧间隔的 75% 时逐步拉长帧间隔
+ * （最低 kMinFps），负载下降后再逐步恢复到目标帧率，避免事件队列积压。
+ */
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kDefaultFps = 60;
+    static constexpr int kMinFps = 10;      // 自适应降帧的下限
+
+    explicit RenderScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置目标帧率（kMinFps ~ 240）
+     */
+    void setTargetFps(int fps);
+    int targetFps() const { return m_targetFps; }
+
+    /**
+     * @brief 当前实际帧率（自适应降帧后可能低于目标帧率）
+     */
+    double currentFps() const { return 1000.0 / m_intervalMs; }
+
+    /**
+     * @brief 最近一帧的平均处理耗时（毫秒，指数平均）
+     */
+    double averageFrameMs() const { return m_avgFrameMs; }
+
+    // --- 性能统计（性能浮层每帧采样） ---
+    static constexpr int kReplotHistory = 128;  // 重绘耗时分位数的统计窗口（帧）
+
+    /**
+     * @brief 累计执行了重绘的帧数
+     */
+    quint64 renderedFrames() const { return m_renderedFrames; }
+
+    /**
+     * @brief 最近 kReplotHistory 帧重绘耗时的分位数（毫秒）
+     */
+    void replotPercentiles(double &p50Ms, double &p99Ms) const;
+
+    void start();
+    void stop();
+
+    // --- 脏标记 ---
+    void markChannelDirty(int channelId);   // 该通道需要重新降采样
+    void markAllChannelsDirty();            // 视口变化：所有通道需要重新降采样
+    void markPlotDirty(QCustomPlot *plot);  // 该图表需要重绘
+
+signals:
+    /**
+     * @brief 帧开始（消费采集数据）
+     */
+    void frameStarted();
+
+    /**
+     * @brief 本帧需要重新降采样的通道
+     * @param all 为 true 时表示所有通道（此时 channelIds 为空）
+     */
+    void channelsDirty(bool all, const QVector<int> &channelIds);
+
+private slots:
+    void onFrame();
+
+private:
+    void adaptInterval(double frameMs);     // 按本帧耗时调整帧间隔
+
+    QTimer m_timer;
+    int m_targetFps = kDefaultFps;
+    double m_intervalMs = 1000.0 / kDefaultFps;    // 当前帧间隔
+    double m_avgFrameMs = 0.0;                     // 帧耗时的指数平均
+
+    bool m_allChannelsDirty = false;
+    QSet<int> m_dirtyChannels;
+    QVector<QPointer<QCustomPlot>> m_dirtyPlots;
+    QVector<int> m_channelScratch;                 // 发出脏通道列表的复用缓冲
+
+    quint64 m_renderedFrames = 0;
+    std::array<float, kReplotHistory> m_replotMs{}; // 最近各帧的重绘耗时（环形）
+};
+
+#endif // RENDERSCHEDULER_H
@@ -0,0 +1,141 @@
+#include "stripchart.h"
+#include "channelplottable.h"
+#include "tracer.h"
+
+#include <cmath>
+
+constexpr int StripChart::kOverlapColumns;
+
+namespace {
+// 曲线图像所在的图层：网格之上、曲线和测量线（"main"）之下
+QString ensureStripLayer(QCustomPlot *plot)
+{
+    const QString name = QStringLiteral("strip");
+    if (!plot->layer(name)) {
+        plot->addLayer(name, plot->layer(QStringLiteral("main")), QCustomPlot::limBelow);
+    }
+    return name;
+}
+}
+
+StripChart::StripChart(QCustomPlot *plot)
+    : QCPLayerable(plot, ensureStripLayer(plot))
+{
+}
+
+void StripChart::setActive(bool active)
+{
+    if (m_active == active) {
+        return;
+    }
+    m_active = active;
+    m_valid = false;
+    if (!active) {
+        m_pixmap = QPixmap();
+    }
+}
+
+QRect StripChart::clipRect() const
+{
+    QCPAxisRect *rect = mParentPlot->axisRect();
+    return rect ? rect->rect() : QCPLayerable::clipRect();
+}
+
+void StripChart::applyDefaultAntialiasingHint(QCPPainter *painter) const
+{
+    applyAntialiasingHint(painter, mAntialiased, QCP::aePlottables);
+}
+
+/**
+ * @brief 参与绘制的曲线，以及决定能否增量绘制的状态
+ */
+void StripChart::collectCurves()
+{
+    m_curves.clear();
+    m_state.clear();
+    const QRect area = mParentPlot->axisRect()->rect();
+    m_state << area.left() << area.top() << area.width() << area.height()
+            << mParentPlot->bufferDevicePixelRatio();
+    for (int i = 0; i < mParentPlot->plottableCount(); ++i) {
+        ChannelPlottable *curve = qobject_cast<ChannelPlottable *>(mParentPlot->plottable(i));
+        if (!curve || !curve->stripMode() || !curve->realVisibility() || !curve->source()) {
+            continue;
+        }
+        m_curves.push_back(curve);
+        const QPen pen = curve->pen();
+        const QCPRange yr = curve->valueAxis()->range();
+        m_state << double(quintptr(curve)) << double(quintptr(curve->source().get()))
+                << double(pen.color().rgba()) << pen.widthF() << double(pen.style())
+                << (curve->selected() ? 1.0 : 0.0) << yr.lower << yr.upper;
+    }
+}
+
+/**
+ * @brief 平移图像并绘制新列，然后贴到绘图区
+ */
+void StripChart::draw(QCPPainter *painter)
+{
+    QCPAxisRect *rect = mParentPlot->axisRect();
+    if (!m_active || !rect) {
+        return;
+    }
+    const QRect area = rect->rect();
+    const QCPRange xr = rect->axis(QCPAxis::atBottom)->range();
+    const int w = area.width();
+    const int h = area.height();
+    if (w <= 0 || h <= 0 || xr.size() <= 0.0) {
+        return;
+    }
+    POWERDAQ_TRACE_SCOPE("stripChart");
+
+    const double bin = xr.size() / w;
+    const double dpr = mParentPlot->bufferDevicePixelRatio();
+    collectCurves();
+
+    // 能否增量绘制：状态未变、X 轴宽度不变，且视口向右平移了整数个像素（设备像素也为整数）
+    const double shift = m_valid ? (xr.lower - m_lower) / bin : 0.0;
+    const int dx = int(std::lround(shift));
+    const bool scroll = m_valid && m_state == m_lastState
+        && std::abs(bin - m_bin) <= 1e-9 * m_bin
+        && std::abs(shift - dx) < 1e-3 && dx >= 0 && dx < w - kOverlapColumns
+        && std::abs(dx * dpr - std::round(dx * dpr)) < 1e-6;
+
+    int first = 0;      // 需要重绘的第一列
+    if (scroll) {
+        const int dxDevice = int(std::lround(dx * dpr));
+        if (dxDevice > 0) {
+            m_pixmap.scroll(-dxDevice, 0, m_pixmap.rect());
+        }
+        first = w - dx - kOverlapColumns;
+    } else {
+        const QSize size(qRound(w * dpr), qRound(h * dpr));
+        if (m_pixmap.size() != size) {
+            m_pixmap = QPixmap(size);
+        }
+        m_pixmap.setDevicePixelRatio(dpr);
+    }
+
+    {
+        QCPPainter p(&m_pixmap);
+        p.setCompositionMode(QPainter::CompositionMode_Source);
+        p.fillRect(QRect(first, 0, w - first, h), Qt::transparent);
+        p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+        // 曲线按控件坐标绘制：平移到图像坐标，并只允许画在重绘的列内
+        p.translate(-area.left(), -area.top());
+        p.setClipRect(QRect(area.left() + first, area.top(), w - first, h));
+
+        // 向左多取一列，使与已有列之间的连线完整；列边界与整个视口的像素列对齐
+        const double lower = xr.lower + (first - 1) * bin;
+        for (ChannelPlottable *curve : m_curves) {
+            curve->drawSpan(&p, lower, xr.upper, w - first + 1);
+        }
+    }
+
+    m_lower = xr.lower;
+    m_bin = bin;
+    m_lastState.swap(m_state);
+    m_valid = true;
+
+    painter->drawPixmap(area.topLeft(), m_pixmap);
+}
@@ -0,0 +1,60 @@
+#ifndef STRIPCHART_H
+#define STRIPCHART_H
+
+#include "qcustomplot.h"
+#include <QPixmap>
+#include <QVector>
+
+class ChannelPlottable;
+
+/**
+ * @brief 条带图：自动跟随时曲线层的增量绘制（滚动 + 只绘制新到达的像素列）
+ *
+ * 绘图区的曲线保存在离屏 QPixmap 中。X 轴只按整像素平移时（自动跟随把视口对齐到像素网格），
+ * 每帧把图像左移 dx 个像素，只重新绘制最右侧的 dx 列（再多画 kOverlapColumns 列，
+ * 补全上一帧不完整的最后一列和相邻列之间的连线），然后整体贴到绘图区。
+ * 坐标轴、网格、测量线和触发标记仍由 QCustomPlot 在各自的图层上绘制，叠加在图像上下。
+ *
+ * 以下情况整体重绘一次：绘图区大小、X 轴宽度、Y 轴范围、曲线集合、颜色或选中状态变化，
+ * X 轴非整像素平移或向左移动，以及 invalidate() 之后。
+ * 只绘制处于条带图模式（ChannelPlottable::setStripMode）的曲线；位于 "main" 图层之下的 "strip" 图层。
+ */
+class StripChart : public QCPLayerable
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kOverlapColumns = 2;   // 每帧在新列之外重绘的列数
+
+    explicit StripChart(QCustomPlot *plot);
+
+    /**
+     * @brief 启用 / 停用（停用时不绘制、释放离屏图像）
+     */
+    void setActive(bool active);
+    bool isActive() const { return m_active; }
+
+    /**
+     * @brief 下一帧整体重绘（数据被清空或替换时调用）
+     */
+    void invalidate() { m_valid = false; }
+
+protected:
+    QRect clipRect() const override;
+    void applyDefaultAntialiasingHint(QCPPainter *painter) const override;
+    void draw(QCPPainter *painter) override;
+
+private:
+    void collectCurves();
+
+    bool m_active = false;
+    bool m_valid = false;           // m_pixmap 与 m_lower / m_bin / m_state 对应
+    QPixmap m_pixmap;               // 绘图区大小的曲线图像（透明背景）
+    double m_lower = 0.0;           // m_pixmap 第 0 列对应的时间
+    double m_bin = 0.0;             // 每个像素列的时间跨度
+    QVector<ChannelPlottable *> m_curves;   // 本帧参与绘制的曲线（复用缓冲）
+    QVector<double> m_state;        // 影响整幅图像的状态（绘图区、Y 轴、曲线画笔等），变化时整体重绘
+    QVector<double> m_lastState;
+};
+
+#endif // STRIPCHART_H
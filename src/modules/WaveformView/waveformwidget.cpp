@@ -1,18 +1,47 @@
 #include "waveformwidget.h"
 #include "ui_waveformwidget.h"
+#include "samplequeue.h"
+#include "tracer.h"
 #include <QSignalBlocker>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <QMouseEvent>
+
+namespace {
+// 单帧内每批从队列取出的最大块数
+constexpr std::size_t kDrainBatch = 256;
+}
+
 /**
  * @brief 构造函数：初始化波形显示组件
  * @param parent 父窗口指针
  */
 WaveformWidget::WaveformWidget(QWidget *parent) :
     QWidget(parent),
-    ui(new Ui::WaveformWidget)
+    ui(new Ui::WaveformWidget),
+    m_sampleQueue(new SampleQueue)
 {
     ui->setupUi(this);
+
+    // 界面默认保留超出热数据的样点（无损压缩，每通道约 64 MiB）
+    m_store.setColdStorage(ColdStoragePolicy::lossless(RetentionPolicy::bytes(64.0 * 1024 * 1024)));
+
+    // 渲染调度器：按显示帧统一消费采集队列、合并降采样与重绘，数据到达速率与重绘速率解耦
+    m_renderScheduler = new RenderScheduler(this);
+    connect(m_renderScheduler, &RenderScheduler::frameStarted,
+            this, &WaveformWidget::onFrameTick);
+    connect(m_renderScheduler, &RenderScheduler::channelsDirty,
+            this, &WaveformWidget::updateChannelGraphs);
+
+    // 视口降采样在线程池中进行，结果经队列连接回到 GUI 线程交换显示
+    m_downsampler = new ViewportDownsampler(this);
+    connect(m_downsampler, &ViewportDownsampler::resultsReady,
+            this, &WaveformWidget::onDownsampleReady, Qt::QueuedConnection);
+
     setupCharts();
+
+    m_renderScheduler->start();
 }
 
 /**
@@ -20,6 +49,10 @@ WaveformWidget::WaveformWidget(QWidget *parent) :
  */
 WaveformWidget::~WaveformWidget()
 {
+    m_renderScheduler->stop();
+    delete m_downsampler;   // 等待进行中的降采样任务结束
+    m_downsampler = nullptr;
+    delete m_sampleQueue;
     delete ui;
 }
 
@@ -29,7 +62,7 @@ WaveformWidget::~WaveformWidget()
  * 主要功能：
  * 1. 配置图例样式（位置、外观、交互）
  * 2. 配置图表交互权限（缩放、选中、框选）
- * 3. 创建曲线（电压、电流、功率）
+ * 3. 配置坐标轴（曲线按通道在第一次需要显示时创建）
  * 4. 连接信号与槽（双击改色、选中高亮、点击显示数值、框选统计）
  * 5. 设置 X 轴联动（上下两个图的时间轴同步）
  */
@@ -83,69 +116,16 @@ void WaveformWidget::setupCharts()
     configPlot(ui->plotVoltage);
     configPlot(ui->plotCurrent);
     // ==========================================
-    // 1. 配置上方的图表：电压（为每个通道创建graph）
+    // 1. 配置上方的图表：电压
+    // 2. 配置下方的图表：电流（左轴）& 功率（右轴）
     // ==========================================
-    // 清空旧 graph，重新为多通道创建
-    ui->plotVoltage->clearGraphs();
-
-    // 为每个通道创建一条电压曲线
-    for (int ch = 0; ch < kChannelCount; ++ch) {
-        ui->plotVoltage->addGraph();
-
-        // 配一组不同颜色
-        static const QColor voltageColors[] = {
-            Qt::blue, Qt::darkBlue, Qt::red, Qt::darkRed, Qt::green,
-            Qt::darkGreen, Qt::magenta, Qt::darkMagenta, Qt::cyan, Qt::darkCyan
-        };
-        static const int voltageColorsSize = sizeof(voltageColors) / sizeof(voltageColors[0]);
-        QColor c = voltageColors[ch % voltageColorsSize];
-        ui->plotVoltage->graph(ch)->setPen(QPen(c));
-
-        ui->plotVoltage->graph(ch)->setName(QStringLiteral("Voltage%1 (V)").arg(ch + 1));
-    }
-
+    // 各通道的曲线在第一次需要显示时创建（见 ensureCurve()）
+    ui->plotVoltage->clearPlottables();
     ui->plotVoltage->yAxis->setLabel("Voltage (V)");
 
-
-    // ==========================================
-    // 2. 配置下方的图表：电流 & 功率（为每个通道创建graph）
-    // ==========================================
-
-    ui->plotCurrent->clearGraphs();
-
-    // --- 左侧 Y 轴：电流（每个通道一条曲线） ---
-    for (int ch = 0; ch < kChannelCount; ++ch) {
-        ui->plotCurrent->addGraph(ui->plotCurrent->xAxis, ui->plotCurrent->yAxis);
-
-        static const QColor currentColors[] = {
-            Qt::red, Qt::darkRed, Qt::green, Qt::darkGreen, Qt::blue,
-            Qt::darkBlue, Qt::magenta, Qt::darkMagenta, Qt::cyan, Qt::darkCyan
-        };
-        static const int currentColorsSize = sizeof(currentColors) / sizeof(currentColors[0]);
-        QColor c = currentColors[ch % currentColorsSize];
-        ui->plotCurrent->graph(ch)->setPen(QPen(c));
-        ui->plotCurrent->graph(ch)->setName(QStringLiteral("Current%1 (A)").arg(ch + 1));
-    }
+    ui->plotCurrent->clearPlottables();
     ui->plotCurrent->yAxis->setLabel("Current (A)");
-
-    // --- 右侧 Y 轴 (yAxis2)：功率（每个通道一条曲线） ---
     ui->plotCurrent->yAxis2->setVisible(true);
-    for (int ch = 0; ch < kChannelCount; ++ch) {
-        ui->plotCurrent->addGraph(ui->plotCurrent->xAxis, ui->plotCurrent->yAxis2);
-        int graphIndex = kChannelCount + ch;
-
-        static const QColor powerColors[] = {
-            Qt::darkYellow, QColor(160, 120, 0), QColor(200, 80, 0),
-            QColor(120, 80, 40), QColor(180, 160, 0),
-            QColor(100, 100, 0), QColor(160, 160, 40),
-            QColor(200, 200, 0), QColor(150, 120, 60),
-            QColor(190, 140, 40)
-        };
-        static const int powerColorsSize = sizeof(powerColors) / sizeof(powerColors[0]);
-        QColor c = powerColors[ch % powerColorsSize];
-        ui->plotCurrent->graph(graphIndex)->setPen(QPen(c));
-        ui->plotCurrent->graph(graphIndex)->setName(QStringLiteral("Power%1 (W)").arg(ch + 1));
-    }
     ui->plotCurrent->yAxis2->setLabel("Power (W)");
 
     // 让上下两个图左右边距一致（包含下图右侧的 Power 轴），保证绘图区对齐
@@ -185,6 +165,9 @@ void WaveformWidget::setupCharts()
 
                 // 释放锁
                 m_syncingRange = false;
+
+                // 视口变化：所有通道在下一帧按新视口重新降采样
+                m_renderScheduler->markAllChannelsDirty();
             });
 
     connect(ui->plotCurrent->xAxis,
@@ -198,7 +181,12 @@ void WaveformWidget::setupCharts()
                 QSignalBlocker b(ui->plotVoltage->xAxis);
                 ui->plotVoltage->xAxis->setRange(range);
                 m_syncingRange = false;
+                m_renderScheduler->markAllChannelsDirty();
             });
+
+    // 条带图图层（自动跟随时增量绘制曲线，见 updateStripChart()）
+    m_stripV = new StripChart(ui->plotVoltage);
+    m_stripI = new StripChart(ui->plotCurrent);
 }
 
 /**
@@ -209,185 +197,538 @@ void WaveformWidget::setupCharts()
  * @param power 功率值（W）
  * 
  * 处理流程：
- * 1. 保存原始数据到内存（不做删除/降采样，保证数据完整性）
- * 2. 自动滚动视图（显示最新 10 秒的数据）
- * 3. 视觉降采样（减少绘制点数，提高性能，但不修改原始数据）
- * 4. 触发重绘（使用队列重绘，避免阻塞 UI 线程）
+ * 1. 保存原始数据到通道0（不做降采样；超出保留策略时丢弃最旧数据）
+ * 2. 自动滚动视图（与队列数据共用 refreshAfterIngest()，暂停显示或查看采集文件时只记录最新时间）
+ * 3. 视觉降采样与重绘由渲染调度器在下一帧合并执行（曲线绘制时直接读取通道数据）
  */
 void WaveformWidget::addData(double time, double voltage, double current, double power)
 {
-    // 1) 严格保存原始数据（后台记录），不做删除/降采样
-    m_time.push_back(time);
-    m_voltage.push_back(voltage);
-    m_current.push_back(current);
-    m_power.push_back(power);
-
-    // 2) 视图自动滚动（只改显示范围，不影响数据记录）
-    const double showRange = (m_viewWidth > 0.0 ? m_viewWidth : 10.0);
-    if (m_autoFollow) {
-        m_isAutoFollowing = true;  // 标记正在执行自动跟随
-        ui->plotVoltage->xAxis->setRange(time,showRange,Qt::AlignRight);
-        m_isAutoFollowing = false;  // 清除标记
+    // 1) 保存原始数据（后台记录，按保留策略环形覆盖），不做降采样
+    double maxTime = 0.0;
+    if (!appendSamples(0, &time, 0.0, 0.0, &voltage, &current, &power, 1, maxTime)) {
+        return;
     }
 
-    // 3) 视觉降采样绘制（只减少绘制点数，严禁修改原始数据）
-    applyVisualDownsample(ui->plotVoltage);
-    applyVisualDownsample(ui->plotCurrent);
-
-    // 4) 触发重绘（队列重绘，避免阻塞 UI）
-    ui->plotVoltage->replot(QCustomPlot::rpQueuedReplot);
-    ui->plotCurrent->replot(QCustomPlot::rpQueuedReplot);
+    // 2) 视图自动滚动（与队列数据相同的刷新路径：记录最新时间、跟随并对齐条带图的像素网格）
+    refreshAfterIngest(maxTime);
 }
 
 /**
- * @brief 添加多通道数据（线程安全，支持从工作线程调用）
+ * @brief 添加多通道数据（只能在 GUI 线程调用）
  * @param data 多通道数据包
  * 
- * 处理流程：
- * 1. 遍历数据包中的所有通道
- * 2. 为每个通道保存数据到独立的数据池
- * 3. 自动计算功率（如果未提供）
- * 4. 更新视图和重绘
+ * 逐点接口：每个通道的数据点按长度为 1 的块写入（与块接口共用写入路径），
+ * 然后更新视图和重绘。会驱动触发引擎、渲染调度器和 X 轴，因此不能从工作线程直接调用；
+ * 其他线程请使用 sampleQueue()（高速率数据也请使用 addChannelBlock() 或 sampleQueue()）。
  */
 void WaveformWidget::addChannelData(const MultiChannelData &data)
 {
     if (data.channelData.isEmpty()) {
         return;
     }
+    POWERDAQ_TRACE_SCOPE("addChannelData");
     
     double maxTime = 0.0;  // 记录最大时间，用于视图跟随
-    
-    // 遍历所有通道数据
     for (auto it = data.channelData.constBegin(); it != data.channelData.constEnd(); ++it) {
-        int channelId = it.key();
-        
-        // 验证通道ID有效性
-        if (channelId < 0 || channelId >= kChannelCount) {
-            continue;
-        }
-        
         const ChannelDataPoint &point = it.value();
-        
-        // 计算功率（如果未提供或为NaN）
-        double power = point.power;
-        if (std::isnan(power) || std::isinf(power) || power == 0.0) {
-            power = point.voltage * point.current;
-        }
-        
-        // 获取或创建通道数据存储
-        ChannelData &channelData = m_channelDataMap[channelId];
-        
-        // 添加数据点
-        channelData.time.push_back(point.time);
-        channelData.voltage.push_back(point.voltage);
-        channelData.current.push_back(point.current);
-        channelData.power.push_back(power);
-        
-        // 更新最大时间
-        if (point.time > maxTime) {
-            maxTime = point.time;
-        }
-        
-        // 如果是通道0，同时更新单通道数据（
-        if (channelId == 0) {
-            m_time.push_back(point.time);
-            m_voltage.push_back(point.voltage);
-            m_current.push_back(point.current);
-            m_power.push_back(power);
-        }
+        appendSamples(it.key(), &point.time, 0.0, 0.0,
+                      &point.voltage, &point.current, &point.power, 1, maxTime);
     }
     
-    // 视图自动滚动
+    refreshAfterIngest(maxTime);
+}
+
+/**
+ * @brief 批量添加单通道数据（逐点时间戳）
+ */
+void WaveformWidget::addChannelBlock(int channelId, const double *time, const double *voltage,
+                                     const double *current, const double *power, int count)
+{
+    if (!time) {
+        return;
+    }
+    double maxTime = 0.0;
+    if (appendSamples(channelId, time, 0.0, 0.0, voltage, current, power, count, maxTime)) {
+        refreshAfterIngest(maxTime);
+    }
+}
+
+/**
+ * @brief 批量添加单通道数据（均匀采样）
+ */
+void WaveformWidget::addChannelBlock(int channelId, double t0, double dt, const double *voltage,
+                                     const double *current, const double *power, int count)
+{
+    if (dt <= 0.0) {
+        return;
+    }
+    double maxTime = 0.0;
+    if (appendSamples(channelId, nullptr, t0, dt, voltage, current, power, count, maxTime)) {
+        refreshAfterIngest(maxTime);
+    }
+}
+
+/**
+ * @brief 批量添加一个采样块
+ */
+void WaveformWidget::addChannelBlock(const SampleBlock &block)
+{
+    POWERDAQ_TRACE_SCOPE("addChannelBlock");
+    double maxTime = 0.0;
+    if (ingestBlock(block, maxTime)) {
+        refreshAfterIngest(maxTime);
+    }
+}
+
+/**
+ * @brief 将单个采样块写入数据池（只写数据，不做降采样和重绘）
+ * @param block 采样块
+ * @param maxTime [in/out] 记录写入数据中的最大时间，用于视图跟随
+ * @return 是否写入了数据
+ */
+bool WaveformWidget::ingestBlock(const SampleBlock &block, double &maxTime)
+{
+    const std::size_t n = block.size();
+    if (n == 0 || block.current.size() != n) {
+        return false;
+    }
+    if (!block.isUniform() && block.time.size() != n) {
+        return false;
+    }
+    const double *power = (block.power.size() == n) ? block.power.data() : nullptr;
+    return appendSamples(block.channelId,
+                         block.isUniform() ? nullptr : block.time.data(),
+                         block.t0, block.dt,
+                         block.voltage.data(), block.current.data(), power,
+                         int(n), maxTime);
+}
+
+/**
+ * @brief 块写入核心：每列一次整段拷贝（环形缓冲，预热后不再扩容）
+ * @param channelId 通道ID
+ * @param time 逐点时间戳；为 nullptr 时使用 t0 + k*dt
+ * @param power 功率数组，可为 nullptr（自动计算）
+ * @param maxTime [in/out] 写入数据中的最大时间
+ * @return 是否写入了数据
+ */
+bool WaveformWidget::appendSamples(int channelId, const double *time, double t0, double dt,
+                                   const double *voltage, const double *current,
+                                   const double *power, int count, double &maxTime)
+{
+    // 验证参数与通道ID有效性
+    if (count <= 0 || !voltage || !current || (!time && dt <= 0.0)) {
+        return false;
+    }
+    if (!channelEntry(channelId)) {
+        return false;
+    }
+    const bool created = !m_store.slot(channelId);
+
+    // 写入数据池；触发引擎在每段写入后读取刚写入的样点（数据池保证每个样点被覆盖前都经过检测）
+    std::size_t captured = 0;
+    const ChannelSlotPtr slot = m_store.append(
+        channelId, time, t0, dt, voltage, current, power, std::size_t(count),
+        [this, channelId, &captured](const ChannelBuffer &data, std::size_t n) {
+            captured += m_trigger.process(channelId, data, n);
+        });
+    if (!slot) {
+        return false;
+    }
+    // 新通道的三条曲线直接从数据池绘制（正在查看该通道的采集段或采集文件时除外）
+    if (created && channelId != m_reviewChannel && !m_captureFile) {
+        bindChannelCurves(channelId, slot);
+    }
+    m_ingestedSamples += quint64(count);
+    maxTime = std::max(maxTime, slot->data.time().last());
+    if (!m_displayPaused && !m_captureFile) {
+        m_renderScheduler->markChannelDirty(channelId);
+    }
+
+    if (captured > 0) {
+        const int last = m_trigger.captureCount() - 1;
+        for (int k = int(captured) - 1; k >= 0; --k) {
+            emit triggerCaptured(last - k);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 数据写入后的统一刷新：自动跟随（暂停显示时只记录最新时间）
+ * 写入的通道已在 appendSamples() 中标记为脏，降采样与重绘由渲染调度器在下一帧合并执行。
+ */
+void WaveformWidget::refreshAfterIngest(double maxTime)
+{
+    m_latestTime = std::max(m_latestTime, maxTime);
+    if (!m_displayPaused && !m_captureFile) {
+        followLatest(maxTime);
+    }
+}
+
+/**
+ * @brief 自动跟随：将 X 轴右边界对齐到最新数据时间
+ * @param maxTime 最新数据时间
+ */
+void WaveformWidget::followLatest(double maxTime)
+{
     if (m_autoFollow && maxTime > 0) {
         m_isAutoFollowing = true;  // 标记正在执行自动跟随
         const double showRange = (m_viewWidth > 0.0 ? m_viewWidth : 10.0);
-        ui->plotVoltage->xAxis->setRange(maxTime, showRange, Qt::AlignRight);
+        const int width = ui->plotVoltage->axisRect()->width();
+        if (m_stripActive && width > 0) {
+            // 条带图：右边界取到像素列边界上，帧间视口只平移整数个像素列
+            const double bin = showRange / width;
+            const double upper = std::ceil(maxTime / bin) * bin;
+            ui->plotVoltage->xAxis->setRange(upper - showRange, upper);
+        } else {
+            ui->plotVoltage->xAxis->setRange(maxTime, showRange, Qt::AlignRight);
+        }
         m_isAutoFollowing = false;  // 清除标记
     }
-    
-    // 更新图表显示（多通道数据）
-    updateChannelGraphs();
-    
-    // 触发重绘
-    ui->plotVoltage->replot(QCustomPlot::rpQueuedReplot);
-    ui->plotCurrent->replot(QCustomPlot::rpQueuedReplot);
+}
+
+/**
+ * @brief 启用 / 禁用条带图模式
+ */
+void WaveformWidget::setStripChartEnabled(bool enabled)
+{
+    m_stripChartEnabled = enabled;
+    updateStripChart();
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
+}
+
+/**
+ * @brief 按当前状态启用 / 停用条带图
+ *
+ * 条带图生效时各曲线不再自行绘制，也不再提交异步降采样；
+ * 停用时所有通道按当前视口重新降采样，恢复整体绘制。
+ */
+void WaveformWidget::updateStripChart()
+{
+    const bool active = m_stripChartEnabled && m_autoFollow && !m_displayPaused
+        && !m_captureFile && m_reviewSequence == 0;
+    if (active == m_stripActive) {
+        return;
+    }
+    m_stripActive = active;
+    m_stripV->setActive(active);
+    m_stripI->setActive(active);
+    for (const ChannelEntry &entry : m_channels) {
+        for (ChannelPlottable *curve : entry.curves) {
+            if (curve) {
+                curve->setStripMode(active);
+            }
+        }
+    }
+    if (!active) {
+        m_renderScheduler->markAllChannelsDirty();
+    }
+}
+
+void WaveformWidget::invalidateStripChart()
+{
+    m_stripV->invalidate();
+    m_stripI->invalidate();
+}
+
+/**
+ * @brief 显示帧回调：消费采集队列
+ *
+ * 每帧只取出帧开始时已到达的数据块（以 sizeApprox 为上限，防止生产者过快导致
+ * 本帧无法结束），全部写入数据池；降采样和重绘由渲染调度器在本帧随后合并执行。
+ */
+void WaveformWidget::onFrameTick()
+{
+    if (m_perfHud && m_perfHud->isVisible() && m_perfHud->refreshDue()) {
+        updatePerfHud();
+    }
+
+    std::size_t budget = m_sampleQueue->sizeApprox();
+    if (budget == 0) {
+        return;
+    }
+    POWERDAQ_TRACE_SCOPE("ingest");
+
+    double maxTime = 0.0;
+    bool ingested = false;
+    while (budget > 0) {
+        m_drainBuffer.clear();
+        const std::size_t n = m_sampleQueue->drain(m_drainBuffer, std::min(budget, kDrainBatch));
+        if (n == 0) {
+            break;
+        }
+        for (const SampleBlock &block : m_drainBuffer) {
+            ingested |= ingestBlock(block, maxTime);
+        }
+        budget -= std::min(budget, n);
+    }
+    m_drainBuffer.clear();
+
+    if (ingested) {
+        refreshAfterIngest(maxTime);
+    }
+}
+
+/**
+ * @brief 显示 / 隐藏性能统计浮层
+ */
+void WaveformWidget::setPerfHudVisible(bool visible)
+{
+    if (!m_perfHud) {
+        if (!visible) {
+            return;
+        }
+        m_perfHud = new PerfHud(ui->plotVoltage);
+    }
+    if (visible) {
+        m_perfHud->restart();
+        updatePerfHud();
+        m_perfHud->raise();
+    }
+    m_perfHud->setVisible(visible);
+}
+
+bool WaveformWidget::isPerfHudVisible() const
+{
+    return m_perfHud && m_perfHud->isVisible();
+}
+
+/**
+ * @brief 采样性能计数器（由显示帧按 PerfHud::kRefreshMs 间隔调用）
+ */
+void WaveformWidget::updatePerfHud()
+{
+    PerfHud::Counters c;
+    c.renderedFrames = m_renderScheduler->renderedFrames();
+    m_renderScheduler->replotPercentiles(c.replotP50Ms, c.replotP99Ms);
+    for (const ChannelEntry &entry : m_channels) {
+        for (const ChannelPlottable *curve : entry.curves) {
+            if (curve && curve->visible()) {
+                c.drawnPoints += curve->drawnPoints();
+            }
+        }
+    }
+    c.ingestedSamples = m_ingestedSamples;
+    c.queuedBlocks = m_sampleQueue->sizeApprox();
+    c.droppedBlocks = m_sampleQueue->droppedBlocks();
+    c.downsamplePasses = m_downsampler->completedPasses();
+    c.downsampleNs = m_downsampler->busyNs();
+    c.storeBytes = m_store.memoryBytes();
+    for (int id = 0; id < m_store.channelCount(); ++id) {
+        if (m_store.slot(id)) {
+            ++c.channels;
+        }
+    }
+    m_perfHud->present(c);
+
+    // 贴在电压图绘图区的左上角
+    const QRect area = ui->plotVoltage->axisRect()->rect();
+    m_perfHud->move(area.left() + 6, area.top() + 6);
+}
+
+/**
+ * @brief 暂停 / 恢复显示刷新（数据照常写入）
+ */
+void WaveformWidget::setDisplayPaused(bool paused)
+{
+    if (m_displayPaused == paused) {
+        return;
+    }
+    m_displayPaused = paused;
+    updateStripChart();
+    if (!paused) {
+        // 暂停期间写入的通道没有标记为脏，这里统一刷新一次
+        followLatest(m_latestTime);
+        m_renderScheduler->markAllChannelsDirty();
+    }
+}
+
+/**
+ * @brief 取完队列中剩余的全部数据块
+ */
+void WaveformWidget::flushSampleQueue()
+{
+    double maxTime = 0.0;
+    bool ingested = false;
+    for (;;) {
+        m_drainBuffer.clear();
+        if (m_sampleQueue->drain(m_drainBuffer, kDrainBatch) == 0) {
+            break;
+        }
+        for (const SampleBlock &block : m_drainBuffer) {
+            ingested |= ingestBlock(block, maxTime);
+        }
+    }
+    m_drainBuffer.clear();
+
+    if (ingested) {
+        refreshAfterIngest(maxTime);
+    }
+}
+
+/**
+ * @brief 设置原始数据保留策略
+ * @param policy 保留策略（样点数 / 时长 / 内存）
+ *
+ * 立即作用于已有通道（缩小时丢弃最旧数据），新建通道沿用该策略。
+ */
+void WaveformWidget::setRetention(const RetentionPolicy &policy)
+{
+    m_store.setRetention(policy);
+    invalidateStripChart();
+    m_renderScheduler->markAllChannelsDirty();
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
+}
+
+/**
+ * @brief 设置冷数据策略
+ * @param policy 冷数据策略（关闭 / 无损 / 按步长量化，及冷数据保留量）
+ *
+ * 立即作用于已有通道（关闭时丢弃已有冷数据），新建通道沿用该策略。
+ */
+void WaveformWidget::setColdStorage(const ColdStoragePolicy &policy)
+{
+    m_store.setColdStorage(policy);
+    invalidateStripChart();
+    m_renderScheduler->markAllChannelsDirty();
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
 }
 
 /**
  * @brief 清空所有数据（原始数据 + 图表显示）
  * 
  * 功能：
- * 1. 清空内存中的原始数据（m_time, m_voltage, m_current, m_power）
- * 2. 清空图表中的绘制数据
- * 3. 立即刷新图表显示空白状态
+ * 1. 清空内存中的原始数据（各通道数据）
+ * 2. 丢弃各曲线已算出的降采样结果
+ * 3. 下一帧刷新图表显示空白状态
  */
 void WaveformWidget::clear()
 {
+    // 退出采集段查看，丢弃采集段（数据时间轴从头开始）
+    showLive();
+    m_trigger.reset();
+    m_trigger.clearCaptures();
+
     // 清空原始数据
-    m_time.clear();
-    m_voltage.clear();
-    m_current.clear();
-    m_power.clear();
+    m_latestTime = 0.0;
+    m_store.clear();
+    invalidateStripChart();
+    m_downsampler->cancelAll();
 
     // 清空图表绘制数据
-    ui->plotVoltage->graph(0)->data()->clear();
-    ui->plotCurrent->graph(0)->data()->clear();
-    ui->plotCurrent->graph(1)->data()->clear();
+    for (const ChannelEntry &entry : m_channels) {
+        for (ChannelPlottable *curve : entry.curves) {
+            if (curve) {
+                curve->clearColumns();
+            }
+        }
+    }
+
+    // 刷新图表以显示空白状态（下一帧重绘）
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
+}
+
+const ChannelIntegrator *WaveformWidget::channelIntegrator(int channelId) const
+{
+    const ChannelSlotPtr slot = channelSlot(channelId);
+    return slot ? &slot->data.integrator() : nullptr;
+}
 
-    // 立即刷新图表以显示空白状态（同步重绘，确保立即生效）
-    ui->plotVoltage->replot();
-    ui->plotCurrent->replot();
+/**
+ * @brief 通道的实时数据（数据池中的数据槽）
+ * @return 通道尚无数据时返回空指针
+ */
+ChannelSlotPtr WaveformWidget::channelSlot(int channelId) const
+{
+    return m_store.slot(channelId);
+}
+
+/**
+ * @brief 通道表中的一项
+ *
+ * 通道表按用到的最大通道ID增长（每项只有几个指针，数据和曲线都按需创建）。
+ * 注意：扩展通道表会使之前取得的 ChannelEntry 指针失效。
+ * @return 通道ID超出 [0, maxChannels()) 时返回 nullptr
+ */
+WaveformWidget::ChannelEntry *WaveformWidget::channelEntry(int channelId)
+{
+    if (channelId < 0 || channelId >= m_store.maxChannels()) {
+        return nullptr;
+    }
+    if (channelId >= int(m_channels.size())) {
+        m_channels.resize(std::size_t(channelId) + 1);
+    }
+    return &m_channels[std::size_t(channelId)];
+}
+
+/**
+ * @brief 设置通道ID上限
+ * @param count 通道数（至少 1）
+ *
+ * 缩小时丢弃超出上限的通道（数据、显示状态和曲线）。
+ */
+void WaveformWidget::setMaxChannels(int count)
+{
+    count = std::max(1, count);
+    if (count < int(m_channels.size())) {
+        m_downsampler->cancelAll();
+        for (std::size_t id = std::size_t(count); id < m_channels.size(); ++id) {
+            for (ChannelPlottable *curve : m_channels[id].curves) {
+                if (curve) {
+                    curve->parentPlot()->removePlottable(curve);
+                }
+            }
+        }
+        m_channels.resize(std::size_t(count));
+        if (m_reviewChannel >= count) {
+            showLive();
+        }
+        m_renderScheduler->markPlotDirty(ui->plotVoltage);
+        m_renderScheduler->markPlotDirty(ui->plotCurrent);
+    }
+    m_store.setMaxChannels(count);
 }
 
 /**
  * @brief 清空指定通道的数据
- * @param channelId 通道ID（0 到 kChannelCount-1）
+ * @param channelId 通道ID（0 到 maxChannels()-1）
  */
 void WaveformWidget::clearChannel(int channelId)
 {
-    if (channelId < 0 || channelId >= kChannelCount) {
+    if (channelId < 0 || channelId >= m_store.maxChannels()) {
         return;
     }
     
     // 清空通道数据
-    if (m_channelDataMap.contains(channelId)) {
-        m_channelDataMap[channelId].time.clear();
-        m_channelDataMap[channelId].voltage.clear();
-        m_channelDataMap[channelId].current.clear();
-        m_channelDataMap[channelId].power.clear();
-    }
-    
-    // 如果是通道0，同时清空单通道数据（向后兼容）
-    if (channelId == 0) {
-        m_time.clear();
-        m_voltage.clear();
-        m_current.clear();
-        m_power.clear();
+    m_store.clearChannel(channelId);
+    invalidateStripChart();
+    // 丢弃尚未显示的降采样结果，避免清空后旧波形又被交换回来
+    m_downsampler->cancelAll();
+
+    // 触发通道的时间轴从头开始：丢弃预触发历史和进行中的采集
+    if (channelId == m_trigger.settings().channelId) {
+        m_trigger.reset();
     }
     
-    // 清空对应的graph数据
-    if (ui->plotVoltage && channelId < ui->plotVoltage->graphCount()) {
-        ui->plotVoltage->graph(channelId)->data()->clear();
-    }
-    
-    if (ui->plotCurrent) {
-        // 清空电流graph
-        if (channelId < ui->plotCurrent->graphCount()) {
-            ui->plotCurrent->graph(channelId)->data()->clear();
-        }
-        // 清空功率graph
-        int powerGraphIndex = kChannelCount + channelId;
-        if (powerGraphIndex < ui->plotCurrent->graphCount()) {
-            ui->plotCurrent->graph(powerGraphIndex)->data()->clear();
+    // 清空对应曲线（电压 / 电流 / 功率）的降采样结果
+    if (channelId < int(m_channels.size())) {
+        for (ChannelPlottable *curve : m_channels[std::size_t(channelId)].curves) {
+            if (curve) {
+                curve->clearColumns();
+            }
         }
     }
     
-    // 触发重绘
+    // 标记重绘
     if (ui->plotVoltage) {
-        ui->plotVoltage->replot(QCustomPlot::rpQueuedReplot);
+        m_renderScheduler->markPlotDirty(ui->plotVoltage);
     }
     if (ui->plotCurrent) {
-        ui->plotCurrent->replot(QCustomPlot::rpQueuedReplot);
+        m_renderScheduler->markPlotDirty(ui->plotCurrent);
     }
 }
 
@@ -407,8 +748,8 @@ void WaveformWidget::setMeasureToolMode(MeasureToolMode mode)
     // 关闭模式：清除所有测量工具
     if (m_measureMode == MeasureToolMode::Off) {
         clearMeasureItems();
-        if (ui->plotVoltage) ui->plotVoltage->replot(QCustomPlot::rpQueuedReplot);
-        if (ui->plotCurrent) ui->plotCurrent->replot(QCustomPlot::rpQueuedReplot);
+        if (ui->plotVoltage) m_renderScheduler->markPlotDirty(ui->plotVoltage);
+        if (ui->plotCurrent) m_renderScheduler->markPlotDirty(ui->plotCurrent);
         return;
     }
 
@@ -432,8 +773,8 @@ void WaveformWidget::setMeasureToolMode(MeasureToolMode mode)
 
     // 更新显示文本并重绘
     updateCalipersText();
-    if (ui->plotVoltage) ui->plotVoltage->replot(QCustomPlot::rpQueuedReplot);
-    if (ui->plotCurrent) ui->plotCurrent->replot(QCustomPlot::rpQueuedReplot);
+    if (ui->plotVoltage) m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    if (ui->plotCurrent) m_renderScheduler->markPlotDirty(ui->plotCurrent);
 }
 
 /**
@@ -457,17 +798,15 @@ void WaveformWidget::setVoltageVisible(bool visible)
     // 记录当前电压曲线是否应该被显示
     m_voltageVisible = visible;
 
-    // 2. 检查对象有效性
-    if (ui->plotVoltage && ui->plotVoltage->graphCount() > 0) {
-
-        // 3. 设置图形可见性隐藏
-        ui->plotVoltage->graph(0)->setVisible(visible);
-
-        // 4. 触发重绘
-        // 由于曲线的显示状态发生了变化，必须重新绘制图表
-        // 使用 rpQueuedReplot（异步重绘）以保证界面响应的丝滑度
-        ui->plotVoltage->replot(QCustomPlot::rpQueuedReplot);
+    // 2. 更新所有通道已有曲线的可见性（未创建的曲线在第一次需要显示时按同样规则创建）
+    for (int channelId = 0; channelId < int(m_channels.size()); ++channelId) {
+        applyCurveVisibility(channelId);
     }
+
+    // 3. 触发重绘
+    // 重新显示的曲线需要按当前视口重新降采样；只标记为脏，由渲染调度器在下一帧统一处理
+    m_renderScheduler->markAllChannelsDirty();
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
 }
 
 
@@ -475,28 +814,27 @@ void WaveformWidget::setVoltageVisible(bool visible)
 void WaveformWidget::setCurrentVisible(bool visible)
 {
     m_currentVisible = visible;
-    if (ui->plotCurrent && ui->plotCurrent->graphCount() > 0) {
-        ui->plotCurrent->graph(0)->setVisible(visible);
-        ui->plotCurrent->replot(QCustomPlot::rpQueuedReplot);
+    for (int channelId = 0; channelId < int(m_channels.size()); ++channelId) {
+        applyCurveVisibility(channelId);
     }
+    m_renderScheduler->markAllChannelsDirty();
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
 }
 
 //显示功率
 void WaveformWidget::setPowerVisible(bool visible)
 {
     m_powerVisible = visible;
-    if (ui->plotCurrent && ui->plotCurrent->graphCount() > kChannelCount) {
-        // 索引 [kChannelCount, ...) 为功率曲线
-        for (int i = kChannelCount; i < ui->plotCurrent->graphCount(); ++i) {
-            ui->plotCurrent->graph(i)->setVisible(visible);
-        }
-        ui->plotCurrent->replot(QCustomPlot::rpQueuedReplot);
+    for (int channelId = 0; channelId < int(m_channels.size()); ++channelId) {
+        applyCurveVisibility(channelId);
     }
+    m_renderScheduler->markAllChannelsDirty();
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
 }
 
 /**
  * @brief 设置指定通道的显示状态
- * @param channelId 通道ID（0 到 kChannelCount-1）
+ * @param channelId 通道ID（0 到 maxChannels()-1）
  * @param voltageVisible 电压曲线是否显示
  * @param currentVisible 电流曲线是否显示
  * @param powerVisible 功率曲线是否显示
@@ -504,38 +842,30 @@ void WaveformWidget::setPowerVisible(bool visible)
 void WaveformWidget::setChannelVisible(int channelId, bool voltageVisible, 
                                         bool currentVisible, bool powerVisible)
 {
-    if (channelId < 0 || channelId >= kChannelCount) {
+    ChannelEntry *entry = channelEntry(channelId);
+    if (!entry) {
         return;
     }
     
     // 更新通道显示状态
-    ChannelVisibility &vis = m_channelVisibility[channelId];
+    ChannelVisibility &vis = entry->visibility;
     vis.voltageVisible = voltageVisible;
     vis.currentVisible = currentVisible;
     vis.powerVisible = powerVisible;
     
-    // 更新电压graph显示状态（需要同时满足全局和通道设置）
-    if (ui->plotVoltage && channelId < ui->plotVoltage->graphCount()) {
-        ui->plotVoltage->graph(channelId)->setVisible(voltageVisible && m_voltageVisible);
-    }
-    
-    // 更新电流graph显示状态
-    if (ui->plotCurrent && channelId < ui->plotCurrent->graphCount()) {
-        ui->plotCurrent->graph(channelId)->setVisible(currentVisible && m_currentVisible);
-    }
+    // 更新已有曲线的显示状态（需要同时满足全局和通道设置）；
+    // 尚未创建的曲线在通道有数据且需要显示时创建
+    applyCurveVisibility(channelId);
     
-    // 更新功率graph显示状态
-    int powerGraphIndex = kChannelCount + channelId;
-    if (ui->plotCurrent && powerGraphIndex < ui->plotCurrent->graphCount()) {
-        ui->plotCurrent->graph(powerGraphIndex)->setVisible(powerVisible && m_powerVisible);
-    }
-    
-    // 触发重绘
+    // 重新显示的曲线需要按当前视口重新降采样
+    m_renderScheduler->markChannelDirty(channelId);
+
+    // 标记重绘
     if (ui->plotVoltage) {
-        ui->plotVoltage->replot(QCustomPlot::rpQueuedReplot);
+        m_renderScheduler->markPlotDirty(ui->plotVoltage);
     }
     if (ui->plotCurrent) {
-        ui->plotCurrent->replot(QCustomPlot::rpQueuedReplot);
+        m_renderScheduler->markPlotDirty(ui->plotCurrent);
     }
 }
 
@@ -655,6 +985,12 @@ void WaveformWidget::clearMeasureItems()
     // 重置测量结果文本框指针
     m_caliperText_V = nullptr;
     m_caliperText_I = nullptr;
+
+    // 触发时刻标记同样被销毁：正在查看采集段时重新标出
+    m_triggerMarkerV = m_triggerMarkerI = nullptr;
+    if (const TriggerCapturePtr capture = m_trigger.capture(shownTriggerCapture())) {
+        setTriggerMarker(true, capture->triggerTime);
+    }
 }
 
 void WaveformWidget::updateCrosshair(QCustomPlot *plot, const QPoint &pos)
@@ -865,8 +1201,8 @@ bool WaveformWidget::handleMeasureMouseMove(QCustomPlot *plot, QMouseEvent *e)
     // 这种模式下，光标只是跟随鼠标移动显示当前坐标，不涉及“拖拽”
     if (m_measureMode == MeasureToolMode::Crosshair) {
         updateCrosshair(plot, e->pos()); // 更新十字线的位置信息
-        // 使用 rpQueuedReplot 异步刷新，避免高频刷新导致界面卡顿
-        plot->replot(QCustomPlot::rpQueuedReplot);
+        // 只标记为脏，鼠标移动再快每帧也只重绘一次
+        m_renderScheduler->markPlotDirty(plot);
         return false; // 返回 false，让图表原有的交互（如坐标值显示）也能工作
     }
 
@@ -895,8 +1231,8 @@ bool WaveformWidget::handleMeasureMouseMove(QCustomPlot *plot, QMouseEvent *e)
 
     // 7. 同步刷新所有图表
     // 即使你只动了电压图的线，时间卡尺（X）通常是两个图表同步的，所以都要重绘
-    ui->plotVoltage->replot(QCustomPlot::rpQueuedReplot);
-    ui->plotCurrent->replot(QCustomPlot::rpQueuedReplot);
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
 
     // 返回 true，表示当前正在拖拽卡尺，拦截图表的默认行为（如框选放大）
     return true;
@@ -926,126 +1262,97 @@ bool WaveformWidget::handleMeasureMouseRelease(QCustomPlot *plot, QMouseEvent *e
 
 
 /**
- * @brief 视觉降采样：根据可视范围和像素宽度，智能减少绘制点数
- * @param plot 目标图表（plotVoltage 或 plotCurrent）
- * 
- * 算法原理：
- * 1. 将可视时间范围按像素宽度分成多个 bin（每个 bin 对应一列像素）
- * 2. 对每个 bin 内的数据点，提取最小值点和最大值点（Min-Max 抽样）
- * 3. 这样既能保证波形形状不丢失，又能大幅减少绘制点数（从数千点降到数百点）
+ * @brief 取通道的一条曲线
+ * @return 通道ID无效或曲线尚未创建时返回 nullptr
  */
-void WaveformWidget::applyVisualDownsample(QCustomPlot *plot)
+ChannelPlottable *WaveformWidget::curveFor(int channelId, ViewportDownsampler::Column column) const
 {
-    if (!plot) return;
-    // 没数据就不处理
-    if (m_time.isEmpty()) return;
-
-    // 1. 计算可视范围和像素宽度
-    const QCPRange xr = plot->xAxis->range();  // 当前 X 轴（时间）范围
-    const int w = std::max(50, plot->axisRect()->rect().width());  // 绘图区域宽度（像素）
-    const double bin = xr.size() / w;  // 每个像素对应的时间跨度
-    if (bin <= 0) return;
-
-    // 2. 使用二分查找定位可视范围内的数据点索引范围
-    auto findStartIdx = [&](double t) {
-        auto it = std::lower_bound(m_time.begin(), m_time.end(), t);
-        return int(it - m_time.begin());
-    };
-    int i0 = std::max(0, findStartIdx(xr.lower));  // 可视范围起始索引
-    // 使用 upper_bound 确保包含等于 xr.upper 的边界点
-    auto itEnd = std::upper_bound(m_time.begin() + i0, m_time.end(), xr.upper);
-    int i1 = std::min(int(m_time.size()), int(itEnd - m_time.begin()));  // 可视范围结束索引
-    
-    // 3. 如果数据点很少（≤2个），直接全量显示，不做降采样
-    if (i1 - i0 <= 2) {
-        if (plot == ui->plotVoltage) {
-            plot->graph(0)->setData(m_time, m_voltage, true);
-        } else {
-            plot->graph(0)->setData(m_time, m_current, true);
-            plot->graph(1)->setData(m_time, m_power, true);
-        }
-        return;
+    if (channelId < 0 || channelId >= int(m_channels.size())) {
+        return nullptr;
     }
+    return m_channels[std::size_t(channelId)].curves[int(column)];
+}
 
-    // 4. Min-Max 降采样算法：对每个像素列，提取该列内的最小值和最大值
-    // y: 原始电压/电流数组 (y)
-    // outX, outY: 存储降采样后用于绘图的数据点 (x, y)
-    auto downsampleSeries = [&](const QVector<double> &y, QVector<double> &outX, QVector<double> &outY) {
-        // 1. 清空旧数据并预分配内存
-        outX.clear(); outY.clear();
-
-        //存储大小由屏幕实际的分辨率显示
-        outX.reserve(w * 2); // w 是屏幕宽度(像素)，每列提 2 个点，所以预留 w*2
-        outY.reserve(w * 2);
-
-        double tBinStart = xr.lower; // 当前像素“桶”的时间起始位置
-        int idx = i0;                // 从可视范围的起始索引 i0 开始处理
-
-        // 2. 外层循环：遍历屏幕上的每一个像素列 (px)
-        // 注意：即使 idx >= i1，也要处理完所有像素列，确保边界数据不丢失
-        for (int px = 0; px < w; ++px) {
-            // 计算当前像素列对应的结束时间
-            // 如果是最后一列，强制等于视图最右边缘；否则按 bin (像素时间跨度) 递增
-            const double tBinEnd = (px == w - 1) ? xr.upper : (tBinStart + bin);
-
-            bool has = false;             // 标记当前像素范围内是否有数据点
-            double minV = 0, maxV = 0;    // 当前像素内的最小值和最大值 (电压)
-            double minT = 0, maxT = 0;    // 最小值和最大值对应的时间戳 (时间)
-
-            // 3. 内层循环：找出落在当前像素列时间段 [tBinStart, tBinEnd] 内的所有原始数据点
-            // 注意：最后一列使用 <= 包含边界点，其他列使用 < 避免重复
-            bool isLastBin = (px == w - 1);
-            while (idx < i1) {
-                const double t = m_time[idx];
-                // 对于最后一列，包含等于边界的点；对于其他列，不包含右边界（避免重复）
-                if (isLastBin ? (t > tBinEnd) : (t >= tBinEnd)) {
-                    break;
-                }
-                
-                const double v = y[idx];      // 当前点的数值
-
-                if (!has) {
-                    // 如果是该像素段内的第一个点，直接初始化为最大/最小值
-                    has = true;
-                    minV = maxV = v;
-                    minT = maxT = t;
-                } else {
-                    // 更新最大值和最小值
-                    if (v < minV) { minV = v; minT = t; }
-                    if (v > maxV) { maxV = v; maxT = t; }
-                }
-                ++idx; // 继续看原始数组里的下一个点
-            }
-
-            // 4. 将提取出的两个点存入输出数组
-            if (has) {
-                // 排序逻辑：为了让连线顺滑，比较 minT 和 maxT 的先后顺序
-                // 确保在同一个像素列内，先画时间早的点，再画时间晚的点
-                if (minT <= maxT) {
-                    outX.push_back(minT); outY.push_back(minV);
-                    outX.push_back(maxT); outY.push_back(maxV);
-                } else {
-                    outX.push_back(maxT); outY.push_back(maxV);
-                    outX.push_back(minT); outY.push_back(minV);
-                }
-            }
+/**
+ * @brief 取通道的一条曲线，尚未创建时创建
+ *
+ * 电压曲线在上图，电流曲线在下图左轴，功率曲线在下图右轴；
+ * 新曲线按通道号取配色，绑定通道当前绘制的数据（displaySlot()）。
+ */
+ChannelPlottable *WaveformWidget::ensureCurve(int channelId, ViewportDownsampler::Column column)
+{
+    ChannelEntry *entry = channelEntry(channelId);
+    if (!entry) {
+        return nullptr;
+    }
+    ChannelPlottable *&curve = entry->curves[int(column)];
+    if (curve) {
+        return curve;
+    }
 
-            // 更新下一个像素桶的开始时间
-            tBinStart = tBinEnd;
-        }
+    // 每种曲线配一组不同颜色
+    static const QColor voltageColors[] = {
+        Qt::blue, Qt::darkBlue, Qt::red, Qt::darkRed, Qt::green,
+        Qt::darkGreen, Qt::magenta, Qt::darkMagenta, Qt::cyan, Qt::darkCyan
+    };
+    static const QColor currentColors[] = {
+        Qt::red, Qt::darkRed, Qt::green, Qt::darkGreen, Qt::blue,
+        Qt::darkBlue, Qt::magenta, Qt::darkMagenta, Qt::cyan, Qt::darkCyan
     };
+    static const QColor powerColors[] = {
+        Qt::darkYellow, QColor(160, 120, 0), QColor(200, 80, 0),
+        QColor(120, 80, 40), QColor(180, 160, 0),
+        QColor(100, 100, 0), QColor(160, 160, 40),
+        QColor(200, 200, 0), QColor(150, 120, 60),
+        QColor(190, 140, 40)
+    };
+    static const int kColorCount = 10;
+
+    switch (column) {
+    case ViewportDownsampler::Column::Voltage:
+        curve = new ChannelPlottable(ui->plotVoltage->xAxis, ui->plotVoltage->yAxis);
+        curve->setPen(QPen(voltageColors[channelId % kColorCount]));
+        curve->setName(QStringLiteral("Voltage%1 (V)").arg(channelId + 1));
+        break;
+    case ViewportDownsampler::Column::Current:
+        curve = new ChannelPlottable(ui->plotCurrent->xAxis, ui->plotCurrent->yAxis);
+        curve->setPen(QPen(currentColors[channelId % kColorCount]));
+        curve->setName(QStringLiteral("Current%1 (A)").arg(channelId + 1));
+        break;
+    case ViewportDownsampler::Column::Power:
+        curve = new ChannelPlottable(ui->plotCurrent->xAxis, ui->plotCurrent->yAxis2);
+        curve->setPen(QPen(powerColors[channelId % kColorCount]));
+        curve->setName(QStringLiteral("Power%1 (W)").arg(channelId + 1));
+        break;
+    }
+    curve->setSource(displaySlot(channelId), column);
+    curve->setVisible(curveShown(channelId, column));
+    curve->setStripMode(m_stripActive);
+    return curve;
+}
 
+bool WaveformWidget::curveShown(int channelId, ViewportDownsampler::Column column) const
+{
+    const ChannelVisibility vis = (channelId >= 0 && channelId < int(m_channels.size()))
+        ? m_channels[std::size_t(channelId)].visibility : ChannelVisibility();
+    switch (column) {
+    case ViewportDownsampler::Column::Voltage: return vis.voltageVisible && m_voltageVisible;
+    case ViewportDownsampler::Column::Current: return vis.currentVisible && m_currentVisible;
+    case ViewportDownsampler::Column::Power: return vis.powerVisible && m_powerVisible;
+    }
+    return false;
+}
 
-    if (plot == ui->plotVoltage) {
-        QVector<double> x, y;
-        downsampleSeries(m_voltage, x, y);
-        plot->graph(0)->setData(x, y, true);
-    } else {
-        QVector<double> xI, yI, xP, yP;
-        downsampleSeries(m_current, xI, yI);
-        downsampleSeries(m_power, xP, yP);
-        plot->graph(0)->setData(xI, yI, true);
-        plot->graph(1)->setData(xP, yP, true);
+void WaveformWidget::applyCurveVisibility(int channelId)
+{
+    if (channelId < 0 || channelId >= int(m_channels.size())) {
+        return;
+    }
+    ChannelPlottable *const *curves = m_channels[std::size_t(channelId)].curves;
+    for (int c = 0; c < 3; ++c) {
+        if (curves[c]) {
+            curves[c]->setVisible(curveShown(channelId, ViewportDownsampler::Column(c)));
+        }
     }
 }
 
@@ -1058,7 +1365,7 @@ void WaveformWidget::applyVisualDownsample(QCustomPlot *plot)
  * 功能：双击曲线时弹出颜色选择对话框，修改对应曲线的颜色
  * 
  * 处理流程：
- * 1. 类型转换：QCPAbstractPlottable -> QCPGraph
+ * 1. 读取曲线当前画笔
  * 2. 弹出颜色选择对话框
  * 3. 更新曲线颜色并刷新图表
  */
@@ -1068,18 +1375,14 @@ void WaveformWidget::onPlottableDoubleClicked(QCPAbstractPlottable *plottable, i
     Q_UNUSED(event);
     
     // ---------------------------------------------------------
-    // 第一步：类型转换
+    // 第一步：确认曲线有效（画笔和重绘接口都在 QCPAbstractPlottable 上）
     // ---------------------------------------------------------
-    // 尝试将其转换为 QCPGraph（波形图）
-    QCPGraph *graph = qobject_cast<QCPGraph*>(plottable);
-
-    // 如果转换失败（比如它是柱状图或其他类型），直接返回
-    if (!graph) return;
+    if (!plottable) return;
 
     // ---------------------------------------------------------
     // 第二步：颜色选择逻辑
     // ---------------------------------------------------------
-    QPen currentPen = graph->pen();
+    QPen currentPen = plottable->pen();
     QColor initialColor = currentPen.color();
 
     // 弹出颜色选择对话框
@@ -1089,14 +1392,14 @@ void WaveformWidget::onPlottableDoubleClicked(QCPAbstractPlottable *plottable, i
     if (newColor.isValid()) {
         QPen newPen = currentPen;
         newPen.setColor(newColor);
-        graph->setPen(newPen);
+        plottable->setPen(newPen);
 
         // ---------------------------------------------------------
         // 第三步：刷新图表
         // ---------------------------------------------------------
-        // 使用 graph->parentPlot() 获取 QCustomPlot 指针并重绘
-        if (graph->parentPlot()) {
-            graph->parentPlot()->replot();
+        // 使用 plottable->parentPlot() 获取 QCustomPlot 指针并重绘
+        if (plottable->parentPlot()) {
+            m_renderScheduler->markPlotDirty(plottable->parentPlot());
         }
     }
 }
@@ -1210,7 +1513,7 @@ bool WaveformWidget::eventFilter(QObject *watched, QEvent *event)
             }
             
             plot->xAxis->setRange(newLower, newUpper);
-            plot->replot(QCustomPlot::rpQueuedReplot);
+            m_renderScheduler->markPlotDirty(plot);
             
             // 拦截事件，因为我们已经手动处理了X和Y轴缩放
             return true;
@@ -1262,7 +1565,7 @@ bool WaveformWidget::eventFilter(QObject *watched, QEvent *event)
             }
 
             // 5. 刷新重绘
-            plot->replot(QCustomPlot::rpQueuedReplot);
+            m_renderScheduler->markPlotDirty(plot);
 
             // 6. 更新位置
             m_lastDragPos = mouseEvent->pos();
@@ -1340,7 +1643,7 @@ void WaveformWidget::handleYAxisZoom(QCustomPlot *plot, QWheelEvent *wheelEvent,
     targetAxis->setRange(newLower, newUpper);
     
     // 触发重绘
-    plot->replot(QCustomPlot::rpQueuedReplot);
+    m_renderScheduler->markPlotDirty(plot);
 }
 
 /**
@@ -1380,48 +1683,52 @@ void WaveformWidget::onSelectionRectAccepted(const QRect &rect, QMouseEvent *eve
                              .arg(tEnd, 0, 'f', 2)
                              .arg(duration, 0, 'f', 3);
 
-    // 4. 遍历该图表下所有"可见曲线"的统计（基于原始数据，而不是降采样后的绘制数据）
-    auto calcStats = [&](const QVector<double> &y, const QString &name) {
-        double minVal = 1e300;
-        double maxVal = -1e300;
-        long double sumVal = 0;
-        int count = 0;
-
-        // 二分定位到时间范围内
-        auto itBegin = std::lower_bound(m_time.begin(), m_time.end(), tStart);
-        auto itEnd = std::upper_bound(m_time.begin(), m_time.end(), tEnd);
-        // 迭代器相减转换为索引
-        int b = int(itBegin - m_time.begin());
-        int e = int(itEnd - m_time.begin());
-
-        // 在索引范围内找最大值和最小值
-        for (int i = b; i < e; ++i) {
-            const double v = y[i];
-            minVal = std::min(minVal, v);
-            maxVal = std::max(maxVal, v);
-            sumVal += v;
-            ++count;
+    // 4. 遍历该图表下所有"可见曲线"的统计（基于原始数据，由前缀和 + 金字塔汇总，代价与框选长度无关）
+    for (int i = 0; i < plot->plottableCount(); ++i) {
+        ChannelPlottable *curve = qobject_cast<ChannelPlottable*>(plot->plottable(i));
+        if (!curve || !curve->visible() || !curve->source()) {
+            continue;
+        }
+        resultInfo += QString("<hr><b>%1:</b><br>").arg(curve->name());
+
+        // 采集文件只有块内 Min/Max 摘要（没有前缀和），只统计最值
+        const ChannelSlotPtr &source = curve->source();
+        if (source->file) {
+            const CaptureFile &file = *source->file;
+            const int ch = source->fileChannel;
+            const CaptureFile::Summary sum = file.summarize(
+                ch, ViewportDownsampler::fileColumn(curve->column()),
+                file.lowerBound(ch, tStart), file.upperBound(ch, tEnd));
+            if (sum.count == 0) {
+                resultInfo += "No Data";
+                continue;
+            }
+            resultInfo += QString("Max: %1<br>Min: %2")
+                              .arg(sum.max, 0, 'f', 3)
+                              .arg(sum.min, 0, 'f', 3);
+            continue;
         }
 
-        resultInfo += QString("<hr><b>%1:</b><br>").arg(name);
-        if (count > 0) {
-            // 计算平均值
-            const double avgVal = double(sumVal / count);
-            resultInfo += QString("Avg: %1<br>Max: %2<br>Min: %3")
-                              .arg(avgVal, 0, 'f', 3)
-                              .arg(maxVal, 0, 'f', 3)
-                              .arg(minVal, 0, 'f', 3);
-        } else {
+        const RegionStats stats = source->data.regionStats(tStart, tEnd);
+        if (stats.count == 0) {
             resultInfo += "No Data";
+            continue;
         }
-    };
 
-    // 调用之前写的Lambda函数
-    if (plot == ui->plotVoltage) {
-        if (m_voltageVisible) calcStats(m_voltage, "Voltage (V)");
-    } else {
-        if (m_currentVisible) calcStats(m_current, "Current (A)");
-        if (m_powerVisible) calcStats(m_power, "Power (W)");
+        const ColumnStats *c = &stats.voltage;
+        if (curve->column() == ViewportDownsampler::Column::Current) {
+            c = &stats.current;
+        } else if (curve->column() == ViewportDownsampler::Column::Power) {
+            c = &stats.power;
+        }
+        resultInfo += QString("Mean: %1<br>RMS: %2<br>Max: %3<br>Min: %4")
+                          .arg(c->mean, 0, 'f', 3)
+                          .arg(c->rms, 0, 'f', 3)
+                          .arg(c->max, 0, 'f', 3)
+                          .arg(c->min, 0, 'f', 3);
+        if (curve->column() == ViewportDownsampler::Column::Power) {
+            resultInfo += QString("<br>Energy: %1 J").arg(stats.energy, 0, 'g', 6);
+        }
     }
 
     // 5. 临时的、浮动的文本提示窗口。
@@ -1437,28 +1744,26 @@ void WaveformWidget::onSelectionChanged()
     QCustomPlot *plot = qobject_cast<QCustomPlot*>(sender());
     if (!plot) return;
 
-    // 1. 先恢复上一次高亮的曲线线宽（避免遍历所有 graph）
-    for (QPointer<QCPGraph> &g : m_lastHighlightedGraphs) {
+    // 1. 先恢复上一次高亮的曲线线宽（避免遍历所有曲线）
+    for (QPointer<QCPAbstractPlottable> &g : m_lastHighlightedCurves) {
         if (!g) continue;
         QPen pen = g->pen();
         pen.setWidthF(1.0);          // 恢复为细线
         g->setPen(pen);
     }
-    m_lastHighlightedGraphs.clear();
+    m_lastHighlightedCurves.clear();
 
     // 2. 只处理当前选中的曲线
     const auto selected = plot->selectedPlottables();
     for (QCPAbstractPlottable *p : selected) {
-        if (auto *graph = qobject_cast<QCPGraph*>(p)) {
-            QPen pen = graph->pen();
-            pen.setWidthF(1.5);      // 轻微加粗，减小重绘成本
-            graph->setPen(pen);
-            m_lastHighlightedGraphs.push_back(graph);
-        }
+        QPen pen = p->pen();
+        pen.setWidthF(1.5);          // 轻微加粗，减小重绘成本
+        p->setPen(pen);
+        m_lastHighlightedCurves.push_back(p);
     }
 
     // 3. 刷新重绘
-    plot->replot(QCustomPlot::rpQueuedReplot);
+    m_renderScheduler->markPlotDirty(plot);
 }
 
 /**
@@ -1476,46 +1781,25 @@ void WaveformWidget::onPlottableClick(QCPAbstractPlottable *plottable, int dataI
 {
     Q_UNUSED(dataIndex);
 
-    // 1. 确认点到的是一条曲线（Graph）
-    QCPGraph *graph = qobject_cast<QCPGraph*>(plottable);
-    if (!graph) return;
+    // 1. 确认点到的是一条通道曲线
+    ChannelPlottable *curve = qobject_cast<ChannelPlottable*>(plottable);
+    if (!curve) return;
 
     // 2. 获取鼠标位置对应的 X 轴坐标（Time）
-    QCustomPlot *plot = graph->parentPlot();
+    QCustomPlot *plot = curve->parentPlot();
     double xCoord = plot->xAxis->pixelToCoord(event->pos().x());
 
     // 3. 基于"原始数据"做拾取，避免降采样后点不准
-    if (m_time.isEmpty()) return;
-    
-    // 使用二分查找定位最近的数据点
-    auto it = std::lower_bound(m_time.begin(), m_time.end(), xCoord);
-    //  获取查到的索引
-    int idx = int(it - m_time.begin());
-    //  检查是否越界
-    if (idx >= m_time.size()) idx = m_time.size() - 1;
-    
-    // 比较当前点和前一个点，选择距离更近的
-    if (idx > 0) {
-        const double d0 = qAbs(m_time[idx - 1] - xCoord);
-        const double d1 = qAbs(m_time[idx] - xCoord);
-        if (d0 < d1) idx = idx - 1;
-    }
-
+    //    曲线自身绑定了通道和列（电压/电流/功率），定位最近的数据点（均匀时基下为 O(1) 索引运算）
     // 4. 获取精确的时间和数值
-    const double time = m_time[idx];
+    double time = 0;
     double value = 0;
-    if (plot == ui->plotVoltage) {
-        value = m_voltage[idx];
-    } else {
-        // 通过 name 区分 Current/Power
-        const QString n = graph->name().toLower();
-        value = (n.contains("power")) ? m_power[idx] : m_current[idx];
-    }
+    if (!curve->sampleNear(xCoord, time, value)) return;
 
     // 5. 格式化显示的文本
     //    示例： "Time: 12.50 s\nVoltage: 5.12 V"
     QString tipText = QString("<b>%1</b><br>Time: %2 s<br>Value: %3")
-                          .arg(graph->name())
+                          .arg(curve->name())
                           .arg(time, 0, 'f', 4)  // 保留4位小数
                           .arg(value, 0, 'f', 4);
 
@@ -1525,147 +1809,310 @@ void WaveformWidget::onPlottableClick(QCPAbstractPlottable *plottable, int dataI
 }
 
 /**
- * @brief 更新所有通道的图表显示（内部辅助函数）
- * 根据m_channelDataMap中的数据更新各个graph
+ * @brief 通道的电压/电流/功率三条曲线改为绘制 slot 中的数据
  */
-void WaveformWidget::updateChannelGraphs()
+void WaveformWidget::bindChannelCurves(int channelId, const ChannelSlotPtr &slot)
 {
-    if (!ui->plotVoltage || !ui->plotCurrent) {
+    if (channelId < 0 || channelId >= int(m_channels.size())) {
         return;
     }
-    
-    // 遍历所有通道数据
-    for (auto it = m_channelDataMap.constBegin(); it != m_channelDataMap.constEnd(); ++it) {
-        int channelId = it.key();
-        if (channelId < 0 || channelId >= kChannelCount) {
-            continue;
-        }
-        
-        const ChannelData &channelData = it.value();
-        if (channelData.time.isEmpty()) {
-            continue;
-        }
-        
-        // 获取通道显示状态
-        ChannelVisibility vis = m_channelVisibility.value(channelId, ChannelVisibility());
-        bool showVoltage = vis.voltageVisible && m_voltageVisible;
-        bool showCurrent = vis.currentVisible && m_currentVisible;
-        bool showPower = vis.powerVisible && m_powerVisible;
-        
-        // 应用视觉降采样并更新电压graph
-        if (channelId < ui->plotVoltage->graphCount() && showVoltage) {
-            applyVisualDownsampleForChannel(ui->plotVoltage, channelId, channelData.time, channelData.voltage);
-        }
-        
-        // 更新电流graph
-        if (channelId < ui->plotCurrent->graphCount() && showCurrent) {
-            applyVisualDownsampleForChannel(ui->plotCurrent, channelId, channelData.time, channelData.current);
+    ChannelPlottable *const *curves = m_channels[std::size_t(channelId)].curves;
+    for (int c = 0; c < 3; ++c) {
+        if (curves[c]) {
+            curves[c]->setSource(slot, ViewportDownsampler::Column(c));
         }
-        
-        // 更新功率graph
-        int powerGraphIndex = kChannelCount + channelId;
-        if (powerGraphIndex < ui->plotCurrent->graphCount() && showPower) {
-            applyVisualDownsampleForChannel(ui->plotCurrent, powerGraphIndex, channelData.time, channelData.power);
+    }
+}
+
+ChannelSlotPtr WaveformWidget::displaySlot(int channelId) const
+{
+    if (m_captureFile) {
+        return (channelId >= 0 && channelId < int(m_channels.size()))
+            ? m_channels[std::size_t(channelId)].fileSlot : ChannelSlotPtr();
+    }
+    if (channelId == m_reviewChannel && m_reviewSlot) {
+        return m_reviewSlot;
+    }
+    return channelSlot(channelId);
+}
+
+void WaveformWidget::setTriggerSettings(const TriggerSettings &settings)
+{
+    m_trigger.setSettings(settings);
+}
+
+void WaveformWidget::armTrigger()
+{
+    m_trigger.arm();
+}
+
+void WaveformWidget::stopTrigger()
+{
+    m_trigger.stop();
+}
+
+int WaveformWidget::shownTriggerCapture() const
+{
+    for (int i = 0; m_reviewSequence != 0 && i < m_trigger.captureCount(); ++i) {
+        if (m_trigger.capture(i)->sequence == m_reviewSequence) {
+            return i;
         }
     }
+    return -1;
 }
 
 /**
- * @brief 为单个通道应用视觉降采样（内部辅助函数）
- * @param plot 图表对象
- * @param graphIndex graph索引
- * @param time 时间序列
- * @param values 数值序列
+ * @brief 查看采集段
+ *
+ * 采集段的数据拷贝到一个独立的通道数据槽中，触发通道的三条曲线改为从这里绘制
+ * （降采样同样按该槽计算）；实时数据继续写入原通道，不受影响。
  */
-void WaveformWidget::applyVisualDownsampleForChannel(QCustomPlot *plot, int graphIndex,
-                                                      const QVector<double> &time,
-                                                      const QVector<double> &values)
+void WaveformWidget::showTriggerCapture(int index)
 {
-    if (!plot || graphIndex < 0 || graphIndex >= plot->graphCount() || 
-        time.isEmpty() || values.isEmpty() || time.size() != values.size()) {
+    const TriggerCapturePtr capture = m_trigger.capture(index);
+    if (!capture || capture->data.isEmpty()) {
         return;
     }
-    
-    // 获取图表尺寸和X轴范围
-    const int w = plot->width();
-    const QCPRange xr = plot->xAxis->range();
-    const double bin = xr.size() / w;  // 每个像素对应的时间跨度
-    
-    if (bin <= 0 || w <= 0) {
+    closeCaptureFile();
+
+    // 切换到另一个通道的采集段时，先把之前查看的通道恢复为实时数据
+    if (m_reviewChannel >= 0 && m_reviewChannel != capture->channelId) {
+        bindChannelCurves(m_reviewChannel, channelSlot(m_reviewChannel));
+    }
+
+    auto slot = std::make_shared<ChannelSlot>();
+    slot->data = capture->data;
+    m_reviewSequence = capture->sequence;
+    m_reviewChannel = capture->channelId;
+    m_reviewSlot = slot;
+    bindChannelCurves(m_reviewChannel, slot);
+
+    // 视图定位到该段
+    m_autoFollow = false;
+    const TimeAxis &time = slot->data.time();
+    ui->plotVoltage->xAxis->setRange(time.first(), time.last());
+    setTriggerMarker(true, capture->triggerTime);
+
+    m_renderScheduler->markAllChannelsDirty();
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
+}
+
+void WaveformWidget::stepTriggerCapture(int delta)
+{
+    const int count = m_trigger.captureCount();
+    if (count == 0) {
         return;
     }
-    
-    // 找到可视范围内的数据索引
-    int i0 = 0;
-    for (int i = 0; i < time.size(); ++i) {
-        if (time[i] >= xr.lower) {
-            i0 = i;
-            break;
+    const int current = shownTriggerCapture();
+    const int index = (current < 0) ? count - 1 : qBound(0, current + delta, count - 1);
+    showTriggerCapture(index);
+}
+
+void WaveformWidget::showLive()
+{
+    if (m_reviewChannel < 0) {
+        return;
+    }
+    bindChannelCurves(m_reviewChannel, channelSlot(m_reviewChannel));
+    m_reviewSequence = 0;
+    m_reviewChannel = -1;
+    m_reviewSlot.reset();
+    setTriggerMarker(false);
+
+    m_autoFollow = true;
+    m_renderScheduler->markAllChannelsDirty();
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
+}
+
+/**
+ * @brief 打开采集文件查看
+ *
+ * 文件中每个通道对应一个以文件为后备存储的数据槽（ChannelSlot::file），三条曲线和降采样
+ * 都直接读取内存映射的文件，不拷贝样点；文件中没有的通道不显示。
+ */
+bool WaveformWidget::openCaptureFile(const QString &path, QString *errorString)
+{
+    auto file = std::make_shared<CaptureFile>();
+    if (!file->open(path)) {
+        if (errorString) {
+            *errorString = file->errorString();
         }
+        return false;
     }
-    
-    // 使用 upper_bound 确保包含等于 xr.upper 的边界点
-    auto itEnd = std::upper_bound(time.begin() + i0, time.end(), xr.upper);
-    int i1 = std::min(int(time.size()), int(itEnd - time.begin()));
-    
-    // 如果数据点很少，直接全量显示
-    if (i1 - i0 <= 2) {
-        plot->graph(graphIndex)->setData(time, values, true);
+
+    showLive();
+    m_downsampler->cancelAll();
+    for (ChannelEntry &entry : m_channels) {
+        entry.fileSlot.reset();
+    }
+    m_captureFile = file;
+
+    // 超出通道ID上限的通道不显示
+    double tFirst = std::numeric_limits<double>::infinity();
+    double tLast = -std::numeric_limits<double>::infinity();
+    for (int channelId : file->channelIds()) {
+        ChannelEntry *entry = channelEntry(channelId);
+        if (!entry || file->sampleCount(channelId) <= 0) {
+            continue;
+        }
+        auto slot = std::make_shared<ChannelSlot>();
+        slot->file = file;
+        slot->fileChannel = channelId;
+        entry->fileSlot = slot;
+        tFirst = std::min(tFirst, file->firstTime(channelId));
+        tLast = std::max(tLast, file->lastTime(channelId));
+    }
+    for (int channelId = 0; channelId < int(m_channels.size()); ++channelId) {
+        bindChannelCurves(channelId, m_channels[std::size_t(channelId)].fileSlot);
+    }
+
+    // 视图定位到文件的时间范围
+    m_autoFollow = false;
+    if (tFirst <= tLast) {
+        if (tFirst == tLast) {
+            tFirst -= 0.5;
+            tLast += 0.5;
+        }
+        ui->plotVoltage->xAxis->setRange(tFirst, tLast);
+    }
+
+    m_renderScheduler->markAllChannelsDirty();
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
+    return true;
+}
+
+void WaveformWidget::closeCaptureFile()
+{
+    if (!m_captureFile) {
         return;
     }
+    m_downsampler->cancelAll();
+    m_captureFile.reset();
+    for (int channelId = 0; channelId < int(m_channels.size()); ++channelId) {
+        m_channels[std::size_t(channelId)].fileSlot.reset();
+        bindChannelCurves(channelId, channelSlot(channelId));
+    }
+
+    m_autoFollow = true;
+    if (!m_displayPaused) {
+        followLatest(m_latestTime);
+    }
+    m_renderScheduler->markAllChannelsDirty();
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
+}
+
+void WaveformWidget::setTriggerMarker(bool visible, double time)
+{
+    auto place = [&](QCustomPlot *plot, QCPItemStraightLine *&line) {
+        if (!line) {
+            if (!visible) {
+                return;
+            }
+            line = new QCPItemStraightLine(plot);
+            line->setPen(QPen(QColor(255, 140, 0), 1, Qt::DashDotLine));
+            line->setSelectable(false);
+            line->point1->setType(QCPItemPosition::ptPlotCoords);
+            line->point2->setType(QCPItemPosition::ptPlotCoords);
+        }
+        line->point1->setCoords(time, 0);
+        line->point2->setCoords(time, 1);  // 垂直线：X相同，Y不同
+        line->setVisible(visible);
+    };
+    place(ui->plotVoltage, m_triggerMarkerV);
+    place(ui->plotCurrent, m_triggerMarkerI);
+}
+
+/**
+ * @brief 更新通道的图表显示（由渲染调度器每帧最多调用一次）
+ * @param all 是否更新所有通道
+ * @param channelIds all 为 false 时需要更新的通道
+ *
+ * 为每个可见通道向降采样线程池提交请求；GUI 线程不做降采样计算，
+ * 结果就绪后在 onDownsampleReady() 中交给各条曲线。
+ */
+void WaveformWidget::updateChannelGraphs(bool all, const QVector<int> &channelIds)
+{
+    if (!ui->plotVoltage || !ui->plotCurrent) {
+        return;
+    }
+    POWERDAQ_TRACE_SCOPE("updateChannelGraphs");
+    updateStripChart();
+
+    // 视口变化时作废进行中的旧任务
+    const QCPRange viewport = ui->plotVoltage->xAxis->range();
+    m_downsampler->setViewport(TimeRange(viewport.lower, viewport.upper));
+    // 按绘图区宽度分列，与 ChannelPlottable 绘制时的像素列一致
+    const int widthV = ui->plotVoltage->axisRect()->width();
+    const int widthI = ui->plotCurrent->axisRect()->width();
     
-    // Min-Max 降采样算法
-    QVector<double> outX, outY;
-    outX.reserve(w * 2);
-    outY.reserve(w * 2);
-    
-    double tBinStart = xr.lower;
-    int idx = i0;
-    
-    // 注意：即使 idx >= i1，也要处理完所有像素列，确保边界数据不丢失
-    for (int px = 0; px < w; ++px) {
-        const double tBinEnd = (px == w - 1) ? xr.upper : (tBinStart + bin);
-        
-        bool has = false;
-        double minV = 0, maxV = 0;
-        double minT = 0, maxT = 0;
-        
-        // 注意：最后一列使用 <= 包含边界点，其他列使用 < 避免重复
-        bool isLastBin = (px == w - 1);
-        while (idx < i1) {
-            const double t = time[idx];
-            // 对于最后一列，包含等于边界的点；对于其他列，不包含右边界（避免重复）
-            if (isLastBin ? (t > tBinEnd) : (t >= tBinEnd)) {
-                break;
+    // 遍历需要更新的通道：有数据且至少一条曲线需要显示的通道才提交请求（隐藏的通道不创建曲线、不降采样）
+    auto update = [&](int channelId) {
+        const ChannelSlotPtr slot = displaySlot(channelId);
+        if (!slot || slot->isEmpty()) {
+            return;
+        }
+
+        QVector<ViewportDownsampler::Target> targets;
+        ViewportDownsampler::Target t;
+        const ViewportDownsampler::Column columns[] = {
+            ViewportDownsampler::Column::Voltage,
+            ViewportDownsampler::Column::Current,
+            ViewportDownsampler::Column::Power
+        };
+        for (ViewportDownsampler::Column column : columns) {
+            if (!curveShown(channelId, column) || !ensureCurve(channelId, column)) {
+                continue;
             }
-            
-            const double v = values[idx];
-            
-            if (!has) {
-                has = true;
-                minV = maxV = v;
-                minT = maxT = t;
-            } else {
-                if (v < minV) { minV = v; minT = t; }
-                if (v > maxV) { maxV = v; maxT = t; }
+            if (m_stripActive) {
+                continue;   // 条带图在重绘时同步绘制新列，不需要整个视口的降采样
             }
-            ++idx;
+            t.column = column;
+            t.width = (column == ViewportDownsampler::Column::Voltage) ? widthV : widthI;
+            targets.push_back(t);
         }
-        
-        if (has) {
-            if (minT <= maxT) {
-                outX.push_back(minT); outY.push_back(minV);
-                outX.push_back(maxT); outY.push_back(maxV);
-            } else {
-                outX.push_back(maxT); outY.push_back(maxV);
-                outX.push_back(minT); outY.push_back(minV);
+        if (!targets.isEmpty()) {
+            m_downsampler->request(channelId, slot, targets);
+        }
+    };
+
+    if (all) {
+        for (int channelId = 0; channelId < int(m_channels.size()); ++channelId) {
+            update(channelId);
+        }
+    } else {
+        for (int channelId : channelIds) {
+            if (channelId >= 0 && channelId < int(m_channels.size())) {
+                update(channelId);
             }
         }
-        
-        tBinStart = tBinEnd;
     }
-    
-    // 更新graph数据
-    plot->graph(graphIndex)->setData(outX, outY, true);
+    if (m_stripActive) {
+        m_renderScheduler->markPlotDirty(ui->plotVoltage);
+        m_renderScheduler->markPlotDirty(ui->plotCurrent);
+    }
 }
 
+/**
+ * @brief 降采样结果就绪（槽函数，GUI 线程）
+ * 只把 Min-Max 列的共享指针交给各条曲线（无拷贝、不重建数据容器），重绘由渲染调度器在下一帧合并执行。
+ */
+void WaveformWidget::onDownsampleReady()
+{
+    m_downsampler->takeResults(m_downsampleResults);
+    if (m_downsampleResults.empty()) {
+        return;
+    }
+    POWERDAQ_TRACE_SCOPE("applyDownsample");
+    for (const ViewportDownsampler::Result &r : m_downsampleResults) {
+        if (ChannelPlottable *curve = curveFor(r.channelId, r.column)) {
+            curve->setColumns(r.columns);
+        }
+    }
+    m_downsampleResults.clear();
+    m_renderScheduler->markPlotDirty(ui->plotVoltage);
+    m_renderScheduler->markPlotDirty(ui->plotCurrent);
+}
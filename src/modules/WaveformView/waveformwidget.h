@@ -8,11 +8,22 @@
 #include <QVector>
 #include <QMap>
 #include <QPointer>
+#include <vector>
+#include "sampleblock.h"
+#include "channelstore.h"
+#include "viewportdownsampler.h"
+#include "renderscheduler.h"
+#include "channelplottable.h"
+#include "triggerengine.h"
+#include "perfhud.h"
+#include "stripchart.h"
 
 namespace Ui {
 class WaveformWidget;
 }
 
+class SampleQueue;
+
 /**
  * @brief 波形显示核心类
  * 继承自 QWidget，封装了 QCustomPlot 用于双图表（电压/电流）同步展示。
@@ -25,8 +36,8 @@ public:
     explicit WaveformWidget(QWidget *parent = nullptr);
     ~WaveformWidget() override;
 
-    // 测试：虚拟通道数量（每个通道包含 V/I/P 三条曲线）
-    static constexpr int kChannelCount = 20;
+    // 通道ID上限的默认值（每个通道包含 V/I/P 三条曲线，只为需要显示的通道创建）
+    static constexpr int kDefaultMaxChannels = ChannelStore::kDefaultMaxChannels;
 
     // --- 数据结构定义 ---
     /**
@@ -44,21 +55,97 @@ public:
      */
     struct MultiChannelData {
         QMap<int, ChannelDataPoint> channelData;  // channelId -> 数据点
-        // channelId 范围：0 到 kChannelCount-1
+        // channelId 范围：0 到 maxChannels()-1
     };
 
     // --- 数据操作接口 ---
     /**
      * @brief 添加单个数据点（单通道，通道0）- 保留用于向后兼容
+     *
+     * 等同于向通道0写入一个样点，与其他通道共用同一份数据。
      */
     void addData(double time, double voltage, double current, double power);
     
     /**
-     * @brief 添加多通道数据（线程安全，支持从工作线程调用）
+     * @brief 添加多通道数据（只能在 GUI 线程调用）
      * @param data 多通道数据包
+     *
+     * 会驱动触发引擎、渲染调度器和 X 轴跟随；其他线程请通过 sampleQueue() 投递数据块，
+     * 或经排队信号槽转到 GUI 线程。
      */
     void addChannelData(const MultiChannelData &data);
     
+    /**
+     * @brief 批量添加单通道的一段连续数据（块接口，GUI 线程调用）
+     *
+     * 每列数据以一次整段拷贝写入数据池，适合 4k~64k 样点的硬件数据块。
+     * @param channelId 通道ID（0 到 maxChannels()-1）
+     * @param time 逐点时间戳（秒），长度为 count
+     * @param voltage 电压数组（V）
+     * @param current 电流数组（A）
+     * @param power 功率数组（W），可为 nullptr（自动按 voltage * current 计算）
+     * @param count 样点数
+     */
+    void addChannelBlock(int channelId, const double *time, const double *voltage,
+                         const double *current, const double *power, int count);
+
+    /**
+     * @brief 批量添加单通道的一段均匀采样数据（t0 + k*dt）
+     * @param t0 第一个样点的时间（秒）
+     * @param dt 采样周期（秒，必须 > 0）
+     */
+    void addChannelBlock(int channelId, double t0, double dt, const double *voltage,
+                         const double *current, const double *power, int count);
+
+    /**
+     * @brief 批量添加一个采样块（字段含义见 SampleBlock）
+     */
+    void addChannelBlock(const SampleBlock &block);
+
+    /**
+     * @brief 采集数据入口队列（无锁，供采集线程直接投递 SampleBlock）
+     *
+     * 采集线程调用 sampleQueue()->push(...) 投递数据块；控件在每个显示帧
+     * 统一取出当帧到达的全部数据块，写入数据池后只做一次降采样和重绘。
+     */
+    SampleQueue *sampleQueue() const { return m_sampleQueue; }
+
+    /**
+     * @brief 暂停 / 恢复显示刷新
+     *
+     * 暂停期间仍每帧取出队列中的数据写入数据池（触发检测、累计照常进行），
+     * 只是不再跟随和重绘新数据；恢复时一次性刷新到最新位置。
+     */
+    void setDisplayPaused(bool paused);
+    bool isDisplayPaused() const { return m_displayPaused; }
+
+    /**
+     * @brief 立即取完队列中剩余的全部数据块（采集停止后调用，不等下一帧）
+     */
+    void flushSampleQueue();
+
+    /**
+     * @brief 设置原始数据保留策略（所有通道，含之后新建的通道）
+     *
+     * 每个通道的数据保存在环形缓冲中，超出保留量后覆盖最旧的样点，
+     * 长时间采集时内存占用保持恒定。默认每通道约 128 MiB。
+     * 示例：setRetention(RetentionPolicy::seconds(600)) 保留最近 10 分钟。
+     */
+    void setRetention(const RetentionPolicy &policy);
+    RetentionPolicy retention() const { return m_store.retention(); }
+
+    /**
+     * @brief 设置冷数据策略（所有通道，含之后新建的通道）
+     *
+     * 超出保留量的样点压缩后移入冷数据而不是直接丢弃，缩小视图时仍可看到更早的波形，
+     * 框选统计也包含这部分数据。默认无损压缩（带噪声数据约 2.5 倍），每通道约 64 MiB；
+     * 已知 ADC 分辨率时改用量化压缩（约 17~30 倍）。
+     * 示例：setColdStorage(ColdStoragePolicy::quantized(RetentionPolicy::seconds(3600), 1e-4, 1e-6, 0.0))
+     * 按 ADC 分辨率量化，保留最近 1 小时。
+     */
+    void setColdStorage(const ColdStoragePolicy &policy);
+    ColdStoragePolicy coldStorage() const { return m_store.coldStorage(); }
+
     /**
      * @brief 清空所有通道的数据
      */
@@ -66,10 +153,25 @@ public:
     
     /**
      * @brief 清空指定通道的数据
-     * @param channelId 通道ID（0 到 kChannelCount-1）
+     * @param channelId 通道ID（0 到 maxChannels()-1）
      */
     void clearChannel(int channelId);
 
+    /**
+     * @brief 设置通道ID上限（默认 kDefaultMaxChannels）
+     *
+     * 通道表按实际写入或设置过的最大ID增长，曲线在通道第一次需要显示时创建，
+     * 内存和每帧的降采样、重绘只与有数据且可见的通道数有关。缩小上限时丢弃超出的通道。
+     */
+    void setMaxChannels(int count);
+    int maxChannels() const { return m_store.maxChannels(); }
+
+    /**
+     * @brief 指定通道的电荷量 / 能量累计（写入时流式积分，隐藏或超出保留量后仍然累计）
+     * @return 通道尚无数据时返回 nullptr
+     */
+    const ChannelIntegrator *channelIntegrator(int channelId) const;
+
     // --- 图层控制（控制曲线 Show/Hide） ---
     /**
      * @brief 设置所有通道的电压/电流/功率显示状态（全局控制）
@@ -80,7 +182,7 @@ public:
     
     /**
      * @brief 设置指定通道的显示状态
-     * @param channelId 通道ID（0 到 kChannelCount-1）
+     * @param channelId 通道ID（0 到 maxChannels()-1）
      * @param voltageVisible 电压曲线是否显示
      * @param currentVisible 电流曲线是否显示
      * @param powerVisible 功率曲线是否显示
@@ -88,6 +190,67 @@ public:
     void setChannelVisible(int channelId, bool voltageVisible, 
                            bool currentVisible, bool powerVisible);
 
+    // --- 触发 ---
+    /**
+     * @brief 设置触发条件（在数据写入路径上检测，对之后写入的数据生效）
+     */
+    void setTriggerSettings(const TriggerSettings &settings);
+    const TriggerSettings &triggerSettings() const { return m_trigger.settings(); }
+    void armTrigger();
+    void stopTrigger();
+    bool isTriggerArmed() const { return m_trigger.isArmed(); }
+
+    /**
+     * @brief 已完成的采集段（0 为最旧，超出 maxCaptures 后最旧的段被丢弃）
+     */
+    int triggerCaptureCount() const { return m_trigger.captureCount(); }
+    TriggerCapturePtr triggerCapture(int index) const { return m_trigger.capture(index); }
+
+    /**
+     * @brief 查看第 index 个采集段：触发通道的曲线改为绘制该段数据，
+     * 视图定位到该段并标出触发时刻，同时关闭自动跟随
+     */
+    void showTriggerCapture(int index);
+    void stepTriggerCapture(int delta);     // 相对当前查看的段前后翻页（实时视图时从最新一段开始）
+    void showLive();                        // 退出查看，恢复实时数据和自动跟随
+    int shownTriggerCapture() const;        // 当前查看的段序号，实时视图时为 -1
+
+    // --- 采集文件 ---
+    /**
+     * @brief 打开采集文件（.pdaq）查看：文件中的通道（0 到 maxChannels()-1）改为从内存映射的文件绘制，
+     * 视图定位到文件的时间范围并关闭自动跟随；实时数据照常写入数据池，只是不显示
+     * @param errorString 打开失败时的原因（可为 nullptr）
+     * @return 文件无法打开或格式不符时返回 false，原显示不变
+     */
+    bool openCaptureFile(const QString &path, QString *errorString = nullptr);
+    void closeCaptureFile();                // 关闭文件，恢复实时数据和自动跟随
+    CaptureFilePtr captureFile() const { return m_captureFile; }
+
+    // --- 渲染帧率 ---
+    /**
+     * @brief 设置目标显示帧率（每帧最多一次降采样和一次重绘，过载时自动降帧）
+     */
+    void setTargetFps(int fps) { m_renderScheduler->setTargetFps(fps); }
+    int targetFps() const { return m_renderScheduler->targetFps(); }
+
+    /**
+     * @brief 显示 / 隐藏性能统计浮层（帧率、重绘耗时、绘制点数、写入速率、队列、丢块、内存）
+     *
+     * 统计开销很小，可在正式运行中随时打开；隐藏时不采样。
+     */
+    void setPerfHudVisible(bool visible);
+    bool isPerfHudVisible() const;
+
+    /**
+     * @brief 条带图模式（默认开启）：实时自动跟随时曲线保存在离屏图像中，
+     * 每帧只平移图像并绘制新到达的像素列，重绘开销与新数据量成正比而不是与视口大小成正比
+     *
+     * 自动跟随时视口右边界对齐到像素网格；缩放、拖拽、暂停、查看采集段或采集文件时
+     * 自动回到按视口异步降采样的整体绘制。
+     */
+    void setStripChartEnabled(bool enabled);
+    bool isStripChartEnabled() const { return m_stripChartEnabled; }
+
     // --- 视图跟随控制 ---
     void setAutoFollow(bool enable) { m_autoFollow = enable; }
     bool autoFollow() const { return m_autoFollow; }
@@ -103,21 +266,41 @@ public:
     MeasureToolMode measureToolMode() const { return m_measureMode; }
     void cycleMeasureToolMode(); // 在 Off -> Crosshair -> Calipers 之间轮转
 
+signals:
+    void triggerCaptured(int index);        // 新的采集段完成（index 为其在 triggerCapture() 中的序号）
+
 private slots:
     // --- QCustomPlot 波形控件相关的信号关联槽 ---
     void onPlottableDoubleClicked(QCPAbstractPlottable *plottable, int dataIndex, QMouseEvent *event); // 双击曲线改颜色
     void onSelectionRectAccepted(const QRect &rect, QMouseEvent *event);           // 框选放大
     void onSelectionChanged();                                                     // 选中曲线高亮
     void onPlottableClick(QCPAbstractPlottable *plottable, int dataIndex, QMouseEvent *event);
+    void onFrameTick(); // 显示帧开始：取出队列中已到达的数据块写入数据池
+    void onDownsampleReady(); // 降采样结果就绪：把 Min-Max 列交给各曲线并重绘
 
 private:
     // --- 内部初始化与辅助 ---
     void setupCharts();
-    void applyVisualDownsample(QCustomPlot *plot); // 高性能渲染：大数据量时只抽取可见点绘制
-    void updateChannelGraphs(); // 更新所有通道的图表显示
-    void applyVisualDownsampleForChannel(QCustomPlot *plot, int graphIndex, 
-                                         const QVector<double> &time, 
-                                         const QVector<double> &values); // 为单个通道应用降采样
+    struct ChannelEntry;
+    ChannelEntry *channelEntry(int channelId);          // 通道表中的一项（按需扩展通道表，ID 超出上限时为 nullptr）
+    ChannelPlottable *curveFor(int channelId, ViewportDownsampler::Column column) const; // 尚未创建时为 nullptr
+    ChannelPlottable *ensureCurve(int channelId, ViewportDownsampler::Column column);  // 第一次需要显示时创建曲线
+    bool curveShown(int channelId, ViewportDownsampler::Column column) const; // 通道设置与全局设置都为显示
+    void applyCurveVisibility(int channelId);           // 按显示状态更新通道已有曲线的可见性
+    void bindChannelCurves(int channelId, const ChannelSlotPtr &slot); // 通道的三条曲线改为绘制 slot 的数据
+    ChannelSlotPtr channelSlot(int channelId) const; // 通道的实时数据（尚无数据时为空）
+    ChannelSlotPtr displaySlot(int channelId) const; // 曲线当前绘制的数据（查看采集段时为该段）
+    void setTriggerMarker(bool visible, double time = 0.0); // 查看采集段时标出触发时刻
+    void updateChannelGraphs(bool all, const QVector<int> &channelIds); // 更新通道的图表显示（提交异步降采样请求）
+    bool ingestBlock(const SampleBlock &block, double &maxTime); // 写入单个数据块（不刷新）
+    bool appendSamples(int channelId, const double *time, double t0, double dt,
+                       const double *voltage, const double *current,
+                       const double *power, int count, double &maxTime); // 块写入核心（按列整段拷贝）
+    void refreshAfterIngest(double maxTime); // 写入后：自动跟随 + 降采样 + 重绘
+    void updatePerfHud(); // 采样各项性能计数器并刷新浮层
+    void followLatest(double maxTime); // 自动跟随：将 X 轴右对齐到最新时间
+    void updateStripChart(); // 按当前状态启用 / 停用条带图（只在实时自动跟随时启用）
+    void invalidateStripChart(); // 数据被清空或替换：条带图下一帧整体重绘
 
     // --- 测量工具核心私有方法 ---
     void ensureMeasureItems(); // 延迟加载：第一次开启工具时创建所有线条和文本对象
@@ -143,33 +326,56 @@ private:
     bool m_autoFollow = true;       // 是否自动跟随最新数据（缩放/拖拽后置 false）
     bool m_isAutoFollowing = false; // 标记当前是否正在执行自动跟随操作（防止误关闭）
 
+    // --- 采集数据管线 ---
+    SampleQueue *m_sampleQueue = nullptr;          // 采集线程 -> GUI 的无锁队列
+    RenderScheduler *m_renderScheduler = nullptr;  // 渲染调度器（显示帧、脏标记、自适应帧率）
+    std::vector<SampleBlock> m_drainBuffer;        // 每帧取块的复用缓冲（避免反复分配）
+    bool m_displayPaused = false;                  // 暂停显示：照常写入数据池，不跟随、不重绘新数据
+    double m_latestTime = 0.0;                     // 已写入数据的最新时间（恢复显示时跟随到这里）
+    quint64 m_ingestedSamples = 0;                 // 累计写入的样点数（性能统计）
+    PerfHud *m_perfHud = nullptr;                  // 性能统计浮层（第一次显示时创建）
+    bool m_stripChartEnabled = true;               // 允许条带图模式
+    bool m_stripActive = false;                    // 条带图当前是否生效
+    StripChart *m_stripV = nullptr;                // 电压图的条带图层（由 QCustomPlot 负责释放）
+    StripChart *m_stripI = nullptr;                // 电流图的条带图层
+
     // --- 核心原始数据池 ---
-    // 单通道数据（向后兼容，用于通道0）
-    QVector<double> m_time;         // 时间轴数据 (X轴)
-    QVector<double> m_voltage;      // 电压数据 (Y轴1)
-    QVector<double> m_current;      // 电流数据 (Y轴2)
-    QVector<double> m_power;        // 功率数据 (派生计算值)
-    
-    // 多通道数据存储（每个通道独立存储）
-    struct ChannelData {
-        QVector<double> time;
-        QVector<double> voltage;
-        QVector<double> current;
-        QVector<double> power;
-    };
-    QMap<int, ChannelData> m_channelDataMap;  // channelId -> 通道数据
+    // 每个通道：TimeAxis（均匀采样时不逐点存储）+ 电压/电流/功率环形缓冲（powerdaq_core）
+    ChannelStore m_store;
 
-    bool m_voltageVisible = true;
-    bool m_currentVisible = true;
-    bool m_powerVisible = true;
-    
-    // 每个通道的显示状态（通道ID -> 显示状态）
+    // 每个通道的显示状态
     struct ChannelVisibility {
         bool voltageVisible = true;
         bool currentVisible = true;
         bool powerVisible = true;
     };
-    QMap<int, ChannelVisibility> m_channelVisibility;  // channelId -> 显示状态
+
+    // 通道表的一项：显示状态和三条曲线（曲线由 QCustomPlot 负责释放；实时数据在 m_store 中）
+    struct ChannelEntry {
+        ChannelSlotPtr fileSlot;            // 查看采集文件时以文件为后备存储的数据槽
+        ChannelVisibility visibility;
+        ChannelPlottable *curves[3] = {nullptr, nullptr, nullptr};  // 电压 / 电流 / 功率（按 Column 下标）
+    };
+    std::vector<ChannelEntry> m_channels;   // 通道表（下标 = 通道ID，按需增长）
+
+    // --- 触发 ---
+    TriggerEngine m_trigger;                // 触发检测与采集段
+    std::int64_t m_reviewSequence = 0;      // 正在查看的采集段序号（TriggerCapture::sequence，0 = 实时视图）
+    int m_reviewChannel = -1;               // 正在查看的采集段所属通道
+    ChannelSlotPtr m_reviewSlot;            // 正在查看的采集段数据（曲线从这里绘制）
+    QCPItemStraightLine *m_triggerMarkerV = nullptr; // 触发时刻标记（电压图）
+    QCPItemStraightLine *m_triggerMarkerI = nullptr; // 触发时刻标记（电流图）
+
+    // --- 采集文件 ---
+    CaptureFilePtr m_captureFile;               // 正在查看的采集文件（为空时显示实时数据）
+
+    // --- 异步降采样 ---
+    ViewportDownsampler *m_downsampler = nullptr;                     // 降采样线程池
+    std::vector<ViewportDownsampler::Result> m_downsampleResults;     // 交换结果的复用缓冲
+
+    bool m_voltageVisible = true;
+    bool m_currentVisible = true;
+    bool m_powerVisible = true;
 
     bool m_syncingRange = false;    // 状态锁：防止双轴联动死循环（A改B, B又触发A）
 
@@ -213,7 +419,7 @@ private:
     QCPItemText *m_caliperText_I = nullptr;    // 在电流图显示 ΔT 和 ΔI
 
     // 4. 记录上一次被高亮的曲线，用于只调整选中曲线的线宽
-    QVector<QPointer<QCPGraph>> m_lastHighlightedGraphs;
+    QVector<QPointer<QCPAbstractPlottable>> m_lastHighlightedCurves;
 
 protected:
     /**